@@ -6,8 +6,18 @@
  
 int search(int arr[], int n, int x)
 {
-    int i;
-    for (i = 0; i < n; i++)
+    int i = 0;
+    // Compare 8 elements per step without a branch on each
+    // one, compilers turn the inner loop into vector compares.
+    // Only the block holding a match is scanned one by one.
+    for (; i + 8 <= n; i += 8) {
+        int found = 0;
+        for (int j = 0; j < 8; j++)
+            found |= (arr[i + j] == x);
+        if (found)
+            break;
+    }
+    for (; i < n; i++)
         if (arr[i] == x)
             return i;
     return -1;
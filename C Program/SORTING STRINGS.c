@@ -13,9 +13,9 @@ for(i=0;i<n;i++)
 printf("\n enter the names");
 scanf("%s",&name[i]);
 }
-for(i=0;i<=n;i++)
+for(i=0;i<n;i++)
 {
-for(j=i+1;j<=n;j++)
+for(j=i+1;j<n;j++)
 {
 if(strcmp(name[i],name[j])>0)
 {
@@ -26,7 +26,7 @@ strcpy(name[j],temp);
 }
 }
 printf("\n\t the string in alphabetical order");
-for(i=0;i<=n;i++)
+for(i=0;i<n;i++)
 {
 printf("\n\t%s",name[i]);
 printf("\n");
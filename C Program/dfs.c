@@ -1,46 +1,99 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-struct node {
-  int vertex;
-  struct node* next;
-};
-
-struct node* createNode(int v);
-
 struct Graph {
   int numVertices;
   int* visited;
 
-  // We need int** to store a two dimensional array.
-  // Similary, we need struct node** to store an array of Linked lists
-  struct node** adjLists;
+  // Edges are collected in two flat arrays by addEdge and turned into a
+  // compressed sparse row adjacency once, before the first traversal:
+  // the neighbours of v are targets[offsets[v]] ... targets[offsets[v + 1] - 1]
+  int numEdges;
+  int edgeCapacity;
+  int* edgeFrom;
+  int* edgeTo;
+  int* offsets;
+  int* targets;
 };
 
+// Count the degrees, prefix sum them into offsets and fill the targets.
+// Edges are placed newest first, the order the old per vertex linked lists had.
+void buildAdjacency(struct Graph* graph) {
+  if (graph->targets != NULL) {
+    return;
+  }
+  int v;
+  int i;
+  graph->offsets = calloc(graph->numVertices + 1, sizeof(int));
+  for (i = 0; i < graph->numEdges; i++) {
+    graph->offsets[graph->edgeFrom[i] + 1]++;
+  }
+  for (v = 0; v < graph->numVertices; v++) {
+    graph->offsets[v + 1] += graph->offsets[v];
+  }
+
+  int* next = malloc((graph->numVertices + 1) * sizeof(int));
+  for (v = 0; v <= graph->numVertices; v++) {
+    next[v] = graph->offsets[v];
+  }
+  graph->targets = malloc((graph->numEdges + 1) * sizeof(int));
+  for (i = graph->numEdges - 1; i >= 0; i--) {
+    graph->targets[next[graph->edgeFrom[i]]++] = graph->edgeTo[i];
+  }
+  free(next);
+}
+
 // DFS algo
 void DFS(struct Graph* graph, int vertex) {
-  struct node* adjList = graph->adjLists[vertex];
-  struct node* temp = adjList;
+  buildAdjacency(graph);
 
   graph->visited[vertex] = 1;
   printf("Visited %d \n", vertex);
 
-  while (temp != NULL) {
-    int connectedVertex = temp->vertex;
+  int i;
+  for (i = graph->offsets[vertex]; i < graph->offsets[vertex + 1]; i++) {
+    int connectedVertex = graph->targets[i];
 
     if (graph->visited[connectedVertex] == 0) {
       DFS(graph, connectedVertex);
     }
-    temp = temp->next;
   }
 }
 
-// Create a node
-struct node* createNode(int v) {
-  struct node* newNode = malloc(sizeof(struct node));
-  newNode->vertex = v;
-  newNode->next = NULL;
-  return newNode;
+// BFS algo: visits the vertices level by level. distance[v] is the number of
+// edges on a shortest path from startVertex (-1 if v is unreachable) and
+// parent[v] the vertex before v on that path. Uses a queue instead of the
+// call stack, so it also works on graphs too deep for the recursive DFS.
+void BFS(struct Graph* graph, int startVertex, int* distance, int* parent) {
+  buildAdjacency(graph);
+
+  int v;
+  for (v = 0; v < graph->numVertices; v++) {
+    distance[v] = -1;
+    parent[v] = -1;
+  }
+
+  int* queue = malloc(graph->numVertices * sizeof(int));
+  int head = 0;
+  int tail = 0;
+  distance[startVertex] = 0;
+  parent[startVertex] = startVertex;
+  queue[tail++] = startVertex;
+
+  while (head < tail) {
+    int vertex = queue[head++];
+    int i;
+    for (i = graph->offsets[vertex]; i < graph->offsets[vertex + 1]; i++) {
+      int connectedVertex = graph->targets[i];
+
+      if (distance[connectedVertex] == -1) {
+        distance[connectedVertex] = distance[vertex] + 1;
+        parent[connectedVertex] = vertex;
+        queue[tail++] = connectedVertex;
+      }
+    }
+  }
+  free(queue);
 }
 
 // Create graph
@@ -48,45 +101,67 @@ struct Graph* createGraph(int vertices) {
   struct Graph* graph = malloc(sizeof(struct Graph));
   graph->numVertices = vertices;
 
-  graph->adjLists = malloc(vertices * sizeof(struct node*));
+  graph->visited = calloc(vertices, sizeof(int));
 
-  graph->visited = malloc(vertices * sizeof(int));
+  graph->numEdges = 0;
+  graph->edgeCapacity = 16;
+  graph->edgeFrom = malloc(graph->edgeCapacity * sizeof(int));
+  graph->edgeTo = malloc(graph->edgeCapacity * sizeof(int));
+  graph->offsets = NULL;
+  graph->targets = NULL;
+  return graph;
+}
 
-  int i;
-  for (i = 0; i < vertices; i++) {
-    graph->adjLists[i] = NULL;
-    graph->visited[i] = 0;
+void appendEdge(struct Graph* graph, int from, int to) {
+  if (graph->numEdges == graph->edgeCapacity) {
+    graph->edgeCapacity *= 2;
+    graph->edgeFrom = realloc(graph->edgeFrom, graph->edgeCapacity * sizeof(int));
+    graph->edgeTo = realloc(graph->edgeTo, graph->edgeCapacity * sizeof(int));
   }
-  return graph;
+  graph->edgeFrom[graph->numEdges] = from;
+  graph->edgeTo[graph->numEdges] = to;
+  graph->numEdges++;
+
+  // The adjacency is rebuilt on the next traversal
+  free(graph->offsets);
+  free(graph->targets);
+  graph->offsets = NULL;
+  graph->targets = NULL;
 }
 
 // Add edge
 void addEdge(struct Graph* graph, int src, int dest) {
   // Add edge from src to dest
-  struct node* newNode = createNode(dest);
-  newNode->next = graph->adjLists[src];
-  graph->adjLists[src] = newNode;
+  appendEdge(graph, src, dest);
 
   // Add edge from dest to src
-  newNode = createNode(src);
-  newNode->next = graph->adjLists[dest];
-  graph->adjLists[dest] = newNode;
+  appendEdge(graph, dest, src);
 }
 
 // Print the graph
 void printGraph(struct Graph* graph) {
+  buildAdjacency(graph);
+
   int v;
   for (v = 0; v < graph->numVertices; v++) {
-    struct node* temp = graph->adjLists[v];
     printf("\n Adjacency list of vertex %d\n ", v);
-    while (temp) {
-      printf("%d -> ", temp->vertex);
-      temp = temp->next;
+    int i;
+    for (i = graph->offsets[v]; i < graph->offsets[v + 1]; i++) {
+      printf("%d -> ", graph->targets[i]);
     }
     printf("\n");
   }
 }
 
+void freeGraph(struct Graph* graph) {
+  free(graph->visited);
+  free(graph->edgeFrom);
+  free(graph->edgeTo);
+  free(graph->offsets);
+  free(graph->targets);
+  free(graph);
+}
+
 int main() {
   struct Graph* graph = createGraph(4);
   addEdge(graph, 0, 1);
@@ -98,5 +173,16 @@ int main() {
 
   DFS(graph, 2);
 
+  int* distance = malloc(graph->numVertices * sizeof(int));
+  int* parent = malloc(graph->numVertices * sizeof(int));
+  BFS(graph, 2, distance, parent);
+  int v;
+  for (v = 0; v < graph->numVertices; v++) {
+    printf("Distance of %d from 2: %d (parent %d)\n", v, distance[v], parent[v]);
+  }
+  free(distance);
+  free(parent);
+
+  freeGraph(graph);
   return 0;
 }
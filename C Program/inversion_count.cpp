@@ -1,10 +1,9 @@
 #include <bits/stdc++.h>
 using namespace std;
-int merge(int arr[], int low, int mid, int high)
+long long merge(int arr[], int b[], int low, int mid, int high)
 {
     int i = low, j = mid + 1, k = low;
-    int b[high];
-    int count=0;
+    long long count=0;
     while (i <= mid && j <= high)
     {
         if (arr[i] <= arr[j])
@@ -45,16 +44,16 @@ int merge(int arr[], int low, int mid, int high)
 
     return count;
 }
-int mergesort(int arr[], int low, int high)
+long long mergesort(int arr[], int b[], int low, int high)
 {
     int mid;
-    int count = 0;
+    long long count = 0;
     if (high > low)
     {
-        mid = (high + low) / 2;
-        count += mergesort(arr, low, mid);
-        count += mergesort(arr, mid + 1, high);
-        count += merge(arr, low, mid, high);
+        mid = low + (high - low) / 2;
+        count += mergesort(arr, b, low, mid);
+        count += mergesort(arr, b, mid + 1, high);
+        count += merge(arr, b, low, mid, high);
     }
 
     return count;
@@ -65,14 +64,15 @@ int main()
     int n;
     cout << "enter array length=";
     cin >> n;
-    int arr[n];
+    vector<int> arr(n);
     cout << "\n enter array to be sorted=";
     for (int i = 0; i < n; i++)
     {
         cin >> arr[i];
     }
 
-    cout << mergesort(arr, 0, n);
+    vector<int> b(n);
+    cout << mergesort(arr.data(), b.data(), 0, n - 1);
     cout << endl;
 return 0;
 }
\ No newline at end of file
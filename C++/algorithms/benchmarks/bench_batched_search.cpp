@@ -0,0 +1,103 @@
+/*
+ * Batched binary search benchmark: throughput of many independent lookups.
+ *
+ * The table holds the even numbers 0, 2, 4, ... and the queries are uniform over its range.
+ * Compared:
+ *  - a loop of the original branchy binarySearch (RecursiveBinarySearchAlgorithm.cpp)
+ *  - a loop of the branchless Lower_Bound (binarySearch in binary_search.cpp since then)
+ *  - Lower_Bound_Batch with 8, 16 and 32 lanes, queries as given and sorted first
+ * Every batch result is checked against std::lower_bound.
+ *
+ * Usage:
+ * ./bench_batched_search --sizes=1e6,1e8 --queries=8M
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/search_benchmark_utils.h"
+#include "searching/batched_search.h"
+#include "searching/binary_search.h"
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {10'000, 1'000'000, 10'000'000, 100'000'000});
+    const std::size_t queryCount = args.GetSizes("queries", {4'000'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%12s %-36s %10s %11s %10s\n", "n", "method", "ns/query", "Mqueries/s", "speedup");
+    Print_Separator(84);
+
+    bool allCorrect = true;
+    for(std::size_t size : sizes)
+    {
+        std::vector<std::int32_t> table(size);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            table[i] = static_cast<std::int32_t>(2 * i);
+        }
+        const std::vector<std::int32_t> queries =
+            Generate_Uniform<std::int32_t>(queryCount, 58, 0, static_cast<std::int32_t>(std::min<std::size_t>(2 * size, INT32_MAX)));
+        std::vector<std::size_t> expected(queryCount);
+        for(std::size_t i = 0; i < queryCount; ++i)
+        {
+            expected[i] = static_cast<std::size_t>(std::lower_bound(table.begin(), table.end(), queries[i]) - table.begin());
+        }
+
+        double baselineNs = 0;
+        auto report = [&](const char* method, double ns, bool correct)
+        {
+            allCorrect &= correct;
+            std::printf("%12zu %-36s %10.2f %11.2f %9.2fx%s\n", size, method, ns / static_cast<double>(queryCount),
+                        static_cast<double>(queryCount) * 1e3 / ns, baselineNs / ns, correct ? "" : "  WRONG RESULT");
+        };
+
+        std::int64_t checksum = 0;
+        baselineNs = Best_Of_Ns(repetitions, [&] { checksum = 0; }, [&]
+        {
+            for(std::int32_t query : queries)
+            {
+                checksum += Iterative_Binary_Search(table.data(), 0, static_cast<std::int64_t>(size) - 1, query);
+            }
+            Do_Not_Optimize(checksum);
+        });
+        report("binarySearch loop (branchy)", baselineNs, true);
+
+        std::vector<std::size_t> positions(queryCount);
+        double ns = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            for(std::size_t i = 0; i < queryCount; ++i)
+            {
+                positions[i] = static_cast<std::size_t>(Lower_Bound(table.begin(), table.end(), queries[i]) - table.begin());
+            }
+        });
+        report("Lower_Bound loop (branchless)", ns, positions == expected);
+
+        auto runBatch = [&]<std::size_t Lanes>(EQueryOrder order)
+        {
+            std::fill(positions.begin(), positions.end(), std::size_t{0});
+            const double batchNs = Best_Of_Ns(repetitions, [] {}, [&]
+            {
+                Lower_Bound_Batch<Lanes>(std::span<const std::int32_t>(table), std::span<const std::int32_t>(queries), std::span(positions), order);
+            });
+            const std::string method = "Lower_Bound_Batch<" + std::to_string(Lanes) + "> (" + Query_Order_Name(order) + ")";
+            report(method.c_str(), batchNs, positions == expected);
+        };
+        for(EQueryOrder order : {EQueryOrder::AsGiven, EQueryOrder::Sorted})
+        {
+            runBatch.template operator()<8>(order);
+            runBatch.template operator()<16>(order);
+            runBatch.template operator()<32>(order);
+        }
+    }
+    Print_Separator(84);
+    std::printf("%s\n", allCorrect ? "all batches verified against std::lower_bound" : "BATCH VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,104 @@
+/*
+ * Binary search benchmark from L1 sized tables up to 1 GB.
+ *
+ * Tables hold the even numbers 0, 2, 4, ... so half of the uniformly random queries hit.
+ * Compared:
+ *  - binarySearch from binary_search.cpp (recursive, two branches per level)
+ *  - binarySearch from RecursiveBinarySearchAlgorithm.cpp (iterative, two branches per level)
+ *  - std::lower_bound
+ *  - Lower_Bound without and with prefetching
+ * Every Lower_Bound result is checked against std::lower_bound, Upper_Bound and Equal_Range are
+ * checked against their std counterparts on a table with duplicate keys.
+ *
+ * Usage:
+ * ./bench_binary_search --bytes=16K,256K,8M,64M,1G --queries=2M
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/search_benchmark_utils.h"
+#include "searching/binary_search.h"
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> byteSizes = args.GetSizes("bytes", {16'384, 262'144, 8'388'608, 67'108'864, 268'435'456});
+    const std::size_t queryCount = args.GetSizes("queries", {1'000'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%12s %12s %-34s %10s %12s\n", "table bytes", "n", "method", "ns/query", "checksum");
+    Print_Separator(86);
+
+    bool allCorrect = true;
+    for(std::size_t bytes : byteSizes)
+    {
+        const std::size_t size = std::max<std::size_t>(bytes / sizeof(std::int32_t), 1);
+        std::vector<std::int32_t> table(size);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            table[i] = static_cast<std::int32_t>(2 * i);
+        }
+        const std::vector<std::int32_t> queries =
+            Generate_Uniform<std::int32_t>(queryCount, 56, 0, static_cast<std::int32_t>(std::min<std::size_t>(2 * size, INT32_MAX)));
+
+        std::vector<std::int64_t> expected(queryCount);
+        for(std::size_t i = 0; i < queryCount; ++i)
+        {
+            expected[i] = std::lower_bound(table.begin(), table.end(), queries[i]) - table.begin();
+        }
+
+        auto run = [&](const char* method, auto&& search, bool bLowerBoundResult)
+        {
+            std::int64_t checksum = 0;
+            bool correct = true;
+            const double ns = Best_Of_Ns(repetitions, [&] { checksum = 0; }, [&]
+            {
+                for(std::int32_t query : queries)
+                {
+                    checksum += search(query);
+                }
+            });
+            if(bLowerBoundResult)
+            {
+                for(std::size_t i = 0; i < queryCount && correct; ++i)
+                {
+                    correct = search(queries[i]) == expected[i];
+                }
+            }
+            allCorrect &= correct;
+            std::printf("%12zu %12zu %-34s %10.2f %12lld%s\n", bytes, size, method, ns / static_cast<double>(queryCount),
+                        static_cast<long long>(checksum), correct ? "" : "  WRONG RESULT");
+        };
+
+        const std::int32_t* data = table.data();
+        const std::int64_t last = static_cast<std::int64_t>(size) - 1;
+        run("binarySearch (recursive)", [&](std::int32_t x) { return Recursive_Binary_Search(data, 0, last, x); }, false);
+        run("binarySearch (iterative)", [&](std::int32_t x) { return Iterative_Binary_Search(data, 0, last, x); }, false);
+        run("std::lower_bound", [&](std::int32_t x) { return std::lower_bound(table.begin(), table.end(), x) - table.begin(); }, true);
+        run("Lower_Bound (branchless)", [&](std::int32_t x) { return Lower_Bound<false>(table.begin(), table.end(), x) - table.begin(); }, true);
+        run("Lower_Bound (branchless+prefetch)", [&](std::int32_t x) { return Lower_Bound(table.begin(), table.end(), x) - table.begin(); }, true);
+    }
+    Print_Separator(86);
+
+    /* 0 0 0 3 3 3 6 6 6 ... exercises the equal key runs */
+    std::vector<std::int32_t> duplicates(30'000);
+    for(std::size_t i = 0; i < duplicates.size(); ++i)
+    {
+        duplicates[i] = static_cast<std::int32_t>(i / 3 * 3);
+    }
+    for(std::int32_t x = -1; x <= duplicates.back() + 1; ++x)
+    {
+        const auto expectedRange = std::equal_range(duplicates.begin(), duplicates.end(), x);
+        allCorrect &= Upper_Bound(duplicates.begin(), duplicates.end(), x) == expectedRange.second;
+        allCorrect &= Equal_Range(duplicates.begin(), duplicates.end(), x) == expectedRange;
+        allCorrect &= Equal_Range<false>(duplicates.begin(), duplicates.end(), x, std::less<>{}) == expectedRange;
+    }
+    std::printf("%s\n", allCorrect ? "all searches verified against std::lower_bound / upper_bound / equal_range" : "SEARCH VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,189 @@
+/*
+ * BFS benchmark: serial queue BFS against the parallel top-down, bottom-up and direction
+ * optimizing Breadth_First_Search on Graph 500 style RMAT graphs.
+ *
+ * Every --scales entry gives a graph of 2^scale vertices and --edge-factor * 2^scale edges,
+ * symmetrized (or directed with an explicit transpose under --directed). BFS runs from --sources
+ * random vertices with at least one edge. Reported is TEPS, traversed edges per second: the
+ * edges inside the reached component divided by the search time, summed over all sources.
+ * Distances must equal the serial BFS, and every parent must be a neighbour one hop closer.
+ *
+ * Usage:
+ * ./bench_breadth_first_search --scales=16,18,20,22 --edge-factor=16 --sources=16 --threads=1,8
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "graph/breadth_first_search.h"
+#include "graph/csr_graph.h"
+#include "graph/graph_generators.h"
+
+/* The textbook queue BFS, what dfs.c would do with a queue instead of recursion */
+static std::vector<std::uint32_t> Serial_Bfs(const CsrGraph<>& graph, VertexId source)
+{
+    std::vector<std::uint32_t> distance(graph.VertexCount(), kBfsUnreached);
+    std::vector<VertexId> queue;
+    queue.reserve(graph.VertexCount());
+    distance[source] = 0;
+    queue.push_back(source);
+    for(std::size_t head = 0; head < queue.size(); ++head)
+    {
+        const VertexId vertex = queue[head];
+        for(VertexId neighbor : graph.Neighbors(vertex))
+        {
+            if(distance[neighbor] == kBfsUnreached)
+            {
+                distance[neighbor] = distance[vertex] + 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+    return distance;
+}
+
+static bool Is_Bfs_Tree(const CsrGraph<>& graph, VertexId source, const BfsResult& bfs, std::span<const std::uint32_t> expected)
+{
+    if(!std::equal(bfs.distance.begin(), bfs.distance.end(), expected.begin(), expected.end()) || bfs.parent[source] != source)
+    {
+        return false;
+    }
+    std::size_t reached = 0;
+    for(std::size_t vertex = 0; vertex < graph.VertexCount(); ++vertex)
+    {
+        if(!bfs.Reached(static_cast<VertexId>(vertex)))
+        {
+            continue;
+        }
+        ++reached;
+        if(vertex == source)
+        {
+            continue;
+        }
+        const VertexId parent = bfs.parent[vertex];
+        const std::span<const VertexId> neighbors = graph.Neighbors(parent);
+        if(bfs.distance[parent] + 1 != bfs.distance[vertex] ||
+           std::find(neighbors.begin(), neighbors.end(), static_cast<VertexId>(vertex)) == neighbors.end())
+        {
+            return false;
+        }
+    }
+    return reached == bfs.reachedVertices;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> scales = args.GetSizes("scales", {16, 18, 20, 22});
+    const std::size_t edgeFactor = args.GetSizes("edge-factor", {16}).front();
+    const std::size_t sourceCount = std::max<std::size_t>(args.GetSizes("sources", {16}).front(), 1);
+    std::vector<std::size_t> threadCounts = args.GetSizes("threads", {1, Default_Thread_Count()});
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    const bool bDirected = args.Has("directed");
+
+    std::printf("%6s %10s %12s %-40s %8s %10s %10s %9s\n", "scale", "V", "E", "method", "threads", "ms/search", "MTEPS", "speedup");
+    Print_Separator(112);
+
+    bool allCorrect = true;
+    for(std::size_t scale : scales)
+    {
+        const std::size_t vertexCount = std::size_t{1} << scale;
+        CsrGraph<> graph;
+        CsrGraph<> transpose;
+        {
+            std::vector<Edge> edges = Generate_Rmat_Edges(static_cast<unsigned>(scale), edgeFactor, 66);
+            if(bDirected)
+            {
+                graph = CsrGraph<>::From_Edges(vertexCount, edges);
+                for(Edge& edge : edges)
+                {
+                    edge = {edge.target, edge.source};
+                }
+                transpose = CsrGraph<>::From_Edges(vertexCount, edges);
+            }
+            else
+            {
+                const std::vector<Edge> symmetric = Symmetrize_Edges(edges);
+                edges = {};
+                graph = CsrGraph<>::From_Edges(vertexCount, symmetric);
+            }
+        }
+        const CsrGraph<>& inEdges = bDirected ? transpose : graph;
+
+        std::vector<VertexId> sources;
+        std::mt19937_64 generator(67);
+        std::uniform_int_distribution<VertexId> pick(0, static_cast<VertexId>(vertexCount - 1));
+        while(sources.size() < sourceCount)
+        {
+            const VertexId source = pick(generator);
+            if(graph.OutDegree(source) > 0)
+            {
+                sources.push_back(source);
+            }
+        }
+
+        /* edges inside each source's component, the TEPS numerator */
+        std::vector<std::vector<std::uint32_t>> expected;
+        std::uint64_t traversedEdges = 0;
+        Stopwatch stopwatch;
+        for(VertexId source : sources)
+        {
+            expected.push_back(Serial_Bfs(graph, source));
+        }
+        const double serialNs = stopwatch.ElapsedNs();
+        for(const std::vector<std::uint32_t>& distance : expected)
+        {
+            for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                traversedEdges += distance[vertex] != kBfsUnreached ? graph.OutDegree(static_cast<VertexId>(vertex)) : 0;
+            }
+        }
+        traversedEdges /= bDirected ? 1 : 2;
+
+        auto report = [&](const std::string& method, std::size_t threads, double ns, bool correct)
+        {
+            allCorrect &= correct;
+            std::printf("%6zu %10zu %12zu %-40s %8zu %10.2f %10.1f %8.2fx%s\n", scale, vertexCount, graph.EdgeCount(), method.c_str(), threads,
+                        ns / 1e6 / static_cast<double>(sourceCount), static_cast<double>(traversedEdges) / ns * 1e3, serialNs / ns,
+                        correct ? "" : "  WRONG RESULT");
+        };
+        report("serial queue BFS", 1, serialNs, true);
+
+        for(std::size_t threads : threadCounts)
+        {
+            for(EBfsDirection direction : {EBfsDirection::TopDown, EBfsDirection::BottomUp, EBfsDirection::Auto})
+            {
+                bool correct = true;
+                std::size_t bottomUpLevels = 0;
+                std::size_t levels = 0;
+                double ns = 0;
+                for(std::size_t i = 0; i < sources.size(); ++i)
+                {
+                    stopwatch.Restart();
+                    const BfsResult bfs = Breadth_First_Search(graph, inEdges, sources[i], static_cast<unsigned>(threads), direction);
+                    ns += stopwatch.ElapsedNs();
+                    correct &= Is_Bfs_Tree(graph, sources[i], bfs, expected[i]);
+                    bottomUpLevels += bfs.bottomUpLevels;
+                    levels += bfs.topDownLevels + bfs.bottomUpLevels;
+                }
+                std::string method = Bfs_Direction_Name(direction);
+                if(direction == EBfsDirection::Auto)
+                {
+                    method += " (" + std::to_string(bottomUpLevels) + "/" + std::to_string(levels) + " bottom-up)";
+                }
+                report(method, threads, ns, correct);
+            }
+        }
+    }
+    Print_Separator(112);
+    std::printf("%s\n", allCorrect ? "all distances and BFS trees verified" : "BFS VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
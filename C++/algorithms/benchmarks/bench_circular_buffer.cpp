@@ -0,0 +1,176 @@
+/*
+ * Circular buffer benchmark: a stream of --samples int32 telemetry values kept in a window of
+ * the newest --windows samples, with the window's sum and maximum taken every --stride samples.
+ *
+ * The window is a std::deque (push_back, pop_front once full, iterators for the statistics), a
+ * CircularBuffer in EOverflow::OverwriteOldest mode read element by element through operator[],
+ * and the same buffer read through Spans(), two plain loops the compiler vectorizes. The first
+ * rows only ingest the stream without statistics. Every method must produce the same sum of
+ * sums and maximum of maxima. Reported is nanoseconds per sample and the speedup over the deque.
+ *
+ * Usage:
+ * ./bench_circular_buffer --samples=50M --windows=64,1024,16384 --stride=256
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "containers/circular_buffer.h"
+
+/*
+ * Statistics accumulated over every window taken
+ */
+struct WindowStats
+{
+    std::int64_t sum = 0;
+    std::int32_t max = std::numeric_limits<std::int32_t>::min();
+
+    bool operator==(const WindowStats&) const = default;
+};
+
+static void Accumulate(std::span<const std::int32_t> run, WindowStats& stats) noexcept
+{
+    std::int64_t sum = 0;
+    std::int32_t max = stats.max;
+    for(std::int32_t value : run)
+    {
+        sum += value;
+        max = std::max(max, value);
+    }
+    stats.sum += sum;
+    stats.max = max;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::size_t sampleCount = args.GetSizes("samples", {50'000'000}).front();
+    const std::vector<std::size_t> windows = args.GetSizes("windows", {64, 1024, 16384});
+    const std::size_t stride = std::max<std::size_t>(args.GetSizes("stride", {256}).front(), 1);
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    const std::vector<std::int32_t> samples = Generate_Uniform<std::int32_t>(sampleCount, 74, -1'000'000, 1'000'000);
+
+    std::printf("%8s %-40s %10s %12s %9s\n", "window", "method", "ms", "ns/sample", "speedup");
+    Print_Separator(83);
+
+    bool allCorrect = true;
+    for(std::size_t window : windows)
+    {
+        window = std::max<std::size_t>(window, 1);
+        double baselineNs = 0;
+        WindowStats expected;
+        auto report = [&](const std::string& method, double ns, const WindowStats& stats, bool bStats)
+        {
+            const bool bCorrect = !bStats || stats == expected;
+            allCorrect &= bCorrect;
+            std::printf("%8zu %-40s %10.1f %12.2f %8.2fx%s\n", window, method.c_str(), ns / 1e6, ns / static_cast<double>(samples.size()),
+                        baselineNs / ns, bCorrect ? "" : "  WRONG RESULT");
+        };
+
+        /* ingest only */
+        std::size_t kept = 0;
+        baselineNs = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            std::deque<std::int32_t> deque;
+            for(std::int32_t sample : samples)
+            {
+                if(deque.size() == window)
+                {
+                    deque.pop_front();
+                }
+                deque.push_back(sample);
+            }
+            kept = deque.size();
+            Do_Not_Optimize(deque.back());
+        });
+        report("std::deque ingest", baselineNs, {}, false);
+        const double ingestNs = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            CircularBuffer<std::int32_t> buffer(window, EOverflow::OverwriteOldest);
+            for(std::int32_t sample : samples)
+            {
+                buffer.PushBack(sample);
+            }
+            allCorrect &= buffer.Size() == kept;
+            Do_Not_Optimize(buffer.Back());
+        });
+        report("CircularBuffer ingest (overwrite oldest)", ingestNs, {}, false);
+
+        /* ingest and statistics every stride samples */
+        baselineNs = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            std::deque<std::int32_t> deque;
+            WindowStats stats;
+            for(std::size_t i = 0; i < samples.size(); ++i)
+            {
+                if(deque.size() == window)
+                {
+                    deque.pop_front();
+                }
+                deque.push_back(samples[i]);
+                if((i + 1) % stride == 0)
+                {
+                    std::int64_t sum = 0;
+                    for(std::int32_t value : deque)
+                    {
+                        sum += value;
+                        stats.max = std::max(stats.max, value);
+                    }
+                    stats.sum += sum;
+                }
+            }
+            expected = stats;
+        });
+        report("std::deque + statistics", baselineNs, expected, true);
+
+        WindowStats stats;
+        const double indexNs = Best_Of_Ns(repetitions, [&] { stats = {}; }, [&]
+        {
+            CircularBuffer<std::int32_t> buffer(window, EOverflow::OverwriteOldest);
+            for(std::size_t i = 0; i < samples.size(); ++i)
+            {
+                buffer.PushBack(samples[i]);
+                if((i + 1) % stride == 0)
+                {
+                    std::int64_t sum = 0;
+                    for(std::size_t index = 0; index < buffer.Size(); ++index)
+                    {
+                        sum += buffer[index];
+                        stats.max = std::max(stats.max, buffer[index]);
+                    }
+                    stats.sum += sum;
+                }
+            }
+        });
+        report("CircularBuffer operator[] + statistics", indexNs, stats, true);
+
+        const double spansNs = Best_Of_Ns(repetitions, [&] { stats = {}; }, [&]
+        {
+            CircularBuffer<std::int32_t> buffer(window, EOverflow::OverwriteOldest);
+            for(std::size_t i = 0; i < samples.size(); ++i)
+            {
+                buffer.PushBack(samples[i]);
+                if((i + 1) % stride == 0)
+                {
+                    const RingRegion<const std::int32_t> runs = std::as_const(buffer).Spans();
+                    Accumulate(runs.first, stats);
+                    Accumulate(runs.second, stats);
+                }
+            }
+        });
+        report("CircularBuffer Spans() + statistics", spansNs, stats, true);
+    }
+    Print_Separator(83);
+    std::printf("%s\n", allCorrect ? "all window statistics verified" : "CIRCULAR BUFFER VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
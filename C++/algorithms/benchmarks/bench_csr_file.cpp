@@ -0,0 +1,226 @@
+/*
+ * CSR file benchmark: loading a graph from a text edge list with addEdge against the parallel
+ * parser and against mapping the binary CSR file.
+ *
+ * An RMAT edge list (2^--scale vertices, --edge-factor edges per vertex, --weighted adds a float
+ * column) is written as text to --directory. Then:
+ *  - std::ifstream >> and CsrBuilder::AddEdge per edge, the way TopologicalSort.cpp reads a graph
+ *  - Parse_Edge_List with --threads threads, then CsrGraph::From_Edges
+ *  - Convert_Edge_List: the above plus Write_Csr_File
+ *  - Map_Csr_File with the file in the page cache, and after evicting it (posix_fadvise), each
+ *    followed by one pass over all edges, since a mapping only reads pages when touched
+ *  - Map_Csr_File with bValidate in the page cache; the same file with one target forged to
+ *    the vertex count must then be rejected
+ * Every loaded graph must be identical to the one built from the generated edges. The last
+ * line names a vertex that appears nowhere else, so the vertex count must come from every chunk.
+ *
+ * Usage:
+ * ./bench_csr_file --scale=22 --edge-factor=16 --threads=8 --directory=/tmp
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "graph/csr_file.h"
+#include "graph/csr_graph.h"
+#include "graph/graph_generators.h"
+
+static void Write_Text_Edge_List(const std::string& path, const std::vector<Edge>& edges, const std::vector<float>& weights)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        std::perror(path.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    std::fputs("# source target [weight]\n", file);
+    std::vector<char> buffer(1 << 20);
+    std::size_t used = 0;
+    for(std::size_t i = 0; i < edges.size(); ++i)
+    {
+        if(buffer.size() - used < 64)
+        {
+            std::fwrite(buffer.data(), 1, used, file);
+            used = 0;
+        }
+        char* cursor = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), edges[i].source).ptr;
+        *cursor++ = ' ';
+        cursor = std::to_chars(cursor, buffer.data() + buffer.size(), edges[i].target).ptr;
+        if(!weights.empty())
+        {
+            *cursor++ = ' ';
+            cursor = std::to_chars(cursor, buffer.data() + buffer.size(), weights[i]).ptr;
+        }
+        *cursor++ = '\n';
+        used = static_cast<std::size_t>(cursor - buffer.data());
+    }
+    std::fwrite(buffer.data(), 1, used, file);
+    std::fclose(file);
+}
+
+static void Evict_From_Page_Cache(const std::string& path)
+{
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if(descriptor >= 0)
+    {
+        ::fdatasync(descriptor);
+        ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(descriptor);
+    }
+}
+
+/* Touch every edge once, the first traversal after a load */
+static std::uint64_t Sum_Targets(const CsrGraph<>& graph)
+{
+    std::uint64_t sum = 0;
+    for(VertexId target : graph.Targets())
+    {
+        sum += target;
+    }
+    return sum;
+}
+
+static bool Same_Graph(const CsrGraph<>& expected, const CsrGraph<>& graph)
+{
+    return std::ranges::equal(expected.Offsets(), graph.Offsets()) && std::ranges::equal(expected.Targets(), graph.Targets()) &&
+           std::ranges::equal(expected.EdgeWeights(), graph.EdgeWeights());
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const unsigned scale = args.GetUnsigned("scale", 20);
+    const std::size_t edgeFactor = args.GetSizes("edge-factor", {16}).front();
+    const unsigned threads = args.GetUnsigned("threads", Default_Thread_Count());
+    const std::string directory = args.GetString("directory", "/tmp");
+    const bool bWeighted = args.Has("weighted");
+    const std::string textPath = directory + "/bench_csr_file_edges.txt";
+    const std::string csrPath = directory + "/bench_csr_file_graph.csr";
+
+    std::vector<Edge> edges = Generate_Rmat_Edges(scale, edgeFactor, 67);
+    std::size_t vertexCount = 0;
+    for(const Edge& edge : edges)
+    {
+        vertexCount = std::max<std::size_t>(vertexCount, std::size_t{std::max(edge.source, edge.target)} + 1);
+    }
+    /* the largest vertex id only on the last line, so only the last parser chunk sees it */
+    edges.push_back({0, static_cast<VertexId>(vertexCount)});
+    ++vertexCount;
+    std::vector<float> weights;
+    if(bWeighted)
+    {
+        const std::vector<std::uint32_t> raw = Generate_Uniform<std::uint32_t>(edges.size(), 68, 1, 1000);
+        weights.assign(raw.begin(), raw.end());
+    }
+    Write_Text_Edge_List(textPath, edges, weights);
+    const CsrGraph<> expected = CsrGraph<>::From_Edges(vertexCount, edges, weights);
+
+    std::printf("%-52s %8s %12s %9s\n", "load path", "threads", "ms", "speedup");
+    Print_Separator(86);
+    bool allCorrect = true;
+    double baselineNs = 0;
+    auto report = [&](const char* method, unsigned usedThreads, double ns, bool correct)
+    {
+        allCorrect &= correct;
+        baselineNs = baselineNs == 0 ? ns : baselineNs;
+        std::printf("%-52s %8u %12.3f %8.2fx%s\n", method, usedThreads, ns / 1e6, baselineNs / ns, correct ? "" : "  WRONG RESULT");
+    };
+
+    {
+        Stopwatch stopwatch;
+        std::ifstream input(textPath);
+        input.ignore(1 << 10, '\n');
+        CsrBuilder<> builder;
+        VertexId source = 0;
+        VertexId target = 0;
+        float weight = 0;
+        while(input >> source >> target)
+        {
+            if(bWeighted && input >> weight)
+            {
+                builder.AddEdge(source, target, weight);
+            }
+            else
+            {
+                builder.AddEdge(source, target);
+            }
+        }
+        const CsrGraph<> graph = std::move(builder).Build();
+        report("ifstream >> + CsrBuilder::AddEdge per edge", 1, stopwatch.ElapsedNs(), Same_Graph(expected, graph));
+    }
+    {
+        Stopwatch stopwatch;
+        EdgeList<float> list = Parse_Edge_List<float>(textPath, threads);
+        const CsrGraph<> graph = CsrGraph<>::From_Edges(list.vertexCount, list.edges, list.weights);
+        report("Parse_Edge_List + From_Edges", threads, stopwatch.ElapsedNs(), Same_Graph(expected, graph));
+    }
+    {
+        Stopwatch stopwatch;
+        const CsrGraph<> graph = Convert_Edge_List<float>(textPath, csrPath, threads);
+        report("Convert_Edge_List (text to CSR file)", threads, stopwatch.ElapsedNs(), Same_Graph(expected, graph));
+    }
+    for(const bool bCold : {false, true})
+    {
+        if(bCold)
+        {
+            Evict_From_Page_Cache(csrPath);
+        }
+        else
+        {
+            /* read it once so every page is cached */
+            Do_Not_Optimize(Sum_Targets(Map_Csr_File<float>(csrPath, true)));
+        }
+        Stopwatch stopwatch;
+        const CsrGraph<> graph = Map_Csr_File<float>(csrPath);
+        const double mapNs = stopwatch.ElapsedNs();
+        const std::uint64_t sum = Sum_Targets(graph);
+        const double touchNs = stopwatch.ElapsedNs();
+        const bool correct = sum == Sum_Targets(expected) && Same_Graph(expected, graph);
+        report(bCold ? "Map_Csr_File, evicted from the page cache" : "Map_Csr_File, in the page cache", 1, mapNs, correct);
+        report("  ... plus the first pass over all edges", 1, touchNs, correct);
+    }
+    {
+        Stopwatch stopwatch;
+        const CsrGraph<> graph = Map_Csr_File<float>(csrPath, false, true);
+        report("Map_Csr_File with bValidate, in the page cache", 1, stopwatch.ElapsedNs(), Same_Graph(expected, graph));
+
+        CsrFileHeader header = {};
+        std::fstream file(csrPath, std::ios::in | std::ios::out | std::ios::binary);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        const VertexId forged = static_cast<VertexId>(header.vertexCount);
+        file.seekp(static_cast<std::streamoff>(header.targetsPosition + (header.edgeCount / 2) * sizeof(VertexId)));
+        file.write(reinterpret_cast<const char*>(&forged), sizeof(forged));
+        file.close();
+        bool bRejected = false;
+        try
+        {
+            Do_Not_Optimize(Map_Csr_File<float>(csrPath, false, true).EdgeCount());
+        }
+        catch(const std::runtime_error&)
+        {
+            bRejected = true;
+        }
+        allCorrect &= bRejected;
+        std::printf("%-52s %s\n", "  ... a forged target", bRejected ? "rejected" : "ACCEPTED  WRONG RESULT");
+    }
+    Print_Separator(86);
+    std::printf("V=%zu E=%zu text %.1f MB, CSR file %.1f MB\n", expected.VertexCount(), expected.EdgeCount(),
+                static_cast<double>(std::ifstream(textPath, std::ios::ate | std::ios::binary).tellg()) / (1 << 20),
+                static_cast<double>(std::ifstream(csrPath, std::ios::ate | std::ios::binary).tellg()) / (1 << 20));
+    std::remove(textPath.c_str());
+    std::remove(csrPath.c_str());
+    std::printf("%s\n", allCorrect ? "all loaded graphs verified" : "CSR FILE VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,211 @@
+/*
+ * CSR graph benchmark: build and traversal against the list based Graph of TopologicalSort.cpp.
+ *
+ * The input is a random DAG (edges point from lower to higher rank of a random vertex permutation,
+ * so vertex ids carry no locality) with --degree edges per vertex on average. Compared:
+ *  - build: Graph::addEdge into list<int>[V] / CsrBuilder::AddEdge + Build / CsrGraph::From_Edges
+ *  - DFS reachability from the lowest ranked vertex and a DFS topological sort over every vertex
+ * Both traversals use the same explicit stack DFS, only the adjacency storage differs (the
+ * recursive topologicalSortUtil overflows the stack on graphs this deep). C Program/dfs.c keeps
+ * a malloc'd node per edge as well and behaves like the list graph.
+ * The two topological orders must be identical and valid for every edge.
+ *
+ * The list graph needs ~32 bytes per edge: 100M edges take ~4 GB next to the 800 MB edge list.
+ *
+ * Usage:
+ * ./bench_csr_graph --edges=10M,100M --degree=8
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <numeric>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/graph_benchmark_utils.h"
+#include "graph/csr_graph.h"
+
+/* TopologicalSort.cpp before CSR: one list node per edge, freed here so the benchmark can repeat */
+class ListGraph
+{
+public:
+    explicit ListGraph(int vertexCount) : V(vertexCount), adj(new std::list<int>[vertexCount]) {}
+    ~ListGraph() { delete[] adj; }
+    ListGraph(const ListGraph&) = delete;
+    ListGraph& operator=(const ListGraph&) = delete;
+
+    void addEdge(int v, int w) { adj[v].push_back(w); }
+    const std::list<int>& Neighbors(int v) const { return adj[v]; }
+
+private:
+    int V;
+    std::list<int>* adj;
+};
+
+/**
+ * @brief Explicit stack DFS from `roots`; returns the vertices in reverse postorder.
+ *
+ * For a DAG the reverse postorder over all roots is a topological order.
+ */
+template<class NeighborsOf>
+static std::vector<VertexId> Dfs_Reverse_Postorder(std::size_t vertexCount, std::span<const VertexId> roots, NeighborsOf&& neighborsOf)
+{
+    using Iterator = decltype(std::begin(neighborsOf(VertexId{0})));
+    struct Frame
+    {
+        VertexId vertex;
+        Iterator next;
+        Iterator end;
+    };
+    std::vector<char> visited(vertexCount, 0);
+    std::vector<Frame> stack;
+    std::vector<VertexId> postorder;
+    postorder.reserve(vertexCount);
+    for(VertexId root : roots)
+    {
+        if(visited[root])
+        {
+            continue;
+        }
+        visited[root] = 1;
+        auto&& rootNeighbors = neighborsOf(root);
+        stack.push_back({root, std::begin(rootNeighbors), std::end(rootNeighbors)});
+        while(!stack.empty())
+        {
+            Frame& frame = stack.back();
+            if(frame.next == frame.end)
+            {
+                postorder.push_back(frame.vertex);
+                stack.pop_back();
+                continue;
+            }
+            const VertexId neighbor = static_cast<VertexId>(*frame.next++);
+            if(!visited[neighbor])
+            {
+                visited[neighbor] = 1;
+                auto&& neighbors = neighborsOf(neighbor);
+                stack.push_back({neighbor, std::begin(neighbors), std::end(neighbors)});
+            }
+        }
+    }
+    std::reverse(postorder.begin(), postorder.end());
+    return postorder;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> edgeCounts = args.GetSizes("edges", {1'000'000, 10'000'000, 100'000'000});
+    const std::size_t degree = std::max<std::size_t>(args.GetSizes("degree", {8}).front(), 1);
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%12s %12s %-36s %10s %10s %9s\n", "V", "E", "step", "ms", "MB", "speedup");
+    Print_Separator(96);
+
+    bool allCorrect = true;
+    for(std::size_t edgeCount : edgeCounts)
+    {
+        const std::size_t vertexCount = std::max<std::size_t>(edgeCount / degree, 2);
+        std::vector<VertexId> rankToVertex(vertexCount);
+        std::iota(rankToVertex.begin(), rankToVertex.end(), VertexId{0});
+        std::shuffle(rankToVertex.begin(), rankToVertex.end(), std::mt19937_64(62));
+        std::vector<Edge> edges(edgeCount);
+        {
+            const std::vector<std::uint32_t> ends = Generate_Uniform<std::uint32_t>(2 * edgeCount, 63, 0, static_cast<std::uint32_t>(vertexCount - 1));
+            for(std::size_t i = 0; i < edgeCount; ++i)
+            {
+                std::uint32_t low = std::min(ends[2 * i], ends[2 * i + 1]);
+                std::uint32_t high = std::max(ends[2 * i], ends[2 * i + 1]);
+                high += low == high ? (high + 1 < vertexCount ? 1 : 0) : 0;
+                low -= low == high ? 1 : 0;
+                edges[i] = {rankToVertex[low], rankToVertex[high]};
+            }
+        }
+        std::vector<VertexId> allVertices(vertexCount);
+        std::iota(allVertices.begin(), allVertices.end(), VertexId{0});
+        /* the lowest ranked vertex reaches most of the DAG */
+        const VertexId source[] = {rankToVertex[0]};
+
+        auto report = [&](const char* step, double ns, double bytes, double baselineNs)
+        {
+            char megabytes[16] = "";
+            if(bytes > 0)
+            {
+                std::snprintf(megabytes, sizeof(megabytes), "%.1f", bytes / (1 << 20));
+            }
+            std::printf("%12zu %12zu %-36s %10.1f %10s %8.2fx\n", vertexCount, edgeCount, step, ns / 1e6, megabytes, baselineNs / ns);
+        };
+
+        /* CSR first and released before the list graph is built, so the two never compete for memory */
+        std::size_t csrReached = 0;
+        std::vector<VertexId> csrOrder;
+        double builderNs = 0;
+        double fromEdgesNs = 0;
+        double csrReachNs = 0;
+        double csrTopoNs = 0;
+        std::size_t csrBytes = 0;
+        {
+            builderNs = Best_Of_Ns(repetitions, [] {}, [&]
+            {
+                CsrBuilder<> builder(vertexCount);
+                for(const Edge& edge : edges)
+                {
+                    builder.AddEdge(edge.source, edge.target);
+                }
+                const CsrGraph<> graph = std::move(builder).Build();
+                Do_Not_Optimize(graph.EdgeCount());
+            });
+            CsrGraph<> graph;
+            fromEdgesNs = Best_Of_Ns(repetitions, [&] { graph = CsrGraph<>(); }, [&] { graph = CsrGraph<>::From_Edges(vertexCount, edges); });
+            csrBytes = graph.MemoryBytes();
+            auto neighborsOf = [&](VertexId vertex) { return graph.Neighbors(vertex); };
+            csrReachNs = Best_Of_Ns(repetitions, [] {}, [&] { csrReached = Dfs_Reverse_Postorder(vertexCount, source, neighborsOf).size(); });
+            csrTopoNs = Best_Of_Ns(repetitions, [] {}, [&] { csrOrder = Dfs_Reverse_Postorder(vertexCount, allVertices, neighborsOf); });
+        }
+
+        /* the list graph is built once (building it again per repetition would take minutes at 100M) */
+        std::vector<VertexId> listOrder;
+        std::size_t listReached = 0;
+        double listBuildNs = 0;
+        double listReachNs = 0;
+        double listTopoNs = 0;
+        {
+            Stopwatch stopwatch;
+            ListGraph graph(static_cast<int>(vertexCount));
+            for(const Edge& edge : edges)
+            {
+                graph.addEdge(static_cast<int>(edge.source), static_cast<int>(edge.target));
+            }
+            listBuildNs = stopwatch.ElapsedNs();
+            auto neighborsOf = [&](VertexId vertex) -> const std::list<int>& { return graph.Neighbors(static_cast<int>(vertex)); };
+            listReachNs = Best_Of_Ns(repetitions, [] {}, [&] { listReached = Dfs_Reverse_Postorder(vertexCount, source, neighborsOf).size(); });
+            listTopoNs = Best_Of_Ns(repetitions, [] {}, [&] { listOrder = Dfs_Reverse_Postorder(vertexCount, allVertices, neighborsOf); });
+        }
+        /* std::list node: two pointers and the int, rounded up by malloc */
+        const double listBytes = static_cast<double>(edgeCount) * 32 + static_cast<double>(vertexCount) * sizeof(std::list<int>);
+
+        report("Graph::addEdge (list<int>[V])", listBuildNs, listBytes, listBuildNs);
+        report("CsrBuilder::AddEdge + Build", builderNs, static_cast<double>(csrBytes), listBuildNs);
+        report("CsrGraph::From_Edges", fromEdgesNs, static_cast<double>(csrBytes), listBuildNs);
+        report("DFS from the first vertex (list)", listReachNs, 0, listReachNs);
+        report("DFS from the first vertex (CSR)", csrReachNs, 0, listReachNs);
+        report("DFS topological sort (list)", listTopoNs, 0, listTopoNs);
+        report("DFS topological sort (CSR)", csrTopoNs, 0, listTopoNs);
+
+        const bool correct = listReached == csrReached && listOrder == csrOrder && Is_Topological_Order(CsrGraph<>::From_Edges(vertexCount, edges), csrOrder);
+        allCorrect &= correct;
+        if(!correct)
+        {
+            std::printf("%12zu %12zu WRONG RESULT\n", vertexCount, edgeCount);
+        }
+    }
+    Print_Separator(96);
+    std::printf("%s\n", allCorrect ? "list and CSR traversals agree, topological orders verified" : "GRAPH VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
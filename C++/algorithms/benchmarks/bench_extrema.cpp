@@ -0,0 +1,256 @@
+/*
+ * Extrema benchmark: ExtremaStack against the running maximum / minimum stacks of
+ * Maximum_Stack_Element.cpp, and sliding window maxima and minima three ways.
+ *
+ * Stack: --operations random calls, 35% push, 25% pop, 20% max and 20% min query, with the
+ * pushed values either uniform ("random") or an upward drift plus noise ("rising", which sets
+ * new maxima often). The baseline keeps std::stack<int> values plus one std::stack<int> of
+ * running maxima and one of running minima, the original program with a minimum added; a pop or
+ * query on an empty stack is skipped, as in the original. Every query answer goes into a
+ * checksum that both must agree on. Also reported: auxiliary entries left at the end, against
+ * the two per element of the baseline.
+ *
+ * Windows: --samples uniform int32 values, maximum and minimum of every full window of each
+ * --windows length, by a textbook std::deque of indexes per extremum, by SlidingWindowExtrema,
+ * and by Sliding_Window_Max + Sliding_Window_Min, scalar and at the best SIMD level. The sums of
+ * all window maxima and of all window minima must agree.
+ *
+ * Usage:
+ * ./bench_extrema --operations=100M --samples=100M --windows=16,256,4096
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <span>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/cpu_features.h"
+#include "containers/extrema.h"
+
+/*
+ * Sums of every answer, compared between methods
+ */
+struct ExtremaChecksum
+{
+    std::int64_t maxima = 0;
+    std::int64_t minima = 0;
+
+    bool operator==(const ExtremaChecksum&) const = default;
+};
+
+/*
+ * Stack operation codes of the generated workload
+ */
+enum class EStackOp : std::uint8_t
+{
+    Push,
+    Pop,
+    Max,
+    Min
+};
+
+static std::vector<EStackOp> Generate_Stack_Ops(std::size_t count, std::uint64_t seed)
+{
+    const std::vector<std::uint32_t> draws = Generate_Uniform<std::uint32_t>(count, seed, 0, 99);
+    std::vector<EStackOp> ops(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        ops[i] = draws[i] < 35 ? EStackOp::Push : draws[i] < 60 ? EStackOp::Pop : draws[i] < 80 ? EStackOp::Max : EStackOp::Min;
+    }
+    return ops;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::size_t operationCount = args.GetSizes("operations", {100'000'000}).front();
+    const std::size_t sampleCount = args.GetSizes("samples", {100'000'000}).front();
+    const std::vector<std::size_t> windows = args.GetSizes("windows", {16, 256, 4096});
+    const unsigned repetitions = args.GetUnsigned("reps", 1);
+
+    bool allCorrect = true;
+    std::printf("%-7s %-44s %10s %10s %9s %14s\n", "values", "stack", "ms", "Mops/s", "speedup", "aux entries");
+    Print_Separator(99);
+    const std::vector<EStackOp> ops = Generate_Stack_Ops(operationCount, 75);
+    for(const char* shape : {"random", "rising"})
+    {
+        std::vector<std::int32_t> values = Generate_Uniform<std::int32_t>(operationCount, 76, -1'000'000, 1'000'000);
+        if(std::string(shape) == "rising")
+        {
+            for(std::size_t i = 0; i < values.size(); ++i)
+            {
+                values[i] = static_cast<std::int32_t>(i / 16) + values[i] / 1000;
+            }
+        }
+
+        ExtremaChecksum expected;
+        std::size_t baselineAux = 0;
+        const double baselineNs = Best_Of_Ns(repetitions, [&] { expected = {}; }, [&]
+        {
+            std::stack<int> stack;
+            std::stack<int> maxima;
+            std::stack<int> minima;
+            for(std::size_t i = 0; i < ops.size(); ++i)
+            {
+                switch(ops[i])
+                {
+                    case EStackOp::Push:
+                        stack.push(values[i]);
+                        maxima.push(maxima.empty() ? values[i] : std::max(maxima.top(), values[i]));
+                        minima.push(minima.empty() ? values[i] : std::min(minima.top(), values[i]));
+                        break;
+                    case EStackOp::Pop:
+                        if(!stack.empty())
+                        {
+                            stack.pop();
+                            maxima.pop();
+                            minima.pop();
+                        }
+                        break;
+                    case EStackOp::Max:
+                        expected.maxima += maxima.empty() ? 0 : maxima.top();
+                        break;
+                    case EStackOp::Min:
+                        expected.minima += minima.empty() ? 0 : minima.top();
+                        break;
+                }
+            }
+            baselineAux = maxima.size() + minima.size();
+        });
+        auto report = [&](const char* method, double ns, bool bCorrect, std::size_t aux)
+        {
+            allCorrect &= bCorrect;
+            std::printf("%-7s %-44s %10.1f %10.1f %8.2fx %14zu%s\n", shape, method, ns / 1e6, static_cast<double>(ops.size()) / ns * 1e3, baselineNs / ns,
+                        aux, bCorrect ? "" : "  WRONG RESULT");
+        };
+        report("std::stack values + running max / min", baselineNs, true, baselineAux);
+
+        ExtremaChecksum checksum;
+        std::size_t aux = 0;
+        const double stackNs = Best_Of_Ns(repetitions, [&] { checksum = {}; }, [&]
+        {
+            ExtremaStack<std::int32_t> stack;
+            for(std::size_t i = 0; i < ops.size(); ++i)
+            {
+                switch(ops[i])
+                {
+                    case EStackOp::Push:
+                        stack.Push(values[i]);
+                        break;
+                    case EStackOp::Pop:
+                        if(!stack.Empty())
+                        {
+                            stack.Pop();
+                        }
+                        break;
+                    case EStackOp::Max:
+                        checksum.maxima += stack.Empty() ? 0 : stack.Max();
+                        break;
+                    case EStackOp::Min:
+                        checksum.minima += stack.Empty() ? 0 : stack.Min();
+                        break;
+                }
+            }
+            aux = stack.AuxiliarySize();
+        });
+        report("ExtremaStack", stackNs, checksum == expected, aux);
+    }
+    Print_Separator(99);
+
+    std::printf("\n%-7s %-44s %10s %10s %9s\n", "window", "sliding window max + min", "ms", "Msamples/s", "speedup");
+    Print_Separator(84);
+    const std::vector<std::int32_t> samples = Generate_Uniform<std::int32_t>(sampleCount, 77, -1'000'000, 1'000'000);
+    std::vector<std::int32_t> maxima(samples.size());
+    std::vector<std::int32_t> minima(samples.size());
+    for(std::size_t window : windows)
+    {
+        window = std::clamp<std::size_t>(window, 1, std::max<std::size_t>(samples.size(), 1));
+        ExtremaChecksum expected;
+        const double baselineNs = Best_Of_Ns(repetitions, [&] { expected = {}; }, [&]
+        {
+            std::deque<std::size_t> largest;
+            std::deque<std::size_t> smallest;
+            for(std::size_t i = 0; i < samples.size(); ++i)
+            {
+                while(!largest.empty() && samples[largest.back()] <= samples[i])
+                {
+                    largest.pop_back();
+                }
+                while(!smallest.empty() && samples[smallest.back()] >= samples[i])
+                {
+                    smallest.pop_back();
+                }
+                largest.push_back(i);
+                smallest.push_back(i);
+                if(largest.front() + window <= i)
+                {
+                    largest.pop_front();
+                }
+                if(smallest.front() + window <= i)
+                {
+                    smallest.pop_front();
+                }
+                if(i + 1 >= window)
+                {
+                    expected.maxima += samples[largest.front()];
+                    expected.minima += samples[smallest.front()];
+                }
+            }
+        });
+        auto report = [&](const std::string& method, double ns, const ExtremaChecksum& checksum)
+        {
+            const bool bCorrect = checksum == expected;
+            allCorrect &= bCorrect;
+            std::printf("%-7zu %-44s %10.1f %10.1f %8.2fx%s\n", window, method.c_str(), ns / 1e6, static_cast<double>(samples.size()) / ns * 1e3,
+                        baselineNs / ns, bCorrect ? "" : "  WRONG RESULT");
+        };
+        report("std::deque of indexes (textbook)", baselineNs, expected);
+
+        ExtremaChecksum checksum;
+        const double streamNs = Best_Of_Ns(repetitions, [&] { checksum = {}; }, [&]
+        {
+            SlidingWindowExtrema<std::int32_t> extrema(window);
+            for(std::size_t i = 0; i < samples.size(); ++i)
+            {
+                extrema.Push(samples[i]);
+                if(i + 1 >= window)
+                {
+                    checksum.maxima += extrema.Max();
+                    checksum.minima += extrema.Min();
+                }
+            }
+        });
+        report("SlidingWindowExtrema", streamNs, checksum);
+
+        std::vector<ESimdLevel> levels = {ESimdLevel::Scalar};
+        if(Detect_Simd_Level() != ESimdLevel::Scalar)
+        {
+            levels.push_back(Detect_Simd_Level());
+        }
+        for(ESimdLevel level : levels)
+        {
+            std::size_t written = 0;
+            const double blockNs = Best_Of_Ns(repetitions, [] {}, [&]
+            {
+                written = Sliding_Window_Max<std::int32_t>(samples, window, maxima, level);
+                Sliding_Window_Min<std::int32_t>(samples, window, minima, level);
+            });
+            checksum = {};
+            for(std::size_t i = 0; i < written; ++i)
+            {
+                checksum.maxima += maxima[i];
+                checksum.minima += minima[i];
+            }
+            report(std::string("Sliding_Window_Max + Min, blocks (") + Simd_Level_Name(level) + ")", blockNs, checksum);
+        }
+    }
+    Print_Separator(84);
+    std::printf("%s\n", allCorrect ? "all stack answers and window extrema verified" : "EXTREMA VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,142 @@
+/*
+ * Interpolation / exponential search benchmark.
+ *
+ * Sorted int64 keys from Generate_Sorted_Keys: uniform, and the skewed lognormal and clustered
+ * shapes. Queries are drawn from the stored keys, half of them moved off the key by one.
+ *  - random queries:    binarySearch from binary_search.cpp, std::lower_bound, Lower_Bound,
+ *                       Interpolation_Lower_Bound and AdaptiveSearch (with the strategy it chose)
+ *  - ascending queries: the same queries sorted, Lower_Bound from scratch against
+ *                       Exponential_Lower_Bound galloping from the previous result
+ * Every lower bound is checked against std::lower_bound.
+ *
+ * Usage:
+ * ./bench_interpolation_search --sizes=1e6,1e8 --queries=2M --distributions=uniform,lognormal
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/search_benchmark_utils.h"
+#include "searching/binary_search.h"
+#include "searching/interpolation_search.h"
+
+static bool g_allCorrect = true;
+
+static void Report(const std::string& distribution, std::size_t size, const char* queryOrder, const std::string& method,
+                   double ns, double baselineNs, std::size_t queryCount, const std::string& notes, bool correct)
+{
+    g_allCorrect &= correct;
+    std::printf("%-10s %11zu %-10s %-30s %10.2f %9.2fx  %s%s\n", distribution.c_str(), size, queryOrder, method.c_str(),
+                ns / static_cast<double>(queryCount), baselineNs / ns, notes.c_str(), correct ? "" : "  WRONG RESULT");
+}
+
+static void Bench_Distribution(const std::string& distribution, std::size_t size, std::size_t queryCount, unsigned repetitions)
+{
+    const std::vector<std::int64_t> keys = Generate_Sorted_Keys(distribution, size, 61);
+    const std::span<const std::int64_t> view(keys);
+    std::vector<std::int64_t> queries(queryCount);
+    if(size > 0)
+    {
+        const std::vector<std::uint64_t> picks = Generate_Uniform<std::uint64_t>(queryCount, 62, 0, size - 1);
+        for(std::size_t i = 0; i < queryCount; ++i)
+        {
+            queries[i] = keys[picks[i]] + static_cast<std::int64_t>(picks[i] & 1);
+        }
+    }
+    auto expectedFor = [&](const std::vector<std::int64_t>& lookups)
+    {
+        std::vector<std::size_t> expected(lookups.size());
+        for(std::size_t i = 0; i < lookups.size(); ++i)
+        {
+            expected[i] = static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), lookups[i]) - keys.begin());
+        }
+        return expected;
+    };
+
+    /* positionOf(query, previous) must return the lower bound position */
+    auto run = [&](const std::vector<std::int64_t>& lookups, const std::vector<std::size_t>& expected, auto&& positionOf)
+    {
+        std::vector<std::size_t> positions(lookups.size());
+        const double ns = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            std::size_t previous = 0;
+            for(std::size_t i = 0; i < lookups.size(); ++i)
+            {
+                previous = positionOf(lookups[i], previous);
+                positions[i] = previous;
+            }
+        });
+        return std::pair{ns, positions == expected};
+    };
+
+    const std::vector<std::size_t> expected = expectedFor(queries);
+    std::int64_t checksum = 0;
+    const double baselineNs = Best_Of_Ns(repetitions, [&] { checksum = 0; }, [&]
+    {
+        for(std::int64_t query : queries)
+        {
+            checksum += Recursive_Binary_Search(keys.data(), 0, static_cast<std::int64_t>(size) - 1, query);
+        }
+        Do_Not_Optimize(checksum);
+    });
+    Report(distribution, size, "random", "binarySearch (recursive)", baselineNs, baselineNs, queryCount, "", true);
+
+    auto [ns, correct] = run(queries, expected, [&](std::int64_t query, std::size_t)
+    {
+        return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), query) - keys.begin());
+    });
+    Report(distribution, size, "random", "std::lower_bound", ns, baselineNs, queryCount, "", correct);
+    auto lowerBound = [&](std::int64_t query, std::size_t) { return static_cast<std::size_t>(Lower_Bound(keys.begin(), keys.end(), query) - keys.begin()); };
+    std::tie(ns, correct) = run(queries, expected, lowerBound);
+    Report(distribution, size, "random", "Lower_Bound (branchless)", ns, baselineNs, queryCount, "", correct);
+    std::tie(ns, correct) = run(queries, expected, [&](std::int64_t query, std::size_t) { return Interpolation_Lower_Bound(view, query); });
+    Report(distribution, size, "random", "Interpolation_Lower_Bound", ns, baselineNs, queryCount, "", correct);
+
+    Stopwatch stopwatch;
+    const AdaptiveSearch<std::int64_t> adaptive(view);
+    const double sampleMs = stopwatch.ElapsedNs() / 1e6;
+    std::tie(ns, correct) = run(queries, expected, [&](std::int64_t query, std::size_t) { return adaptive.LowerBound(query); });
+    char notes[96];
+    std::snprintf(notes, sizeof(notes), "%s, %.2f steps/sample, sampled in %.3f ms", Search_Strategy_Name(adaptive.Strategy()),
+                  adaptive.InterpolationSteps(), sampleMs);
+    Report(distribution, size, "random", "AdaptiveSearch", ns, baselineNs, queryCount, notes, correct);
+
+    std::vector<std::int64_t> ascending = queries;
+    std::sort(ascending.begin(), ascending.end());
+    const std::vector<std::size_t> ascendingExpected = expectedFor(ascending);
+    const auto [ascendingBaselineNs, ascendingCorrect] = run(ascending, ascendingExpected, lowerBound);
+    Report(distribution, size, "ascending", "Lower_Bound (branchless)", ascendingBaselineNs, ascendingBaselineNs, queryCount, "", ascendingCorrect);
+    std::tie(ns, correct) = run(ascending, ascendingExpected, [&](std::int64_t query, std::size_t previous)
+    {
+        return Exponential_Lower_Bound(view, query, previous);
+    });
+    Report(distribution, size, "ascending", "Exponential_Lower_Bound (hint)", ns, ascendingBaselineNs, queryCount, "", correct);
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {10'000, 1'000'000, 10'000'000, 50'000'000});
+    const std::vector<std::string> distributions = args.GetList("distributions", {"uniform", "lognormal", "clustered"});
+    const std::size_t queryCount = args.GetSizes("queries", {2'000'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-10s %11s %-10s %-30s %10s %10s  %s\n", "data", "n", "queries", "method", "ns/query", "speedup", "notes");
+    Print_Separator(120);
+    for(const std::string& distribution : distributions)
+    {
+        for(std::size_t size : sizes)
+        {
+            Bench_Distribution(distribution, size, queryCount, repetitions);
+        }
+    }
+    Print_Separator(120);
+    std::printf("%s\n", g_allCorrect ? "all lower bounds verified against std::lower_bound" : "SEARCH VERIFICATION FAILED");
+    return g_allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
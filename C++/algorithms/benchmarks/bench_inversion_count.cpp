@@ -0,0 +1,92 @@
+/*
+ * Inversion counting benchmark.
+ *
+ * Compares the serial merge counter, the parallel merge counter and the Fenwick counter
+ * on random int32 keys. Every result is cross-checked against the serial counter (and an
+ * O(n^2) count for tiny inputs), the process exits with EXIT_FAILURE on any mismatch.
+ *
+ * Usage:
+ * ./bench_inversion_count --sizes=1e5,1e6,1e7 --threads=8 --domain=4096 --reps=3
+ * ./bench_inversion_count --sizes=1G          # needs ~8 GB: keys plus one scratch buffer
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "sorting/inversion_count.h"
+
+static std::uint64_t Count_Inversions_Quadratic(const std::vector<std::int32_t>& data)
+{
+    std::uint64_t count = 0;
+    for(std::size_t i = 0; i < data.size(); ++i)
+    {
+        for(std::size_t j = i + 1; j < data.size(); ++j)
+        {
+            count += data[i] > data[j];
+        }
+    }
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {1'000, 100'000, 1'000'000, 10'000'000});
+    const unsigned threads = args.GetUnsigned("threads", Default_Thread_Count());
+    const unsigned domain = args.GetUnsigned("domain", 4096);
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-12s %-22s %8s %12s %10s %22s\n", "n", "method", "threads", "ms", "ns/elem", "inversions");
+    Print_Separator();
+
+    bool allCorrect = true;
+    for(std::size_t size : sizes)
+    {
+        for(const bool smallDomain : {false, true})
+        {
+            const std::vector<std::int32_t> input = smallDomain
+                ? Generate_Uniform<std::int32_t>(size, 51, 0, static_cast<std::int32_t>(domain) - 1)
+                : Generate_Uniform<std::int32_t>(size, 51);
+            std::vector<std::int32_t> work;
+            const auto reset = [&] { work = input; };
+
+            std::uint64_t reference = 0;
+            std::uint64_t result = 0;
+            auto report = [&](const char* method, unsigned usedThreads, double ns)
+            {
+                const bool correct = result == reference;
+                allCorrect &= correct;
+                std::printf("%-12zu %-22s %8u %12.2f %10.2f %22" PRIu64 "%s\n", size, method, usedThreads,
+                            ns / 1e6, ns / static_cast<double>(size ? size : 1), result, correct ? "" : "  MISMATCH");
+            };
+
+            double ns = Best_Of_Ns(repetitions, reset, [&] { reference = Count_Inversions_In_Place(std::span(work), 1); });
+            if(size <= 4096 && Count_Inversions_Quadratic(input) != reference)
+            {
+                std::printf("serial merge counter disagrees with the O(n^2) count at n = %zu\n", size);
+                allCorrect = false;
+            }
+            result = reference;
+            report(smallDomain ? "merge serial (domain)" : "merge serial", 1, ns);
+
+            ns = Best_Of_Ns(repetitions, reset, [&] { result = Count_Inversions_In_Place(std::span(work), threads); });
+            report(smallDomain ? "merge parallel (domain)" : "merge parallel", threads, ns);
+
+            if(smallDomain)
+            {
+                ns = Best_Of_Ns(repetitions, [] {}, [&] { result = Count_Inversions_Fenwick(std::span<const std::int32_t>(input), 1); });
+                report("fenwick serial", 1, ns);
+                ns = Best_Of_Ns(repetitions, [] {}, [&] { result = Count_Inversions_Fenwick(std::span<const std::int32_t>(input), threads); });
+                report("fenwick parallel", threads, ns);
+            }
+        }
+    }
+    Print_Separator();
+    std::printf("%s\n", allCorrect ? "all counters agree" : "COUNTERS DISAGREE");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+/*
+ * Key-value sorting benchmark.
+ *
+ *  - argsort:  std::sort of an index array with a key comparator vs Arg_Sort
+ *  - soa:      materialize pairs, std::sort, scatter back vs Sort_Key_Value on the parallel arrays
+ *  - records:  std::sort / std::stable_sort of 64 and 256 byte structs by key vs Sort_By_Key
+ *
+ * Everything is verified against std::stable_sort (all library sorts are stable).
+ *
+ * Usage:
+ * ./bench_key_value_sort --sizes=1e5,1e6,1e7 --reps=3
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "sorting/key_value_sort.h"
+
+template<std::size_t Bytes>
+struct Record
+{
+    std::uint64_t key;
+    std::array<std::uint64_t, (Bytes - sizeof(std::uint64_t)) / sizeof(std::uint64_t)> payload;
+
+    bool operator==(const Record&) const = default;
+};
+
+static bool g_allCorrect = true;
+
+static void Report(const char* group, std::size_t size, const char* method, double ns, double baselineNs, bool correct)
+{
+    g_allCorrect &= correct;
+    std::printf("%-14s %10zu %-36s %12.2f %10.2f %9.2fx%s\n", group, size, method, ns / 1e6,
+                ns / static_cast<double>(std::max<std::size_t>(size, 1)), baselineNs / ns, correct ? "" : "  WRONG RESULT");
+}
+
+static void Bench_Arg_Sort(std::size_t size, unsigned repetitions)
+{
+    const std::vector<std::uint32_t> keys = Generate_Uniform<std::uint32_t>(size, 55, 0, static_cast<std::uint32_t>(size));
+    std::vector<std::uint32_t> expected(size);
+    std::iota(expected.begin(), expected.end(), 0u);
+    std::stable_sort(expected.begin(), expected.end(), [&](std::uint32_t left, std::uint32_t right) { return keys[left] < keys[right]; });
+
+    std::vector<std::uint32_t> order;
+    const double baselineNs = Best_Of_Ns(repetitions, [] {}, [&]
+    {
+        order.resize(size);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right) { return keys[left] < keys[right]; });
+    });
+    /* std::sort is not stable, only check that the order sorts the keys */
+    Report("argsort", size, "std::sort(indices, by key)", baselineNs, baselineNs,
+           std::is_sorted(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right) { return keys[left] < keys[right]; }));
+
+    const double ns = Best_Of_Ns(repetitions, [] {}, [&] { order = Arg_Sort(std::span(keys)); });
+    Report("argsort", size, "Arg_Sort (radix)", ns, baselineNs, order == expected);
+}
+
+static void Bench_Soa(std::size_t size, unsigned repetitions)
+{
+    const std::vector<std::int32_t> inputKeys = Generate_Uniform<std::int32_t>(size, 56);
+    std::vector<std::uint64_t> inputValues(size);
+    std::iota(inputValues.begin(), inputValues.end(), std::uint64_t{0});
+
+    std::vector<std::pair<std::int32_t, std::uint64_t>> expected(size);
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        expected[i] = {inputKeys[i], inputValues[i]};
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+
+    std::vector<std::int32_t> keys;
+    std::vector<std::uint64_t> values;
+    const auto reset = [&] { keys = inputKeys; values = inputValues; };
+    auto matches = [&]
+    {
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            if(keys[i] != expected[i].first || values[i] != expected[i].second)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const double baselineNs = Best_Of_Ns(repetitions, reset, [&]
+    {
+        std::vector<std::pair<std::int32_t, std::uint64_t>> pairs(size);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            pairs[i] = {keys[i], values[i]};
+        }
+        std::stable_sort(pairs.begin(), pairs.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            keys[i] = pairs[i].first;
+            values[i] = pairs[i].second;
+        }
+    });
+    Report("soa", size, "pairs + std::stable_sort + scatter", baselineNs, baselineNs, matches());
+
+    const double ns = Best_Of_Ns(repetitions, reset, [&] { Sort_Key_Value(std::span(keys), std::span(values)); });
+    Report("soa", size, "Sort_Key_Value", ns, baselineNs, matches());
+}
+
+template<std::size_t Bytes>
+static void Bench_Records(std::size_t size, unsigned repetitions)
+{
+    using RecordType = Record<Bytes>;
+    const std::vector<std::uint64_t> keys = Generate_Uniform<std::uint64_t>(size, 57, 0, size);
+    std::vector<RecordType> input(size);
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        input[i].key = keys[i];
+        input[i].payload.fill(i);
+    }
+    const auto byKey = [](const RecordType& left, const RecordType& right) { return left.key < right.key; };
+    std::vector<RecordType> expected = input;
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+
+    char group[32];
+    std::snprintf(group, sizeof(group), "records %zuB", Bytes);
+    std::vector<RecordType> records;
+    const auto reset = [&] { records = input; };
+
+    const double baselineNs = Best_Of_Ns(repetitions, reset, [&] { std::sort(records.begin(), records.end(), byKey); });
+    Report(group, size, "std::sort(structs)", baselineNs, baselineNs, std::is_sorted(records.begin(), records.end(), byKey));
+
+    double ns = Best_Of_Ns(repetitions, reset, [&] { std::stable_sort(records.begin(), records.end(), byKey); });
+    Report(group, size, "std::stable_sort(structs)", ns, baselineNs, records == expected);
+
+    ns = Best_Of_Ns(repetitions, reset, [&] { Sort_By_Key(std::span(records), [](const RecordType& record) { return record.key; }); });
+    Report(group, size, "Sort_By_Key (keys + cycle permute)", ns, baselineNs, records == expected);
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {100'000, 1'000'000});
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-14s %10s %-36s %12s %10s %10s\n", "group", "n", "method", "ms", "ns/elem", "speedup");
+    Print_Separator(98);
+    for(std::size_t size : sizes)
+    {
+        Bench_Arg_Sort(size, repetitions);
+        Bench_Soa(size, repetitions);
+        Bench_Records<64>(size, repetitions);
+        Bench_Records<256>(size, repetitions);
+    }
+    Print_Separator(98);
+    std::printf("%s\n", g_allCorrect ? "all key-value sorts verified against std::stable_sort" : "KEY-VALUE SORT VERIFICATION FAILED");
+    return g_allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+/*
+ * Learned index benchmark: index size, build time and lookup latency.
+ *
+ * Sorted int64 keys from Generate_Sorted_Keys (uniform, lognormal and clustered), queries are
+ * uniform over the stored keys' index range and half of them are moved off the stored keys by one.
+ * Compared:
+ *  - std::lower_bound and Lower_Bound (branchless, prefetching) on the sorted array
+ *  - EytzingerIndex
+ *  - LearnedIndex with a data level error of 16, 64 and 256 positions
+ * Every lookup result is checked against std::lower_bound, and so are lookups around key sets
+ * with duplicates and gaps of nearly 2^64.
+ *
+ * Usage:
+ * ./bench_learned_index --sizes=1e6,1e8 --queries=4M --distributions=uniform,lognormal
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "searching/binary_search.h"
+#include "searching/learned_index.h"
+#include "searching/static_search_index.h"
+
+static bool g_allCorrect = true;
+
+static void Report(const std::string& distribution, std::size_t size, const std::string& method, double buildNs, std::size_t bytes,
+                   double lookupNs, std::size_t queryCount, const std::string& notes, bool correct)
+{
+    g_allCorrect &= correct;
+    std::printf("%-10s %11zu %-26s %10.1f %12.3f %10.2f  %s%s\n", distribution.c_str(), size, method.c_str(), buildNs / 1e6,
+                static_cast<double>(bytes) / (1 << 20), lookupNs / static_cast<double>(queryCount), notes.c_str(), correct ? "" : "  WRONG RESULT");
+}
+
+/*
+ * Dense and duplicated keys next to gaps of nearly 2^64, queried at the extremes and around every
+ * key: a segment's prediction deep inside such a gap exceeds any position
+ */
+static bool Check_Key_Gaps()
+{
+    std::vector<std::vector<std::int64_t>> keySets(3);
+    for(std::int64_t key = -100; key < 100; ++key)
+    {
+        keySets[0].insert(keySets[0].end(), 2, key);
+    }
+    for(std::int64_t key = 0; key < 200; ++key)
+    {
+        keySets[1].push_back(key - 200);
+        keySets[1].push_back(INT64_MAX - 199 + key);
+    }
+    keySets[2].assign(50, INT64_MIN);
+    keySets[2].insert(keySets[2].end(), 50, 7);
+    keySets[2].insert(keySets[2].end(), 50, INT64_MAX);
+    bool bCorrect = true;
+    for(std::vector<std::int64_t>& keys : keySets)
+    {
+        std::sort(keys.begin(), keys.end());
+        std::vector<std::int64_t> queries = {INT64_MIN, -1, 0, 1, INT64_MAX / 2, INT64_MAX - 6, INT64_MAX};
+        for(const std::int64_t key : keys)
+        {
+            queries.push_back(key);
+            queries.push_back(key == INT64_MIN ? key : key - 1);
+            queries.push_back(key == INT64_MAX ? key : key + 1);
+        }
+        auto check = [&]<std::size_t Epsilon>()
+        {
+            const LearnedIndex<std::int64_t, Epsilon> index{std::span<const std::int64_t>(keys)};
+            for(const std::int64_t query : queries)
+            {
+                bCorrect &= index.LowerBound(query) == static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), query) - keys.begin());
+            }
+        };
+        check.template operator()<16>();
+        check.template operator()<64>();
+        check.template operator()<256>();
+    }
+    return bCorrect;
+}
+
+static void Bench_Distribution(const std::string& distribution, std::size_t size, std::size_t queryCount, unsigned repetitions)
+{
+    const std::vector<std::int64_t> keys = Generate_Sorted_Keys(distribution, size, 60);
+    const std::span<const std::int64_t> view(keys);
+    std::vector<std::int64_t> queries(queryCount);
+    if(size > 0)
+    {
+        const std::vector<std::uint64_t> picks = Generate_Uniform<std::uint64_t>(queryCount, 61, 0, size - 1);
+        for(std::size_t i = 0; i < queryCount; ++i)
+        {
+            queries[i] = keys[picks[i]] + static_cast<std::int64_t>(picks[i] & 1);
+        }
+    }
+    std::vector<std::size_t> expected(queryCount);
+    for(std::size_t i = 0; i < queryCount; ++i)
+    {
+        expected[i] = static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), queries[i]) - keys.begin());
+    }
+
+    /* positionOf(query) must return the lower bound position */
+    auto run = [&](auto&& positionOf)
+    {
+        std::vector<std::size_t> positions(queryCount);
+        const double ns = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            for(std::size_t i = 0; i < queryCount; ++i)
+            {
+                positions[i] = positionOf(queries[i]);
+            }
+        });
+        return std::pair{ns, positions == expected};
+    };
+
+    auto [ns, correct] = run([&](std::int64_t query) { return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), query) - keys.begin()); });
+    Report(distribution, size, "std::lower_bound", 0, 0, ns, queryCount, "", correct);
+    std::tie(ns, correct) = run([&](std::int64_t query) { return static_cast<std::size_t>(Lower_Bound(keys.begin(), keys.end(), query) - keys.begin()); });
+    Report(distribution, size, "Lower_Bound (branchless)", 0, 0, ns, queryCount, "", correct);
+
+    {
+        Stopwatch stopwatch;
+        const EytzingerIndex<std::int64_t> index(view);
+        const double buildNs = stopwatch.ElapsedNs();
+        /* the Eytzinger index answers with the key; duplicates are resolved outside the timed loop */
+        std::vector<std::int64_t> found(queryCount);
+        const double lookupNs = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            for(std::size_t i = 0; i < queryCount; ++i)
+            {
+                const std::int64_t* key = index.LowerBound(queries[i]);
+                found[i] = key == nullptr ? INT64_MAX : *key;
+            }
+        });
+        bool bCorrect = true;
+        for(std::size_t i = 0; i < queryCount && bCorrect; ++i)
+        {
+            bCorrect = found[i] == (expected[i] == size ? INT64_MAX : keys[expected[i]]);
+        }
+        Report(distribution, size, "EytzingerIndex", buildNs, index.MemoryBytes(), lookupNs, queryCount, "", bCorrect);
+    }
+
+    auto runLearned = [&]<std::size_t Epsilon>()
+    {
+        Stopwatch stopwatch;
+        const LearnedIndex<std::int64_t, Epsilon> index(view);
+        const double buildNs = stopwatch.ElapsedNs();
+        const auto [lookupNs, bCorrect] = run([&](std::int64_t query) { return index.LowerBound(query); });
+        const std::string notes = std::to_string(index.Segments()) + " segments, " + std::to_string(index.Levels()) + " levels";
+        Report(distribution, size, "LearnedIndex<eps " + std::to_string(Epsilon) + ">", buildNs, index.MemoryBytes(), lookupNs, queryCount, notes, bCorrect);
+    };
+    runLearned.template operator()<16>();
+    runLearned.template operator()<64>();
+    runLearned.template operator()<256>();
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {1'000'000, 10'000'000, 50'000'000});
+    const std::vector<std::string> distributions = args.GetList("distributions", {"uniform", "lognormal", "clustered"});
+    const std::size_t queryCount = args.GetSizes("queries", {2'000'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-10s %11s %-26s %10s %12s %10s  %s\n", "data", "n", "method", "build ms", "index MB", "ns/lookup", "model");
+    Print_Separator(110);
+    for(const std::string& distribution : distributions)
+    {
+        for(std::size_t size : sizes)
+        {
+            Bench_Distribution(distribution, size, queryCount, repetitions);
+        }
+    }
+    Print_Separator(110);
+    const bool bGapsCorrect = Check_Key_Gaps();
+    g_allCorrect &= bGapsCorrect;
+    std::printf("LearnedIndex on duplicated keys and gaps near 2^64: %s\n", bGapsCorrect ? "ok" : "WRONG RESULT");
+    std::printf("index MB excludes the sorted keys themselves (8 bytes per key), the Eytzinger copy replaces them\n");
+    std::printf("%s\n", g_allCorrect ? "all lookups verified against std::lower_bound" : "LOOKUP VERIFICATION FAILED");
+    return g_allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,176 @@
+/*
+ * Linear search benchmark.
+ *
+ *  - kernels:   the scalar search() of C Program/Linear_Search.c, std::find / std::count /
+ *               std::min_element and Find_First / Count_Equal / Min_Index at every SIMD level
+ *               for int32, int64 and float (the searched value is absent, so the scans are full)
+ *  - crossover: lower bound on sorted int32 ranges of 4 ... 4096 keys with branchless binary
+ *               search, a pure Count_Less scan and Hybrid_Lower_Bound with 16 ... 256 key windows
+ * Every result is checked against the std algorithms.
+ *
+ * Usage:
+ * ./bench_linear_search --sizes=1K,1M --ranges=16,64,256,1024
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/cpu_features.h"
+#include "searching/binary_search.h"
+#include "searching/linear_search.h"
+
+static bool g_allCorrect = true;
+
+/* C Program/Linear_Search.c */
+template<class T>
+static std::size_t Linear_Search_Original(const T* arr, std::size_t n, T x)
+{
+    for(std::size_t i = 0; i < n; i++)
+    {
+        if(arr[i] == x)
+        {
+            return i;
+        }
+    }
+    return n;
+}
+
+static void Report_Kernel(const char* type, std::size_t size, const std::string& method, double ns, double baselineNs, bool correct)
+{
+    g_allCorrect &= correct;
+    std::printf("%-7s %10zu %-30s %10.3f %10.2f %9.2fx%s\n", type, size, method.c_str(), ns / static_cast<double>(size),
+                static_cast<double>(size) * sizeof(std::int32_t) / ns, baselineNs / ns, correct ? "" : "  WRONG RESULT");
+}
+
+template<class T>
+static void Bench_Kernels(const char* type, std::size_t size, unsigned repetitions)
+{
+    std::vector<T> data(size);
+    const std::vector<std::int32_t> values = Generate_Uniform<std::int32_t>(size, 59, -1'000'000, 1'000'000);
+    std::transform(values.begin(), values.end(), data.begin(), [](std::int32_t value) { return static_cast<T>(value); });
+    const T absent = static_cast<T>(2'000'000);
+    const std::span<const T> view(data);
+    /* enough calls per measurement to get above timer resolution */
+    const std::size_t calls = std::max<std::size_t>(1, (1u << 22) / std::max<std::size_t>(size, 1));
+    auto timed = [&](auto&& kernel)
+    {
+        std::size_t result = 0;
+        const double ns = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            for(std::size_t call = 0; call < calls; ++call)
+            {
+                result = kernel();
+                Do_Not_Optimize(result);
+            }
+        });
+        return std::pair{ns / static_cast<double>(calls), result};
+    };
+
+    const auto [findBaselineNs, originalResult] = timed([&] { return Linear_Search_Original(data.data(), size, absent); });
+    Report_Kernel(type, size, "search() (Linear_Search.c)", findBaselineNs, findBaselineNs, originalResult == size);
+    auto [ns, result] = timed([&] { return static_cast<std::size_t>(std::find(data.begin(), data.end(), absent) - data.begin()); });
+    Report_Kernel(type, size, "std::find", ns, findBaselineNs, result == size);
+    for(int level = 0; level <= static_cast<int>(Detect_Simd_Level()); ++level)
+    {
+        const ESimdLevel simdLevel = static_cast<ESimdLevel>(level);
+        std::tie(ns, result) = timed([&] { return Find_First(view, absent, simdLevel); });
+        Report_Kernel(type, size, std::string("Find_First (") + Simd_Level_Name(simdLevel) + ")", ns, findBaselineNs, result == size);
+    }
+
+    const T present = size == 0 ? absent : data[size / 2];
+    const std::size_t expectedCount = static_cast<std::size_t>(std::count(data.begin(), data.end(), present));
+    const auto [countBaselineNs, countResult] = timed([&] { return static_cast<std::size_t>(std::count(data.begin(), data.end(), present)); });
+    Report_Kernel(type, size, "std::count", countBaselineNs, countBaselineNs, countResult == expectedCount);
+    for(int level = 0; level <= static_cast<int>(Detect_Simd_Level()); ++level)
+    {
+        const ESimdLevel simdLevel = static_cast<ESimdLevel>(level);
+        std::tie(ns, result) = timed([&] { return Count_Equal(view, present, simdLevel); });
+        Report_Kernel(type, size, std::string("Count_Equal (") + Simd_Level_Name(simdLevel) + ")", ns, countBaselineNs, result == expectedCount);
+    }
+
+    const std::size_t expectedMin = static_cast<std::size_t>(std::min_element(data.begin(), data.end()) - data.begin());
+    const auto [minBaselineNs, minResult] = timed([&] { return static_cast<std::size_t>(std::min_element(data.begin(), data.end()) - data.begin()); });
+    Report_Kernel(type, size, "std::min_element", minBaselineNs, minBaselineNs, minResult == expectedMin);
+    for(int level = 0; level <= static_cast<int>(Detect_Simd_Level()); ++level)
+    {
+        const ESimdLevel simdLevel = static_cast<ESimdLevel>(level);
+        std::tie(ns, result) = timed([&] { return Min_Index(view, simdLevel); });
+        Report_Kernel(type, size, std::string("Min_Index (") + Simd_Level_Name(simdLevel) + ")", ns, minBaselineNs, result == expectedMin);
+    }
+}
+
+static void Bench_Crossover(std::size_t range, unsigned repetitions)
+{
+    std::vector<std::int32_t> sorted = Generate_Uniform<std::int32_t>(range, 60, 0, static_cast<std::int32_t>(4 * range));
+    std::sort(sorted.begin(), sorted.end());
+    const std::vector<std::int32_t> queries = Generate_Uniform<std::int32_t>(1 << 16, 61, -1, static_cast<std::int32_t>(4 * range + 1));
+    std::vector<std::size_t> expected(queries.size());
+    for(std::size_t i = 0; i < queries.size(); ++i)
+    {
+        expected[i] = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin());
+    }
+    const std::span<const std::int32_t> view(sorted);
+
+    double baselineNs = 0;
+    auto run = [&](const std::string& method, auto&& lowerBound)
+    {
+        std::vector<std::size_t> positions(queries.size());
+        const double ns = Best_Of_Ns(repetitions, [] {}, [&]
+        {
+            for(std::size_t i = 0; i < queries.size(); ++i)
+            {
+                positions[i] = lowerBound(queries[i]);
+            }
+        }) / static_cast<double>(queries.size());
+        baselineNs = baselineNs == 0 ? ns : baselineNs;
+        const bool correct = positions == expected;
+        g_allCorrect &= correct;
+        std::printf("%10zu %-34s %10.2f %9.2fx%s\n", range, method.c_str(), ns, baselineNs / ns, correct ? "" : "  WRONG RESULT");
+    };
+
+    run("Lower_Bound (binary)", [&](std::int32_t query) { return static_cast<std::size_t>(Lower_Bound<false>(view.begin(), view.end(), query) - view.begin()); });
+    run("Count_Less (linear)", [&](std::int32_t query) { return Count_Less(view, query); });
+    auto runHybrid = [&]<std::size_t Window>()
+    {
+        run("Hybrid_Lower_Bound<" + std::to_string(Window) + ">", [&](std::int32_t query) { return Hybrid_Lower_Bound<Window>(view, query); });
+    };
+    runHybrid.template operator()<16>();
+    runHybrid.template operator()<32>();
+    runHybrid.template operator()<64>();
+    runHybrid.template operator()<128>();
+    runHybrid.template operator()<256>();
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {64, 1'024, 16'384, 1'048'576, 16'777'216});
+    const std::vector<std::size_t> ranges = args.GetSizes("ranges", {4, 8, 16, 32, 64, 128, 256, 512, 1'024, 4'096});
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-7s %10s %-30s %10s %10s %10s\n", "type", "n", "method", "ns/elem", "GB/s*", "speedup");
+    Print_Separator(84);
+    for(std::size_t size : sizes)
+    {
+        Bench_Kernels<std::int32_t>("int32", size, repetitions);
+        Bench_Kernels<std::int64_t>("int64", size, repetitions);
+        Bench_Kernels<float>("float", size, repetitions);
+    }
+    std::printf("* GB/s counts 4 bytes per element for every type\n\n");
+
+    std::printf("%10s %-34s %10s %10s\n", "range", "lower bound method", "ns/query", "speedup");
+    Print_Separator(70);
+    for(std::size_t range : ranges)
+    {
+        Bench_Crossover(range, repetitions);
+    }
+    Print_Separator(70);
+    std::printf("%s\n", g_allCorrect ? "all searches verified against the std algorithms" : "SEARCH VERIFICATION FAILED");
+    return g_allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
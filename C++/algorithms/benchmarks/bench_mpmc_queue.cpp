@@ -0,0 +1,455 @@
+/*
+ * MPMC queue benchmark: --threads producers and as many consumers passing --items integers
+ * through a mutex + condition variable bounded std::deque, MpmcQueue with TryPush / TryPop and
+ * MpmcQueue with the blocking Push / Pop.
+ *
+ * Every producer sends its own increasing sequence; every consumer takes a fixed share of the
+ * items and checks that each producer's items reach it in increasing order, and in the end the
+ * count and the sum of everything received must match what was sent. Reported is millions of
+ * items per second through the queue, and the speedup over the mutex queue at the same count.
+ *
+ * Before that, a linearizability stress check: --histories rounds of three threads, each doing
+ * four random TryPush / TryPop calls on a queue created with capacity 1 and with 2 (both hold two
+ * elements, a single slot cannot tell full from empty), with every call's start and end
+ * stamped from one global counter; a quarter of the calls yield after their start stamp so that
+ * intervals overlap even without parallel hardware. Each history, failed (full / empty) calls
+ * included, must have a linearization, found by Wing and Gong's search against a sequential
+ * bounded queue. A sequential fill and drain of both queues checks the capacity and the order.
+ *
+ * Usage:
+ * ./bench_mpmc_queue --threads=1,2,4,8,16,32 --items=4M --capacity=1024 --histories=20000
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "containers/mpmc_queue.h"
+
+/* Producer index above this bit of an item, sequence number below */
+constexpr unsigned kProducerShift = 40;
+
+/* Threads and calls per thread in one linearizability history */
+constexpr std::size_t kHistoryThreads = 3;
+constexpr std::size_t kHistoryCalls = 4;
+
+/*
+ * One call in a history
+ */
+struct Operation
+{
+    bool bPush = false;
+    bool bSucceeded = false;
+    std::uint64_t value = 0;
+    std::uint64_t start = 0;
+    std::uint64_t end = 0;
+};
+
+/* Wing and Gong: try every call that no other pending call precedes in real time as the next one */
+static bool Linearize(const std::vector<Operation>& operations, std::vector<bool>& done, std::deque<std::uint64_t>& model, std::size_t capacity,
+                      std::size_t remaining)
+{
+    if(remaining == 0)
+    {
+        return true;
+    }
+    for(std::size_t i = 0; i < operations.size(); ++i)
+    {
+        if(done[i])
+        {
+            continue;
+        }
+        bool bMinimal = true;
+        for(std::size_t j = 0; j < operations.size() && bMinimal; ++j)
+        {
+            bMinimal = done[j] || operations[j].end > operations[i].start;
+        }
+        const Operation& operation = operations[i];
+        if(!bMinimal)
+        {
+            continue;
+        }
+        done[i] = true;
+        if(operation.bPush && operation.bSucceeded && model.size() < capacity)
+        {
+            model.push_back(operation.value);
+            if(Linearize(operations, done, model, capacity, remaining - 1))
+            {
+                return true;
+            }
+            model.pop_back();
+        }
+        else if(!operation.bSucceeded && model.size() == (operation.bPush ? capacity : 0))
+        {
+            if(Linearize(operations, done, model, capacity, remaining - 1))
+            {
+                return true;
+            }
+        }
+        else if(!operation.bPush && operation.bSucceeded && !model.empty() && model.front() == operation.value)
+        {
+            model.pop_front();
+            if(Linearize(operations, done, model, capacity, remaining - 1))
+            {
+                return true;
+            }
+            model.push_front(operation.value);
+        }
+        done[i] = false;
+    }
+    return false;
+}
+
+/*
+ * Outcome of the linearizability stress check
+ */
+struct HistoryCheck
+{
+    std::size_t histories = 0;
+    std::size_t overlapping = 0;
+    std::size_t failures = 0;
+};
+
+static HistoryCheck Check_Histories(std::size_t rounds, std::size_t requestedCapacity)
+{
+    const std::size_t capacity = MpmcQueue<std::uint64_t>(requestedCapacity).Capacity();
+    HistoryCheck check;
+    std::unique_ptr<MpmcQueue<std::uint64_t>> queue;
+    std::atomic<std::uint64_t> clock = 0;
+    std::vector<std::vector<Operation>> calls(kHistoryThreads, std::vector<Operation>(kHistoryCalls));
+    /* runs between rounds on one thread: judge the last history, then start from an empty queue */
+    auto betweenRounds = [&]() noexcept
+    {
+        if(queue)
+        {
+            std::vector<Operation> history;
+            for(const std::vector<Operation>& thread : calls)
+            {
+                history.insert(history.end(), thread.begin(), thread.end());
+            }
+            bool bOverlap = false;
+            for(std::size_t i = 0; i < history.size(); ++i)
+            {
+                for(std::size_t j = 0; j < history.size(); ++j)
+                {
+                    bOverlap |= i / kHistoryCalls != j / kHistoryCalls && history[i].start < history[j].end && history[j].start < history[i].end;
+                }
+            }
+            std::vector<bool> done(history.size(), false);
+            std::deque<std::uint64_t> model;
+            ++check.histories;
+            check.overlapping += bOverlap;
+            check.failures += !Linearize(history, done, model, capacity, history.size());
+        }
+        queue = std::make_unique<MpmcQueue<std::uint64_t>>(requestedCapacity);
+    };
+    std::barrier barrier(static_cast<std::ptrdiff_t>(kHistoryThreads), betweenRounds);
+    {
+        std::vector<std::jthread> threads;
+        for(std::size_t thread = 0; thread < kHistoryThreads; ++thread)
+        {
+            threads.emplace_back([&, thread]
+            {
+                std::mt19937_64 generator(72 + thread);
+                for(std::size_t round = 0; round <= rounds; ++round)
+                {
+                    barrier.arrive_and_wait();
+                    if(round == rounds)
+                    {
+                        break;
+                    }
+                    for(std::size_t call = 0; call < kHistoryCalls; ++call)
+                    {
+                        Operation& operation = calls[thread][call];
+                        operation.bPush = (generator() & 1) != 0;
+                        operation.value = (thread << 8) | call;
+                        operation.start = clock.fetch_add(1);
+                        if((generator() & 3) == 0)
+                        {
+                            /* widens the call's interval so histories overlap even on one core */
+                            std::this_thread::yield();
+                        }
+                        operation.bSucceeded = operation.bPush ? queue->TryPush(operation.value) : queue->TryPop(operation.value);
+                        operation.end = clock.fetch_add(1);
+                    }
+                }
+            });
+        }
+    }
+    return check;
+}
+
+/* One thread fills the queue until TryPush fails, then drains it: Capacity() items, in order */
+static bool Check_Fill_And_Drain(std::size_t requestedCapacity)
+{
+    MpmcQueue<std::uint64_t> queue(requestedCapacity);
+    std::uint64_t pushed = 0;
+    /* bounded, a queue that never reports full would otherwise keep this loop going */
+    while(pushed <= queue.Capacity() && queue.TryPush(pushed))
+    {
+        ++pushed;
+    }
+    if(pushed != queue.Capacity() || queue.Size() != pushed || queue.Capacity() < std::max<std::size_t>(requestedCapacity, 2))
+    {
+        return false;
+    }
+    bool bCorrect = true;
+    std::uint64_t value = 0;
+    for(std::uint64_t expected = 0; expected < pushed; ++expected)
+    {
+        bCorrect &= queue.TryPop(value) && value == expected;
+    }
+    return bCorrect && !queue.TryPop(value) && queue.Size() == 0;
+}
+
+/*
+ * What one consumer received
+ */
+struct alignas(64) Tally
+{
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    bool bOrdered = true;
+};
+
+/* Starts all threads together and times until the last one is done; consume(c, quota, tally) */
+template<class Produce, class Consume>
+static double Run_Team(std::size_t producers, std::size_t consumers, std::uint64_t perProducer, std::vector<Tally>& tallies, Produce&& produce,
+                       Consume&& consume)
+{
+    const std::uint64_t total = perProducer * producers;
+    tallies.assign(consumers, Tally{});
+    std::atomic<std::size_t> ready = 0;
+    auto start = [&]
+    {
+        ready.fetch_add(1);
+        while(ready.load() < producers + consumers)
+        {
+            std::this_thread::yield();
+        }
+    };
+    Stopwatch stopwatch;
+    {
+        std::vector<std::jthread> threads;
+        for(std::size_t consumer = 0; consumer < consumers; ++consumer)
+        {
+            const std::uint64_t quota = total / consumers + (consumer < total % consumers ? 1 : 0);
+            threads.emplace_back([&, consumer, quota]
+            {
+                start();
+                consume(quota, tallies[consumer]);
+            });
+        }
+        for(std::size_t producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&, producer]
+            {
+                start();
+                produce(static_cast<std::uint64_t>(producer) << kProducerShift, perProducer);
+            });
+        }
+        while(ready.load() < producers + consumers)
+        {
+            std::this_thread::yield();
+        }
+        stopwatch.Restart();
+    }
+    return stopwatch.ElapsedNs();
+}
+
+/* Record one item; `last` holds the next expected minimum sequence per producer */
+static void Receive(std::uint64_t item, std::vector<std::uint64_t>& last, Tally& tally)
+{
+    const std::uint64_t producer = item >> kProducerShift;
+    const std::uint64_t sequence = item & ((std::uint64_t{1} << kProducerShift) - 1);
+    tally.bOrdered &= producer < last.size() && sequence >= last[producer];
+    if(producer < last.size())
+    {
+        last[producer] = sequence + 1;
+    }
+    ++tally.count;
+    tally.sum += item;
+}
+
+/*
+ * Bounded blocking queue as usually written
+ */
+class MutexQueue
+{
+public:
+    explicit MutexQueue(std::size_t capacity) : m_capacity(capacity) {}
+
+    void Push(std::uint64_t value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [&] { return m_items.size() < m_capacity; });
+        m_items.push_back(value);
+        lock.unlock();
+        m_notEmpty.notify_one();
+    }
+
+    std::uint64_t Pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [&] { return !m_items.empty(); });
+        const std::uint64_t value = m_items.front();
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return value;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<std::uint64_t> m_items;
+    std::size_t m_capacity;
+};
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> threadCounts = args.GetSizes("threads", {1, 2, 4, 8, 16, 32});
+    const std::uint64_t items = args.GetSizes("items", {4'000'000}).front();
+    const std::size_t capacity = args.GetSizes("capacity", {1024}).front();
+    const std::size_t rounds = args.GetSizes("histories", {20'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 1);
+
+    bool allCorrect = true;
+    for(const std::size_t historyCapacity : {std::size_t{1}, std::size_t{2}})
+    {
+        const bool bFilled = Check_Fill_And_Drain(historyCapacity);
+        /* a queue that fails the fill can spin forever in TryPop */
+        const HistoryCheck check = bFilled ? Check_Histories(rounds, historyCapacity) : HistoryCheck{};
+        std::printf("capacity %zu: fill and drain %s; linearizability: %zu histories of %zu threads x %zu TryPush / TryPop, %zu with overlapping calls, "
+                    "%zu not linearizable\n",
+                    historyCapacity, bFilled ? "ok" : "WRONG", check.histories, kHistoryThreads, kHistoryCalls, check.overlapping, check.failures);
+        allCorrect &= bFilled && check.failures == 0;
+    }
+
+    std::printf("%-12s %-36s %10s %12s %9s\n", "producers", "queue", "ms", "Mitems/s", "speedup");
+    Print_Separator(83);
+    for(std::size_t threads : threadCounts)
+    {
+        threads = std::max<std::size_t>(threads, 1);
+        const std::uint64_t perProducer = std::max<std::uint64_t>(items / threads, 1);
+        std::uint64_t expectedSum = 0;
+        for(std::uint64_t producer = 0; producer < threads; ++producer)
+        {
+            expectedSum += (producer << kProducerShift) * perProducer + perProducer * (perProducer - 1) / 2;
+        }
+
+        double baselineNs = 0;
+        auto report = [&](const char* method, auto&& makeRun)
+        {
+            double best = 0;
+            bool bCorrect = true;
+            for(unsigned rep = 0; rep < std::max(repetitions, 1u); ++rep)
+            {
+                std::vector<Tally> tallies;
+                const double ns = makeRun(tallies);
+                std::uint64_t count = 0;
+                std::uint64_t sum = 0;
+                for(const Tally& tally : tallies)
+                {
+                    count += tally.count;
+                    sum += tally.sum;
+                    bCorrect &= tally.bOrdered;
+                }
+                bCorrect &= count == perProducer * threads && sum == expectedSum;
+                best = best == 0 ? ns : std::min(best, ns);
+            }
+            allCorrect &= bCorrect;
+            baselineNs = baselineNs == 0 ? best : baselineNs;
+            std::printf("%5zu + %-4zu %-36s %10.1f %12.2f %8.2fx%s\n", threads, threads, method, best / 1e6,
+                        static_cast<double>(perProducer * threads) / best * 1e3, baselineNs / best, bCorrect ? "" : "  WRONG RESULT");
+        };
+
+        report("std::mutex + condition_variable", [&](std::vector<Tally>& tallies)
+        {
+            MutexQueue queue(capacity);
+            return Run_Team(threads, threads, perProducer, tallies, [&](std::uint64_t base, std::uint64_t count)
+            {
+                for(std::uint64_t sequence = 0; sequence < count; ++sequence)
+                {
+                    queue.Push(base | sequence);
+                }
+            }, [&](std::uint64_t quota, Tally& tally)
+            {
+                std::vector<std::uint64_t> last(threads, 0);
+                for(std::uint64_t i = 0; i < quota; ++i)
+                {
+                    Receive(queue.Pop(), last, tally);
+                }
+            });
+        });
+
+        report("MpmcQueue TryPush / TryPop", [&](std::vector<Tally>& tallies)
+        {
+            MpmcQueue<std::uint64_t> queue(capacity);
+            return Run_Team(threads, threads, perProducer, tallies, [&](std::uint64_t base, std::uint64_t count)
+            {
+                for(std::uint64_t sequence = 0; sequence < count;)
+                {
+                    if(queue.TryPush(base | sequence))
+                    {
+                        ++sequence;
+                        continue;
+                    }
+                    std::this_thread::yield();
+                }
+            }, [&](std::uint64_t quota, Tally& tally)
+            {
+                std::vector<std::uint64_t> last(threads, 0);
+                std::uint64_t item = 0;
+                for(std::uint64_t i = 0; i < quota;)
+                {
+                    if(queue.TryPop(item))
+                    {
+                        Receive(item, last, tally);
+                        ++i;
+                        continue;
+                    }
+                    std::this_thread::yield();
+                }
+            });
+        });
+
+        report("MpmcQueue Push / Pop (blocking)", [&](std::vector<Tally>& tallies)
+        {
+            MpmcQueue<std::uint64_t> queue(capacity);
+            return Run_Team(threads, threads, perProducer, tallies, [&](std::uint64_t base, std::uint64_t count)
+            {
+                for(std::uint64_t sequence = 0; sequence < count; ++sequence)
+                {
+                    queue.Push(base | sequence);
+                }
+            }, [&](std::uint64_t quota, Tally& tally)
+            {
+                std::vector<std::uint64_t> last(threads, 0);
+                for(std::uint64_t i = 0; i < quota; ++i)
+                {
+                    Receive(queue.Pop(), last, tally);
+                }
+            });
+        });
+    }
+    Print_Separator(83);
+    std::printf("%u hardware threads\n", Default_Thread_Count());
+    std::printf("%s\n", allCorrect ? "every history linearizable, every item received once and in per producer order" : "MPMC QUEUE VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
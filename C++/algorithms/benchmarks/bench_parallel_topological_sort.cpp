@@ -0,0 +1,204 @@
+/*
+ * Parallel topological scheduling benchmark: level synchronous Kahn and the work stealing task
+ * graph executor against sorting once and running the tasks one after another.
+ *
+ * The DAGs have --vertices vertices in layers of --widths vertices (width 1 is a chain). Every
+ * vertex outside the first layer gets --degree random predecessors in the layer before it, so
+ * its level is exactly its layer. Vertex ids are a random permutation.
+ *  - levels: TopologicalSorter::Kahn (serial) against Topological_Levels; every vertex must land
+ *    in the level of its layer
+ *  - tasks: every vertex runs a task of --work xorshift rounds that first checks that all of its
+ *    predecessors have finished. Serial is Kahn followed by the tasks in order, parallel is
+ *    Run_Task_Graph, which starts a task as soon as its last predecessor is done.
+ * Finally one back edge is added: the levels must report a real cycle and the executor must
+ * stop short.
+ *
+ * Speedup needs cores: pass --threads up to the machine's core count.
+ *
+ * Usage:
+ * ./bench_parallel_topological_sort --vertices=1M --widths=1,16,256,4096,65536 --threads=1,4,8 --work=1000
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/graph_benchmark_utils.h"
+#include "common/parallel.h"
+#include "common/work_stealing.h"
+#include "graph/csr_graph.h"
+#include "graph/parallel_topological_sort.h"
+#include "graph/topological_sort.h"
+
+/* The synthetic task: `rounds` dependent xorshift steps */
+static std::uint64_t Spin(std::uint64_t state, const unsigned rounds)
+{
+    state |= 1;
+    for(unsigned i = 0; i < rounds; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+    }
+    return state;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::size_t vertexCount = std::max<std::size_t>(args.GetSizes("vertices", {1'000'000}).front(), 2);
+    const std::vector<std::size_t> widths = args.GetSizes("widths", {1, 16, 256, 4096, 65536});
+    std::vector<std::size_t> threadCounts = args.GetSizes("threads", {1, Default_Thread_Count()});
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    const std::size_t degree = std::max<std::size_t>(args.GetSizes("degree", {4}).front(), 1);
+    const unsigned work = args.GetUnsigned("work", 1000);
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%8s %9s %-36s %8s %10s %9s %10s\n", "width", "levels", "method", "threads", "ms", "speedup", "steals");
+    Print_Separator(96);
+
+    bool allCorrect = true;
+    for(std::size_t width : widths)
+    {
+        width = std::clamp<std::size_t>(width, 1, vertexCount);
+        std::vector<VertexId> vertexAt(vertexCount);
+        std::iota(vertexAt.begin(), vertexAt.end(), VertexId{0});
+        std::mt19937_64 generator(64);
+        std::shuffle(vertexAt.begin(), vertexAt.end(), generator);
+        std::vector<std::size_t> layerOf(vertexCount);
+        std::vector<Edge> edges;
+        edges.reserve(vertexCount * degree);
+        for(std::size_t rank = 0; rank < vertexCount; ++rank)
+        {
+            const std::size_t layer = rank / width;
+            layerOf[vertexAt[rank]] = layer;
+            if(layer == 0)
+            {
+                continue;
+            }
+            std::uniform_int_distribution<std::size_t> pick((layer - 1) * width, layer * width - 1);
+            for(std::size_t i = 0; i < degree; ++i)
+            {
+                edges.push_back({vertexAt[pick(generator)], vertexAt[rank]});
+            }
+        }
+        const std::size_t layers = (vertexCount + width - 1) / width;
+        const CsrGraph<> graph = CsrGraph<>::From_Edges(vertexCount, edges);
+        std::vector<Edge> reversedEdges(edges.size());
+        std::transform(edges.begin(), edges.end(), reversedEdges.begin(), [](const Edge& edge) { return Edge{edge.target, edge.source}; });
+        const CsrGraph<> predecessors = CsrGraph<>::From_Edges(vertexCount, reversedEdges);
+        reversedEdges = {};
+
+        double baselineNs = 0;
+        auto report = [&](const char* method, std::size_t threads, double ns, std::uint64_t steals, bool correct)
+        {
+            allCorrect &= correct;
+            baselineNs = baselineNs == 0 ? ns : baselineNs;
+            std::printf("%8zu %9zu %-36s %8zu %10.2f %8.2fx %10llu%s\n", width, layers, method, threads, ns / 1e6, baselineNs / ns,
+                        static_cast<unsigned long long>(steals), correct ? "" : "  WRONG RESULT");
+        };
+
+        /* levels */
+        TopologicalSorter sorter;
+        std::vector<VertexId> order;
+        bool bSorted = true;
+        double ns = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Kahn(graph, order); });
+        report("TopologicalSorter::Kahn (serial)", 1, ns, 0, bSorted);
+        for(std::size_t threads : threadCounts)
+        {
+            TopologicalLevels levels;
+            ns = Best_Of_Ns(repetitions, [] {}, [&] { levels = Topological_Levels(graph, static_cast<unsigned>(threads)); });
+            bool correct = !levels.HasCycle() && levels.order.size() == vertexCount && levels.LevelCount() == layers;
+            for(std::size_t level = 0; correct && level < levels.LevelCount(); ++level)
+            {
+                for(VertexId vertex : levels.Level(level))
+                {
+                    correct &= layerOf[vertex] == level;
+                }
+            }
+            report("Topological_Levels", threads, ns, 0, correct);
+        }
+
+        /* tasks: a task fails the check when a predecessor has not finished yet */
+        std::vector<std::uint64_t> result(vertexCount);
+        std::vector<std::uint8_t> done(vertexCount);
+        std::atomic<bool> bOutOfOrder = false;
+        auto task = [&](VertexId vertex)
+        {
+            for(VertexId predecessor : predecessors.Neighbors(vertex))
+            {
+                if(std::atomic_ref<std::uint8_t>(done[predecessor]).load(std::memory_order_relaxed) == 0)
+                {
+                    bOutOfOrder.store(true, std::memory_order_relaxed);
+                }
+            }
+            result[vertex] = Spin(vertex, work);
+            std::atomic_ref<std::uint8_t>(done[vertex]).store(1, std::memory_order_relaxed);
+        };
+        auto reset = [&]
+        {
+            std::fill(done.begin(), done.end(), 0);
+            bOutOfOrder = false;
+        };
+        const std::size_t checksum = [&]
+        {
+            std::uint64_t sum = 0;
+            for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                sum += Spin(vertex, work);
+            }
+            return sum;
+        }();
+        auto tasksCorrect = [&]
+        {
+            return !bOutOfOrder && std::accumulate(result.begin(), result.end(), std::uint64_t{0}) == checksum &&
+                   std::all_of(done.begin(), done.end(), [](std::uint8_t flag) { return flag == 1; });
+        };
+
+        baselineNs = 0;
+        ns = Best_Of_Ns(repetitions, reset, [&]
+        {
+            sorter.Kahn(graph, order);
+            for(VertexId vertex : order)
+            {
+                task(vertex);
+            }
+        });
+        report("Kahn, then tasks in order (serial)", 1, ns, 0, tasksCorrect());
+        for(std::size_t threads : threadCounts)
+        {
+            WorkStealingPool<VertexId> pool(static_cast<unsigned>(threads));
+            std::size_t ran = 0;
+            ns = Best_Of_Ns(repetitions, reset, [&] { ran = Run_Task_Graph(graph, pool, task); });
+            report("Run_Task_Graph (work stealing)", threads, ns, pool.Steals(), ran == vertexCount && tasksCorrect());
+        }
+
+        /* close a cycle from a vertex of the last layer back to one of its ancestors in the first */
+        VertexId ancestor = order.back();
+        while(predecessors.OutDegree(ancestor) > 0)
+        {
+            ancestor = predecessors.Neighbors(ancestor).front();
+        }
+        edges.push_back({order.back(), ancestor});
+        const CsrGraph<> cyclic = CsrGraph<>::From_Edges(vertexCount, edges);
+        const TopologicalLevels levels = Topological_Levels(cyclic, static_cast<unsigned>(threadCounts.back()));
+        WorkStealingPool<VertexId> pool(static_cast<unsigned>(threadCounts.back()));
+        reset();
+        const std::size_t ran = Run_Task_Graph(cyclic, pool, task);
+        const bool cycleCorrect = levels.HasCycle() && Is_Cycle(cyclic, levels.cycle) && levels.order.size() < vertexCount &&
+                                  ran < vertexCount && !bOutOfOrder;
+        allCorrect &= cycleCorrect;
+        std::printf("%8zu %9zu %-36s %8zu %10s %9s %10s%s\n", width, layers, "plus a back edge: cycle reported", threadCounts.back(), "", "", "",
+                    cycleCorrect ? "" : "  WRONG RESULT");
+    }
+    Print_Separator(96);
+    std::printf("%s\n", allCorrect ? "all levels, task orders and cycles verified" : "PARALLEL TOPOLOGICAL SORT VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+/*
+ * Partial sort / top-k benchmark against full sorts.
+ *
+ * For every n and k in {10, 1000, 1% of n} the k smallest int32 values are computed with:
+ *  - full sorts: std::sort and the repository's Heap_Sort / Quick_Sort_Lomuto
+ *  - std::partial_sort and std::nth_element + sort of the prefix
+ *  - Partial_Sort_Smallest (Intro_Select + sort of the prefix)
+ *  - StreamingTopK (bounded heap, one value at a time)
+ *  - Top_K_Smallest at every SIMD level the CPU supports
+ * Every result is checked against the prefix of the fully sorted input.
+ *
+ * Usage:
+ * ./bench_selection --sizes=1e6,1e7,1e8 --ks=10,1000 --dists=random,zipf
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/cpu_features.h"
+#include "sorting/classic_sorts.h"
+#include "sorting/selection.h"
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {1'000'000, 10'000'000});
+    const std::vector<std::string> distributionNames = args.GetList("dists", {"random", "sorted", "few-unique", "zipf"});
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-11s %10s %8s %-30s %12s %12s\n", "dist", "n", "k", "method", "ms", "vs std::sort");
+    Print_Separator(90);
+
+    bool allCorrect = true;
+    for(const std::string& distributionName : distributionNames)
+    {
+        const EDistribution distribution = Parse_Distribution(distributionName);
+        if(distribution == EDistribution::AutoCount)
+        {
+            std::printf("unknown distribution '%s'\n", distributionName.c_str());
+            return EXIT_FAILURE;
+        }
+        for(std::size_t size : sizes)
+        {
+            const std::vector<std::int32_t> input = Generate_Distribution(distribution, size, 54);
+            std::vector<std::int32_t> sorted = input;
+            std::vector<std::int32_t> work;
+            const auto reset = [&] { work = input; };
+
+            const double sortNs = Best_Of_Ns(repetitions, reset, [&] { std::sort(work.begin(), work.end()); });
+            sorted = work;
+
+            std::vector<std::size_t> ks = args.GetSizes("ks", {10, 1000, std::max<std::size_t>(size / 100, 1)});
+            for(std::size_t& k : ks)
+            {
+                k = std::min(k, size);
+            }
+            std::sort(ks.begin(), ks.end());
+            ks.erase(std::unique(ks.begin(), ks.end()), ks.end());
+            for(std::size_t k : ks)
+            {
+                auto report = [&](const char* method, double ns, std::span<const std::int32_t> result)
+                {
+                    const bool correct = result.size() == k && std::equal(result.begin(), result.end(), sorted.begin());
+                    allCorrect &= correct;
+                    std::printf("%-11s %10zu %8zu %-30s %12.2f %11.2fx%s\n", distributionName.c_str(), size, k, method,
+                                ns / 1e6, sortNs / ns, correct ? "" : "  WRONG RESULT");
+                };
+                auto prefix = [&] { return std::span<const std::int32_t>(work.data(), k); };
+
+                report("std::sort (full)", sortNs, std::span<const std::int32_t>(sorted.data(), k));
+
+                double ns = Best_Of_Ns(repetitions, reset, [&] { Heap_Sort(std::span(work)); });
+                report("Heap_Sort (full, heap.cpp)", ns, prefix());
+
+                if(distribution == EDistribution::Random)
+                {
+                    ns = Best_Of_Ns(repetitions, reset, [&] { Quick_Sort_Lomuto(std::span(work)); });
+                    report("Quick_Sort_Lomuto (full)", ns, prefix());
+                }
+
+                ns = Best_Of_Ns(repetitions, reset, [&] { std::partial_sort(work.begin(), work.begin() + static_cast<std::ptrdiff_t>(k), work.end()); });
+                report("std::partial_sort", ns, prefix());
+
+                ns = Best_Of_Ns(repetitions, reset, [&]
+                {
+                    std::nth_element(work.begin(), work.begin() + static_cast<std::ptrdiff_t>(k - 1), work.end());
+                    std::sort(work.begin(), work.begin() + static_cast<std::ptrdiff_t>(k));
+                });
+                report("std::nth_element + sort", ns, prefix());
+
+                ns = Best_Of_Ns(repetitions, reset, [&] { Partial_Sort_Smallest(std::span(work), k); });
+                report("Partial_Sort_Smallest", ns, prefix());
+
+                std::vector<std::int32_t> result;
+                ns = Best_Of_Ns(repetitions, [] {}, [&]
+                {
+                    StreamingTopK<std::int32_t> topK(k);
+                    topK.PushRange(input);
+                    result = topK.SortedResult();
+                });
+                report("StreamingTopK", ns, result);
+
+                for(int level = 0; level <= static_cast<int>(Detect_Simd_Level()); ++level)
+                {
+                    const ESimdLevel simdLevel = static_cast<ESimdLevel>(level);
+                    ns = Best_Of_Ns(repetitions, [] {}, [&] { result = Top_K_Smallest(std::span(input), k, simdLevel); });
+                    const std::string method = std::string("Top_K_Smallest (") + Simd_Level_Name(simdLevel) + ")";
+                    report(method.c_str(), ns, result);
+                }
+            }
+        }
+    }
+    Print_Separator(90);
+    std::printf("%s\n", allCorrect ? "all selections verified against std::sort" : "SELECTION VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
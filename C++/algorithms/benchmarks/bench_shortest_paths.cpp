@@ -0,0 +1,263 @@
+/*
+ * Shortest path benchmark: textbook std::priority_queue Dijkstra against Dijkstra with a radix
+ * heap and a 4-ary heap, parallel Delta_Stepping and, on a DAG, Dag_Shortest_Paths.
+ *
+ * Every --vertices entry gives three graphs, weights uniform integers in [1, --max-weight]:
+ *  - road:   a square grid with edges both ways, ids row by row (large diameter, degree 4)
+ *  - random: --degree random out-edges per vertex (small diameter)
+ *  - dag:    the random graph with every edge oriented from the lower to the higher id, a
+ *            stand-in for a task graph; Dag_Shortest_Paths runs over a TopologicalSorter order
+ *            (sorting not timed), and Dag_Longest_Paths finds its critical path
+ * Times are per search, averaged over --sources random sources. Every distance must equal the
+ * textbook Dijkstra's, every parent must be the source of a tight edge, and the critical path
+ * must be a real path as long as the largest longest-path distance, which no edge can extend.
+ *
+ * Usage:
+ * ./bench_shortest_paths --vertices=1M,4M --degree=8 --max-weight=1000 --sources=4 --threads=1,8
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "graph/csr_graph.h"
+#include "graph/shortest_paths.h"
+#include "graph/topological_sort.h"
+
+/* Dijkstra as usually written: a binary heap of (distance, vertex) with lazy deletion */
+static std::vector<float> Textbook_Dijkstra(const CsrGraph<>& graph, VertexId source)
+{
+    std::vector<float> distance(graph.VertexCount(), ShortestPaths<float>::kUnreached);
+    std::priority_queue<std::pair<float, VertexId>, std::vector<std::pair<float, VertexId>>, std::greater<>> queue;
+    distance[source] = 0;
+    queue.push({0.0f, source});
+    while(!queue.empty())
+    {
+        const auto [vertexDistance, vertex] = queue.top();
+        queue.pop();
+        if(vertexDistance > distance[vertex])
+        {
+            continue;
+        }
+        const std::span<const VertexId> neighbors = graph.Neighbors(vertex);
+        const std::span<const float> weights = graph.Weights(vertex);
+        for(std::size_t i = 0; i < neighbors.size(); ++i)
+        {
+            if(vertexDistance + weights[i] < distance[neighbors[i]])
+            {
+                distance[neighbors[i]] = vertexDistance + weights[i];
+                queue.push({distance[neighbors[i]], neighbors[i]});
+            }
+        }
+    }
+    return distance;
+}
+
+/* Some edge parent -> vertex is tight for every reached vertex but the source */
+static bool Is_Shortest_Path_Tree(const CsrGraph<>& graph, VertexId source, const ShortestPaths<float>& paths, std::span<const float> expected)
+{
+    if(!std::ranges::equal(paths.distance, expected) || paths.parent[source] != source)
+    {
+        return false;
+    }
+    for(VertexId vertex = 0; vertex < graph.VertexCount(); ++vertex)
+    {
+        if(vertex == source || paths.distance[vertex] == ShortestPaths<float>::kUnreached)
+        {
+            continue;
+        }
+        const VertexId parent = paths.parent[vertex];
+        if(parent == kNoParent)
+        {
+            return false;
+        }
+        const std::span<const VertexId> neighbors = graph.Neighbors(parent);
+        const std::span<const float> weights = graph.Weights(parent);
+        bool bTight = false;
+        for(std::size_t i = 0; i < neighbors.size() && !bTight; ++i)
+        {
+            bTight = neighbors[i] == vertex && paths.distance[parent] + weights[i] == paths.distance[vertex];
+        }
+        if(!bTight)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* No edge extends a longest path, and the critical path is a path of the maximum length */
+static bool Is_Critical_Path(const CsrGraph<>& graph, const ShortestPaths<float>& longest, std::span<const VertexId> path)
+{
+    for(VertexId vertex = 0; vertex < graph.VertexCount(); ++vertex)
+    {
+        const std::span<const VertexId> neighbors = graph.Neighbors(vertex);
+        const std::span<const float> weights = graph.Weights(vertex);
+        for(std::size_t i = 0; i < neighbors.size(); ++i)
+        {
+            if(longest.distance[vertex] + weights[i] > longest.distance[neighbors[i]])
+            {
+                return false;
+            }
+        }
+    }
+    if(path.empty())
+    {
+        return false;
+    }
+    float length = 0;
+    for(std::size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        const std::span<const VertexId> neighbors = graph.Neighbors(path[i]);
+        const auto found = std::find(neighbors.begin(), neighbors.end(), path[i + 1]);
+        if(found == neighbors.end())
+        {
+            return false;
+        }
+        length += graph.Weights(path[i])[static_cast<std::size_t>(found - neighbors.begin())];
+    }
+    return length == *std::ranges::max_element(longest.distance);
+}
+
+static CsrGraph<> Generate_Graph(const std::string& shape, std::size_t vertexCount, std::size_t degree, std::uint32_t maxWeight, std::uint64_t seed)
+{
+    std::vector<Edge> edges;
+    if(shape == "road")
+    {
+        const std::size_t side = static_cast<std::size_t>(std::sqrt(static_cast<double>(vertexCount)));
+        vertexCount = side * side;
+        for(std::size_t cell = 0; cell < vertexCount; ++cell)
+        {
+            const VertexId vertex = static_cast<VertexId>(cell);
+            if(cell % side + 1 < side)
+            {
+                edges.push_back({vertex, vertex + 1});
+                edges.push_back({vertex + 1, vertex});
+            }
+            if(cell + side < vertexCount)
+            {
+                edges.push_back({vertex, static_cast<VertexId>(cell + side)});
+                edges.push_back({static_cast<VertexId>(cell + side), vertex});
+            }
+        }
+    }
+    else
+    {
+        const std::vector<std::uint32_t> targets = Generate_Uniform<std::uint32_t>(vertexCount * degree, seed, 0, static_cast<std::uint32_t>(vertexCount - 1));
+        for(std::size_t i = 0; i < targets.size(); ++i)
+        {
+            Edge edge = {static_cast<VertexId>(i / degree), targets[i]};
+            if(shape == "dag")
+            {
+                edge = {std::min(edge.source, edge.target), std::max(edge.source, edge.target)};
+            }
+            if(edge.source != edge.target)
+            {
+                edges.push_back(edge);
+            }
+        }
+    }
+    const std::vector<std::uint32_t> raw = Generate_Uniform<std::uint32_t>(edges.size(), seed + 1, 1, maxWeight);
+    const std::vector<float> weights(raw.begin(), raw.end());
+    return CsrGraph<>::From_Edges(vertexCount, edges, weights);
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> vertexCounts = args.GetSizes("vertices", {1'000'000, 4'000'000});
+    const std::size_t degree = std::max<std::size_t>(args.GetSizes("degree", {8}).front(), 1);
+    const std::uint32_t maxWeight = static_cast<std::uint32_t>(std::max<std::size_t>(args.GetSizes("max-weight", {1000}).front(), 1));
+    const std::size_t sourceCount = std::max<std::size_t>(args.GetSizes("sources", {4}).front(), 1);
+    std::vector<std::size_t> threadCounts = args.GetSizes("threads", {1, Default_Thread_Count()});
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    std::printf("%-7s %10s %11s %-36s %8s %12s %9s\n", "graph", "V", "E", "method", "threads", "ms/search", "speedup");
+    Print_Separator(100);
+
+    bool allCorrect = true;
+    for(std::size_t vertexCount : vertexCounts)
+    {
+        for(const char* shape : {"road", "random", "dag"})
+        {
+            const CsrGraph<> graph = Generate_Graph(shape, std::max<std::size_t>(vertexCount, 4), degree, maxWeight, 70);
+            std::vector<VertexId> sources;
+            std::mt19937_64 generator(71);
+            /* sources early in the DAG's id order reach most of it */
+            std::uniform_int_distribution<VertexId> pick(0, static_cast<VertexId>((graph.VertexCount() - 1) / (std::string(shape) == "dag" ? 64 : 1)));
+            while(sources.size() < sourceCount)
+            {
+                sources.push_back(pick(generator));
+            }
+
+            std::vector<std::vector<float>> expected;
+            Stopwatch stopwatch;
+            for(VertexId source : sources)
+            {
+                expected.push_back(Textbook_Dijkstra(graph, source));
+            }
+            const double baselineNs = stopwatch.ElapsedNs();
+            auto report = [&](const std::string& method, std::size_t threads, double ns, bool correct)
+            {
+                allCorrect &= correct;
+                std::printf("%-7s %10zu %11zu %-36s %8zu %12.2f %8.2fx%s\n", shape, graph.VertexCount(), graph.EdgeCount(), method.c_str(), threads,
+                            ns / 1e6 / static_cast<double>(sourceCount), baselineNs / ns, correct ? "" : "  WRONG RESULT");
+            };
+            report("std::priority_queue Dijkstra", 1, baselineNs, true);
+
+            auto measure = [&](const std::string& method, std::size_t threads, auto&& search)
+            {
+                bool correct = true;
+                double ns = 0;
+                for(std::size_t i = 0; i < sources.size(); ++i)
+                {
+                    stopwatch.Restart();
+                    const ShortestPaths<float> paths = search(sources[i]);
+                    ns += stopwatch.ElapsedNs();
+                    correct &= Is_Shortest_Path_Tree(graph, sources[i], paths, expected[i]);
+                }
+                report(method, threads, ns, correct);
+            };
+            for(EDijkstraQueue queue : {EDijkstraQueue::RadixHeap, EDijkstraQueue::QuaternaryHeap})
+            {
+                measure(std::string("Dijkstra (") + Dijkstra_Queue_Name(queue) + ")", 1, [&](VertexId source) { return Dijkstra(graph, source, queue); });
+            }
+            for(std::size_t threads : threadCounts)
+            {
+                measure("Delta_Stepping", threads, [&](VertexId source) { return Delta_Stepping(graph, source, 0.0f, static_cast<unsigned>(threads)); });
+            }
+            if(std::string(shape) != "dag")
+            {
+                continue;
+            }
+
+            std::vector<VertexId> order;
+            TopologicalSorter().Dfs(graph, order);
+            measure("Dag_Shortest_Paths", 1, [&](VertexId source) { return Dag_Shortest_Paths(graph, order, source); });
+            stopwatch.Restart();
+            const ShortestPaths<float> longest = Dag_Longest_Paths(graph, order);
+            const std::vector<VertexId> criticalPath = Critical_Path(longest);
+            const double longestNs = stopwatch.ElapsedNs();
+            const bool bCritical = Is_Critical_Path(graph, longest, criticalPath);
+            allCorrect &= bCritical;
+            /* over all vertices at once, so not comparable to one search */
+            std::printf("%-7s %10zu %11zu Dag_Longest_Paths + Critical_Path: %.2f ms, %zu vertices, length %.0f%s\n", shape, graph.VertexCount(),
+                        graph.EdgeCount(), longestNs / 1e6, criticalPath.size(), *std::ranges::max_element(longest.distance),
+                        bCritical ? "" : "  WRONG RESULT");
+        }
+    }
+    Print_Separator(100);
+    std::printf("%s\n", allCorrect ? "all distances, parents and critical paths verified" : "SHORTEST PATH VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,138 @@
+/*
+ * Sorting benchmark over every sort of the repository (see sorting/classic_sorts.h) plus std::sort.
+ *
+ * For each size and distribution every sort is run on the same input:
+ *  - timed runs with the no-op probe, best of --reps, reported as ns/element
+ *  - one counting run for comparisons, swaps and element moves
+ *  - cache misses of one timed run through perf_event_open, "n/a" when the kernel refuses
+ *  - the output is compared with std::sort, the process fails on any mismatch
+ *
+ * Quadratic sorts (and quick sorts on presorted shapes) are skipped above --quadratic-limit.
+ *
+ * Usage:
+ * ./bench_sorting --sizes=1e3,1e5,1e6 --dists=random,sorted,reversed,few-unique,zipf
+ * ./bench_sorting --sorts=Merge_Sort,Heap_Sort --sizes=1e7 --reps=1
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/perf_counters.h"
+#include "sorting/classic_sorts.h"
+
+static bool Is_Selected(const std::vector<std::string>& selected, std::string_view name)
+{
+    return selected.empty() || std::find(selected.begin(), selected.end(), name) != selected.end();
+}
+
+static bool Is_Hopeless(const SortEntry& entry, EDistribution distribution, std::size_t size, std::size_t quadraticLimit)
+{
+    if(size <= quadraticLimit)
+    {
+        return false;
+    }
+    switch(entry.complexity)
+    {
+        case ESortComplexity::Quadratic:
+            return true;
+        case ESortComplexity::QuadraticOnPresorted:
+            return distribution != EDistribution::Random;
+        default:
+            return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {1'000, 10'000, 100'000, 1'000'000});
+    const std::vector<std::string> distributionNames = args.GetList("dists", {"random", "sorted", "reversed", "few-unique", "zipf"});
+    const std::vector<std::string> selectedSorts = args.GetList("sorts", {});
+    const std::size_t quadraticLimit = args.GetSizes("quadratic-limit", {20'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    PerfCounter cacheMisses(EPerfEvent::CacheMisses);
+    if(!cacheMisses.IsAvailable())
+    {
+        std::printf("perf_event_open unavailable, cache misses reported as n/a\n");
+    }
+
+    std::printf("%-18s %-11s %10s %10s %16s %14s %14s %14s\n",
+                "sort", "dist", "n", "ns/elem", "comparisons", "swaps", "moves", "cache-miss");
+    Print_Separator(114);
+
+    bool allCorrect = true;
+    for(const std::string& distributionName : distributionNames)
+    {
+        const EDistribution distribution = Parse_Distribution(distributionName);
+        if(distribution == EDistribution::AutoCount)
+        {
+            std::printf("unknown distribution '%s'\n", distributionName.c_str());
+            return EXIT_FAILURE;
+        }
+        for(std::size_t size : sizes)
+        {
+            const std::vector<int> input = Generate_Distribution(distribution, size, 52);
+            std::vector<int> expected = input;
+            std::vector<int> work;
+            const auto reset = [&] { work = input; };
+
+            /* Baseline, comparisons counted through the comparator */
+            std::uint64_t stdComparisons = 0;
+            std::sort(expected.begin(), expected.end(), [&](int left, int right) { ++stdComparisons; return left < right; });
+            if(Is_Selected(selectedSorts, "std::sort"))
+            {
+                const double ns = Best_Of_Ns(repetitions, reset, [&] { std::sort(work.begin(), work.end()); });
+                std::printf("%-18s %-11s %10zu %10.2f %16" PRIu64 " %14s %14s %14s\n", "std::sort", distributionName.c_str(),
+                            size, ns / static_cast<double>(std::max<std::size_t>(size, 1)), stdComparisons, "-", "-", "-");
+            }
+
+            for(const SortEntry& entry : Classic_Sorts())
+            {
+                if(!Is_Selected(selectedSorts, entry.name))
+                {
+                    continue;
+                }
+                if(Is_Hopeless(entry, distribution, size, quadraticLimit))
+                {
+                    std::printf("%-18.*s %-11s %10zu %10s   skipped: quadratic above --quadratic-limit\n",
+                                static_cast<int>(entry.name.size()), entry.name.data(), distributionName.c_str(), size, "-");
+                    continue;
+                }
+
+                const double ns = Best_Of_Ns(repetitions, reset, [&] { entry.sort(std::span(work)); });
+                const bool correct = work == expected;
+                allCorrect &= correct;
+
+                reset();
+                cacheMisses.Start();
+                entry.sort(std::span(work));
+                cacheMisses.Stop();
+
+                reset();
+                SortStats stats;
+                entry.countingSort(std::span(work), stats);
+                allCorrect &= work == expected;
+
+                char missText[32] = "n/a";
+                if(cacheMisses.IsAvailable())
+                {
+                    std::snprintf(missText, sizeof(missText), "%" PRIu64, cacheMisses.Read());
+                }
+                std::printf("%-18.*s %-11s %10zu %10.2f %16" PRIu64 " %14" PRIu64 " %14" PRIu64 " %14s%s\n",
+                            static_cast<int>(entry.name.size()), entry.name.data(), distributionName.c_str(), size,
+                            ns / static_cast<double>(std::max<std::size_t>(size, 1)),
+                            stats.comparisons, stats.swaps, stats.moves, missText, correct ? "" : "  WRONG ORDER");
+            }
+        }
+    }
+    Print_Separator(114);
+    std::printf("%s\n", allCorrect ? "all sorts verified against std::sort" : "SORT VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
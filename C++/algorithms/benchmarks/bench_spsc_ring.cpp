@@ -0,0 +1,392 @@
+/*
+ * SPSC ring benchmark: one producer thread and one consumer thread passing --items integers
+ * through a mutex guarded std::queue, SpscRing one element at a time, and SpscRing in batches.
+ *
+ * The producer sends 0, 1, 2, ...; the consumer checks that it receives exactly that sequence.
+ * Both queues hold at most --capacity elements, a side that finds the queue full or empty
+ * yields. The two threads are pinned to the first two entries of --cpus when those exist.
+ * Reported is millions of elements per second through the queue.
+ *
+ * A second table passes 64 byte packets at every --batches size: filled in a local array and
+ * copied through PushBulk / PopBulk, against built in place through ReserveWrite and checked in
+ * place through ReserveRead, on the heap and on a double mapped ring. The consumer checks every
+ * packet's sequence number and payload either way.
+ *
+ * Usage:
+ * ./bench_spsc_ring --items=20M --capacity=1024 --batch=64 --batches=1,4,16,64,256,1024 --cpus=0,1
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "containers/spsc_ring.h"
+
+/*
+ * Outcome of one producer / consumer run
+ */
+struct TransferRun
+{
+    double ns = 0;
+    bool bInOrder = true;
+    bool bPinned = true;
+};
+
+/*
+ * Packet sized element of the batch table
+ */
+struct Packet
+{
+    std::uint64_t sequence = 0;
+    std::uint64_t payload[7] = {};
+};
+static_assert(sizeof(Packet) == 64, "one cache line per packet");
+
+static void Fill_Packet(Packet& packet, std::uint64_t sequence) noexcept
+{
+    packet.sequence = sequence;
+    for(std::uint64_t i = 0; i < std::size(packet.payload); ++i)
+    {
+        packet.payload[i] = sequence * (i + 1);
+    }
+}
+
+static bool Check_Packet(const Packet& packet, std::uint64_t sequence) noexcept
+{
+    bool bValid = packet.sequence == sequence;
+    for(std::uint64_t i = 0; i < std::size(packet.payload); ++i)
+    {
+        bValid &= packet.payload[i] == sequence * (i + 1);
+    }
+    return bValid;
+}
+
+/* Start both sides together, pinned, and time until the consumer has seen every item */
+template<class Producer, class Consumer>
+static TransferRun Run_Pair(const std::vector<std::size_t>& cpus, Producer&& producer, Consumer&& consumer)
+{
+    TransferRun run;
+    std::atomic<int> ready = 0;
+    std::atomic<bool> pinned[2] = {true, true};
+    auto start = [&](int side)
+    {
+        pinned[side] = cpus.size() > static_cast<std::size_t>(side) && Pin_Current_Thread(static_cast<unsigned>(cpus[side]));
+        ready.fetch_add(1);
+        while(ready.load() < 2)
+        {
+            std::this_thread::yield();
+        }
+    };
+    Stopwatch stopwatch;
+    {
+        std::jthread consumerThread([&]
+        {
+            start(1);
+            run.bInOrder = consumer();
+        });
+        std::jthread producerThread([&]
+        {
+            start(0);
+            stopwatch.Restart();
+            producer();
+        });
+    }
+    run.ns = stopwatch.ElapsedNs();
+    run.bPinned = pinned[0] && pinned[1];
+    return run;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::uint64_t items = args.GetSizes("items", {20'000'000}).front();
+    const std::size_t capacity = args.GetSizes("capacity", {1024}).front();
+    const std::size_t batch = std::max<std::size_t>(args.GetSizes("batch", {64}).front(), 1);
+    const std::vector<std::size_t> batches = args.GetSizes("batches", {1, 4, 16, 64, 256, 1024});
+    const std::vector<std::size_t> cpus = args.GetSizes("cpus", {0, 1});
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-40s %10s %12s %9s\n", "queue", "ms", "Mitems/s", "speedup");
+    Print_Separator(76);
+
+    bool allCorrect = true;
+    bool allPinned = true;
+    double baselineNs = 0;
+    auto report = [&](const std::string& method, auto&& makeRun)
+    {
+        TransferRun best;
+        best.ns = 0;
+        for(unsigned rep = 0; rep < std::max(repetitions, 1u); ++rep)
+        {
+            const TransferRun run = makeRun();
+            allCorrect &= run.bInOrder;
+            allPinned &= run.bPinned;
+            best = best.ns == 0 || run.ns < best.ns ? run : best;
+        }
+        baselineNs = baselineNs == 0 ? best.ns : baselineNs;
+        std::printf("%-40s %10.1f %12.1f %8.2fx%s\n", method.c_str(), best.ns / 1e6, static_cast<double>(items) / best.ns * 1e3, baselineNs / best.ns,
+                    best.bInOrder ? "" : "  WRONG RESULT");
+    };
+
+    report("std::mutex + std::queue", [&]
+    {
+        std::mutex mutex;
+        std::queue<std::uint64_t> queue;
+        return Run_Pair(cpus, [&]
+        {
+            for(std::uint64_t value = 0; value < items;)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(queue.size() < capacity)
+                    {
+                        queue.push(value++);
+                        continue;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }, [&]
+        {
+            bool bInOrder = true;
+            for(std::uint64_t expected = 0; expected < items;)
+            {
+                std::uint64_t value = 0;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(!queue.empty())
+                    {
+                        value = queue.front();
+                        queue.pop();
+                        bInOrder &= value == expected++;
+                        continue;
+                    }
+                }
+                std::this_thread::yield();
+            }
+            return bInOrder;
+        });
+    });
+
+    report("SpscRing TryPush / TryPop", [&]
+    {
+        SpscRing<std::uint64_t> ring(capacity);
+        return Run_Pair(cpus, [&]
+        {
+            for(std::uint64_t value = 0; value < items;)
+            {
+                if(ring.TryPush(value))
+                {
+                    ++value;
+                    continue;
+                }
+                std::this_thread::yield();
+            }
+        }, [&]
+        {
+            bool bInOrder = true;
+            std::uint64_t value = 0;
+            for(std::uint64_t expected = 0; expected < items;)
+            {
+                if(ring.TryPop(value))
+                {
+                    bInOrder &= value == expected++;
+                    continue;
+                }
+                std::this_thread::yield();
+            }
+            return bInOrder;
+        });
+    });
+
+    report("SpscRing PushBulk / PopBulk, batch " + std::to_string(batch), [&]
+    {
+        SpscRing<std::uint64_t> ring(capacity);
+        return Run_Pair(cpus, [&]
+        {
+            std::vector<std::uint64_t> values(batch);
+            std::size_t sent = values.size();
+            for(std::uint64_t next = 0; next < items || sent < values.size();)
+            {
+                if(sent == values.size())
+                {
+                    values.resize(std::min<std::uint64_t>(batch, items - next));
+                    for(std::uint64_t& value : values)
+                    {
+                        value = next++;
+                    }
+                    sent = 0;
+                }
+                const std::size_t pushed = ring.PushBulk(std::span<const std::uint64_t>(values).subspan(sent));
+                sent += pushed;
+                if(pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }, [&]
+        {
+            bool bInOrder = true;
+            std::vector<std::uint64_t> values(batch);
+            for(std::uint64_t expected = 0; expected < items;)
+            {
+                const std::size_t popped = ring.PopBulk(values);
+                for(std::size_t i = 0; i < popped; ++i)
+                {
+                    bInOrder &= values[i] == expected++;
+                }
+                if(popped == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            return bInOrder;
+        });
+    });
+
+    Print_Separator(76);
+
+    std::printf("\n%-6s %-42s %10s %12s %9s\n", "batch", "64 byte packets", "ms", "Mpackets/s", "speedup");
+    Print_Separator(83);
+    std::vector<ERingBacking> backings = {ERingBacking::Heap};
+    try
+    {
+        SpscRing<Packet> probe(capacity, ERingBacking::DoubleMapped);
+        backings.push_back(ERingBacking::DoubleMapped);
+    }
+    catch(const std::runtime_error& error)
+    {
+        std::printf("note: %s, double mapped rows are skipped\n", error.what());
+    }
+    for(std::size_t packetBatch : batches)
+    {
+        packetBatch = std::max<std::size_t>(packetBatch, 1);
+        double copyNs = 0;
+        auto reportBatch = [&](const std::string& method, auto&& makeRun)
+        {
+            TransferRun best;
+            best.ns = 0;
+            for(unsigned rep = 0; rep < std::max(repetitions, 1u); ++rep)
+            {
+                const TransferRun run = makeRun();
+                allCorrect &= run.bInOrder;
+                allPinned &= run.bPinned;
+                best = best.ns == 0 || run.ns < best.ns ? run : best;
+            }
+            copyNs = copyNs == 0 ? best.ns : copyNs;
+            std::printf("%-6zu %-42s %10.1f %12.1f %8.2fx%s\n", packetBatch, method.c_str(), best.ns / 1e6, static_cast<double>(items) / best.ns * 1e3,
+                        copyNs / best.ns, best.bInOrder ? "" : "  WRONG RESULT");
+        };
+
+        reportBatch("PushBulk / PopBulk (copy)", [&]
+        {
+            SpscRing<Packet> ring(capacity);
+            return Run_Pair(cpus, [&]
+            {
+                std::vector<Packet> packets(packetBatch);
+                std::size_t sent = packets.size();
+                for(std::uint64_t next = 0; next < items || sent < packets.size();)
+                {
+                    if(sent == packets.size())
+                    {
+                        packets.resize(std::min<std::uint64_t>(packetBatch, items - next));
+                        for(Packet& packet : packets)
+                        {
+                            Fill_Packet(packet, next++);
+                        }
+                        sent = 0;
+                    }
+                    const std::size_t pushed = ring.PushBulk(std::span<const Packet>(packets).subspan(sent));
+                    sent += pushed;
+                    if(pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }, [&]
+            {
+                bool bInOrder = true;
+                std::vector<Packet> packets(packetBatch);
+                for(std::uint64_t expected = 0; expected < items;)
+                {
+                    const std::size_t popped = ring.PopBulk(packets);
+                    for(std::size_t i = 0; i < popped; ++i)
+                    {
+                        bInOrder &= Check_Packet(packets[i], expected++);
+                    }
+                    if(popped == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                return bInOrder;
+            });
+        });
+
+        for(ERingBacking backing : backings)
+        {
+            reportBatch(std::string("ReserveWrite / ReserveRead (") + Ring_Backing_Name(backing) + ")", [&]
+            {
+                SpscRing<Packet> ring(capacity, backing);
+                return Run_Pair(cpus, [&]
+                {
+                    for(std::uint64_t next = 0; next < items;)
+                    {
+                        const RingRegion<Packet> region = ring.ReserveWrite(std::min<std::uint64_t>(packetBatch, items - next));
+                        for(const std::span<Packet> run : {region.first, region.second})
+                        {
+                            for(Packet& packet : run)
+                            {
+                                Fill_Packet(packet, next++);
+                            }
+                        }
+                        ring.CommitWrite(region.Size());
+                        if(region.Empty())
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                }, [&]
+                {
+                    bool bInOrder = true;
+                    for(std::uint64_t expected = 0; expected < items;)
+                    {
+                        const RingRegion<Packet> region = ring.ReserveRead(packetBatch);
+                        for(const std::span<Packet> run : {region.first, region.second})
+                        {
+                            for(const Packet& packet : run)
+                            {
+                                bInOrder &= Check_Packet(packet, expected++);
+                            }
+                        }
+                        ring.CommitRead(region.Size());
+                        if(region.Empty())
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                    return bInOrder;
+                });
+            });
+        }
+    }
+    Print_Separator(83);
+    if(!allPinned)
+    {
+        std::printf("note: could not pin to CPUs of --cpus (%u hardware threads), threads were left to the scheduler\n", Default_Thread_Count());
+    }
+    std::printf("%s\n", allCorrect ? "every item arrived once and in order" : "SPSC RING VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+/*
+ * Static search index benchmark: build time, memory and lookup throughput.
+ *
+ * Keys are sorted int32 with random gaps of 0-3 (so duplicates occur), queries are uniform over
+ * the key range. Compared:
+ *  - std::lower_bound and Lower_Bound (branchless, prefetching) on the sorted array
+ *  - EytzingerIndex
+ *  - StaticSearchTree at every SIMD level the CPU supports
+ * Every lookup result is checked against std::lower_bound.
+ *
+ * Only one index is alive at a time next to the sorted keys, 1e9 keys need about 9 GB.
+ *
+ * Usage:
+ * ./bench_static_search_index --sizes=1e6,1e8,1e9 --queries=4M
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/cpu_features.h"
+#include "searching/binary_search.h"
+#include "searching/static_search_index.h"
+
+static bool g_allCorrect = true;
+
+static void Report(std::size_t size, const char* method, double buildNs, std::size_t bytes, double lookupNs, std::size_t queryCount, bool correct)
+{
+    g_allCorrect &= correct;
+    const double keyBytes = static_cast<double>(std::max<std::size_t>(size, 1) * sizeof(std::int32_t));
+    std::printf("%12zu %-28s %10.1f %10.1f %+9.1f%% %11.2f %10.2f%s\n", size, method, buildNs / 1e6,
+                static_cast<double>(bytes) / (1 << 20), 100.0 * (static_cast<double>(bytes) - keyBytes) / keyBytes,
+                static_cast<double>(queryCount) * 1e3 / lookupNs, lookupNs / static_cast<double>(queryCount), correct ? "" : "  WRONG RESULT");
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {10'000, 1'000'000, 10'000'000, 100'000'000});
+    const std::size_t queryCount = args.GetSizes("queries", {2'000'000}).front();
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%12s %-28s %10s %10s %10s %11s %10s\n", "n", "method", "build ms", "MB", "overhead", "Mlookups/s", "ns/lookup");
+    Print_Separator(98);
+
+    for(std::size_t size : sizes)
+    {
+        std::vector<std::int32_t> keys(size);
+        const std::vector<std::uint32_t> gaps = Generate_Uniform<std::uint32_t>(size, 57, 0, 3);
+        std::int64_t key = INT32_MIN;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            key = std::min<std::int64_t>(key + gaps[i], INT32_MAX);
+            keys[i] = static_cast<std::int32_t>(key);
+        }
+        const std::vector<std::int32_t> queries = Generate_Uniform<std::int32_t>(queryCount, 58, INT32_MIN, static_cast<std::int32_t>(key));
+        std::vector<std::size_t> expected(queryCount);
+        for(std::size_t i = 0; i < queryCount; ++i)
+        {
+            expected[i] = static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), queries[i]) - keys.begin());
+        }
+
+        auto measure = [&](auto&& lookup)
+        {
+            return Best_Of_Ns(repetitions, [] {}, [&]
+            {
+                std::int64_t checksum = 0;
+                for(std::int32_t query : queries)
+                {
+                    checksum += static_cast<std::int64_t>(lookup(query));
+                }
+                Do_Not_Optimize(checksum);
+            });
+        };
+        /* positionOf(query) must return the lower bound position */
+        auto verify = [&](auto&& positionOf)
+        {
+            for(std::size_t i = 0; i < queryCount; ++i)
+            {
+                if(positionOf(queries[i]) != expected[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto stdLowerBound = [&](std::int32_t query) { return static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), query) - keys.begin()); };
+        Report(size, "std::lower_bound", 0, size * sizeof(std::int32_t), measure(stdLowerBound), queryCount, verify(stdLowerBound));
+
+        auto branchless = [&](std::int32_t query) { return static_cast<std::size_t>(Lower_Bound(keys.begin(), keys.end(), query) - keys.begin()); };
+        Report(size, "Lower_Bound (branchless)", 0, size * sizeof(std::int32_t), measure(branchless), queryCount, verify(branchless));
+
+        {
+            Stopwatch stopwatch;
+            const EytzingerIndex<std::int32_t> index{std::span<const std::int32_t>(keys)};
+            const double buildNs = stopwatch.ElapsedNs();
+            const double ns = measure([&](std::int32_t query)
+            {
+                const std::int32_t* found = index.LowerBound(query);
+                return found == nullptr ? 0 : *found;
+            });
+            /* the Eytzinger index answers with the key, the first position of that key is the lower bound */
+            const bool correct = verify([&](std::int32_t query)
+            {
+                const std::int32_t* found = index.LowerBound(query);
+                return found == nullptr ? size : stdLowerBound(*found);
+            });
+            Report(size, "EytzingerIndex", buildNs, index.MemoryBytes(), ns, queryCount, correct);
+        }
+
+        for(int level = 0; level <= static_cast<int>(Detect_Simd_Level()); ++level)
+        {
+            const ESimdLevel simdLevel = static_cast<ESimdLevel>(level);
+            Stopwatch stopwatch;
+            const StaticSearchTree<std::int32_t> tree(std::span<const std::int32_t>(keys), simdLevel);
+            const double buildNs = stopwatch.ElapsedNs();
+            auto lookup = [&](std::int32_t query) { return tree.LowerBound(query); };
+            const std::string method = std::string("StaticSearchTree (") + Simd_Level_Name(simdLevel) + ")";
+            Report(size, method.c_str(), buildNs, tree.MemoryBytes(), measure(lookup), queryCount, verify(lookup));
+        }
+    }
+    Print_Separator(98);
+    std::printf("%s\n", g_allCorrect ? "all lookups verified against std::lower_bound" : "LOOKUP VERIFICATION FAILED");
+    return g_allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+/*
+ * String sorting benchmark: std::sort of std::string against the string_view based sorts.
+ *
+ * Inputs:
+ *  - random:  random lowercase strings of 4 to 32 characters
+ *  - symbols: mangled-looking C++ symbol names sharing long namespace prefixes
+ *  - urls:    URLs drawn from a handful of hosts and paths
+ *
+ * Every result is compared with std::sort, the process fails on any mismatch.
+ *
+ * Usage:
+ * ./bench_string_sort --sizes=1e5,1e6,4e6 --threads=8 --kinds=symbols,urls
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/parallel.h"
+#include "sorting/string_sort.h"
+
+static std::vector<std::string> Generate_Strings(std::string_view kind, std::size_t count, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    auto randomWord = [&](std::size_t minLength, std::size_t maxLength)
+    {
+        std::uniform_int_distribution<std::size_t> lengthDistribution(minLength, maxLength);
+        std::uniform_int_distribution<int> letterDistribution('a', 'z');
+        std::string word(lengthDistribution(generator), ' ');
+        for(char& letter : word)
+        {
+            letter = static_cast<char>(letterDistribution(generator));
+        }
+        return word;
+    };
+
+    static const char* const namespaces[] = {"_ZN3std6chrono", "_ZN3std8__detail", "_ZN5boost4asio6detail",
+                                             "_ZN6engine4core6render", "_ZN6engine4core7physics"};
+    static const char* const hosts[] = {"https://example.com/", "https://cdn.example.com/static/",
+                                        "https://api.example.org/v2/users/", "http://telemetry.local/ingest/"};
+    std::vector<std::string> strings;
+    strings.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(kind == "symbols")
+        {
+            std::string symbol = namespaces[generator() % std::size(namespaces)];
+            const std::string name = randomWord(3, 12);
+            symbol += std::to_string(name.size()) + name + "E" + randomWord(0, 4);
+            strings.push_back(std::move(symbol));
+        }
+        else if(kind == "urls")
+        {
+            strings.push_back(std::string(hosts[generator() % std::size(hosts)]) + randomWord(2, 6) + "/" + randomWord(4, 16));
+        }
+        else
+        {
+            strings.push_back(randomWord(4, 32));
+        }
+    }
+    return strings;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> sizes = args.GetSizes("sizes", {100'000, 1'000'000});
+    const std::vector<std::string> kinds = args.GetList("kinds", {"random", "symbols", "urls"});
+    const unsigned threads = args.GetUnsigned("threads", Default_Thread_Count());
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-9s %10s %-30s %8s %12s %10s\n", "kind", "n", "method", "threads", "ms", "ns/str");
+    Print_Separator(86);
+
+    bool allCorrect = true;
+    for(const std::string& kind : kinds)
+    {
+        for(std::size_t size : sizes)
+        {
+            const std::vector<std::string> input = Generate_Strings(kind, size, 53);
+            const std::vector<std::string_view> inputViews(input.begin(), input.end());
+            std::vector<std::string> expected = input;
+            std::sort(expected.begin(), expected.end());
+
+            auto report = [&](const char* method, unsigned usedThreads, double ns, bool correct)
+            {
+                allCorrect &= correct;
+                std::printf("%-9s %10zu %-30s %8u %12.2f %10.2f%s\n", kind.c_str(), size, method, usedThreads,
+                            ns / 1e6, ns / static_cast<double>(std::max<std::size_t>(size, 1)), correct ? "" : "  WRONG ORDER");
+            };
+            auto matches = [&](std::span<const std::string_view> sorted)
+            {
+                return std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end());
+            };
+
+            std::vector<std::string> strings;
+            double ns = Best_Of_Ns(repetitions, [&] { strings = input; }, [&] { std::sort(strings.begin(), strings.end()); });
+            report("std::sort<std::string>", 1, ns, strings == expected);
+
+            std::vector<std::string_view> views;
+            const auto resetViews = [&] { views = inputViews; };
+            ns = Best_Of_Ns(repetitions, resetViews, [&] { std::sort(views.begin(), views.end()); });
+            report("std::sort<std::string_view>", 1, ns, matches(views));
+
+            ns = Best_Of_Ns(repetitions, resetViews, [&] { String_Sort(std::span(views)); });
+            report("String_Sort (multikey)", 1, ns, matches(views));
+
+            ns = Best_Of_Ns(repetitions, resetViews, [&] { String_Sort_Parallel(std::span(views), threads); });
+            report("String_Sort_Parallel (LCP)", threads, ns, matches(views));
+        }
+    }
+    Print_Separator(86);
+    std::printf("%s\n", allCorrect ? "all string sorts verified against std::sort" : "STRING SORT VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,436 @@
+/*
+ * Strongly connected components benchmark: recursive Tarjan and iterative Kosaraju against
+ * Pearce's iterative Strongly_Connected_Components, plus the cost of Condense.
+ *
+ * Every --edges entry gives two graphs of about that many edges, --degree edges per vertex:
+ *  - planted: vertices shuffled and cut into clusters of 1 to 2 * --cluster - 1 vertices, each a
+ *             ring plus random inner edges; all other edges go forward to a later cluster. The
+ *             clusters are exactly the components, and the DFS path reaches across the graph.
+ *  - rmat:    an RMAT graph, one giant component and a long tail of single vertices
+ *  - dag:     edges from lower to higher rank of a random vertex order, so every vertex is its
+ *             own component (the graphs TopologicalSort.cpp is given)
+ * Recursive Tarjan, the textbook version, only runs while V is small enough that its depth can
+ * not overflow the stack. Kosaraju needs the transpose as well (E more targets in memory, not
+ * counted in its time). Every partition must match the planted clusters or Kosaraju's, every
+ * edge must go forward in component order, and the condensation must hold every component pair
+ * exactly once. A single vertex, a three vertex chain and a three vertex ring are checked last.
+ *
+ * Usage:
+ * ./bench_strongly_connected_components --edges=400K,10M,100M --degree=8 --cluster=16
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "graph/csr_graph.h"
+#include "graph/graph_generators.h"
+#include "graph/strongly_connected_components.h"
+
+/* Vertices up to which the recursive baseline is safe on an 8 MB stack */
+constexpr std::size_t kRecursionDepthLimit = 50'000;
+
+/* Vertex clusters in a random order; edges stay inside a cluster or go to a later one */
+static std::vector<Edge> Generate_Planted(std::size_t vertexCount, std::size_t degree, std::size_t clusterSize, std::uint64_t seed,
+                                          std::vector<VertexId>& clusterOf)
+{
+    std::vector<VertexId> vertexAt(vertexCount);
+    std::iota(vertexAt.begin(), vertexAt.end(), VertexId{0});
+    std::mt19937_64 generator(seed);
+    std::shuffle(vertexAt.begin(), vertexAt.end(), generator);
+    std::uniform_int_distribution<std::size_t> pickSize(1, 2 * clusterSize - 1);
+    std::vector<std::size_t> clusterBegin = {0};
+    while(clusterBegin.back() < vertexCount)
+    {
+        clusterBegin.push_back(std::min(clusterBegin.back() + pickSize(generator), vertexCount));
+    }
+    clusterOf.assign(vertexCount, 0);
+    std::vector<VertexId> clusterAtRank(vertexCount);
+    std::vector<Edge> edges;
+    edges.reserve(vertexCount * degree);
+    for(std::size_t cluster = 0; cluster + 1 < clusterBegin.size(); ++cluster)
+    {
+        const std::size_t begin = clusterBegin[cluster];
+        const std::size_t end = clusterBegin[cluster + 1];
+        for(std::size_t rank = begin; rank < end; ++rank)
+        {
+            clusterOf[vertexAt[rank]] = static_cast<VertexId>(cluster);
+            clusterAtRank[rank] = static_cast<VertexId>(cluster);
+            if(end - begin > 1)
+            {
+                edges.push_back({vertexAt[rank], vertexAt[rank + 1 < end ? rank + 1 : begin]});
+            }
+        }
+    }
+    std::uniform_int_distribution<std::size_t> pick(0, vertexCount - 1);
+    std::uniform_int_distribution<unsigned> percent(0, 99);
+    while(edges.size() < vertexCount * degree)
+    {
+        const std::size_t from = pick(generator);
+        const VertexId cluster = clusterAtRank[from];
+        const std::size_t begin = clusterBegin[cluster];
+        const std::size_t end = clusterBegin[cluster + 1];
+        std::size_t to = 0;
+        if(percent(generator) < 25 || end == vertexCount)
+        {
+            to = begin + pick(generator) % (end - begin);
+        }
+        else
+        {
+            to = end + pick(generator) % (vertexCount - end);
+        }
+        edges.push_back({vertexAt[from], vertexAt[to]});
+    }
+    return edges;
+}
+
+/* Edges from lower to higher rank of a random vertex order, every vertex its own component */
+static std::vector<Edge> Generate_Dag(std::size_t vertexCount, std::size_t degree, std::uint64_t seed, std::vector<VertexId>& componentOf)
+{
+    std::vector<VertexId> vertexAt(vertexCount);
+    std::iota(vertexAt.begin(), vertexAt.end(), VertexId{0});
+    std::mt19937_64 generator(seed);
+    std::shuffle(vertexAt.begin(), vertexAt.end(), generator);
+    componentOf.resize(vertexCount);
+    std::iota(componentOf.begin(), componentOf.end(), VertexId{0});
+    std::vector<Edge> edges;
+    edges.reserve(vertexCount * degree);
+    std::uniform_int_distribution<std::size_t> pick(0, vertexCount - 1);
+    while(edges.size() < vertexCount * degree)
+    {
+        const std::size_t from = pick(generator);
+        const std::size_t to = pick(generator);
+        if(from != to)
+        {
+            edges.push_back({vertexAt[std::min(from, to)], vertexAt[std::max(from, to)]});
+        }
+    }
+    return edges;
+}
+
+/* Tarjan's algorithm as every textbook writes it, one recursion level per DFS tree edge */
+struct RecursiveTarjan
+{
+    const CsrGraph<>& graph;
+    std::vector<VertexId> index;
+    std::vector<VertexId> lowLink;
+    std::vector<bool> onStack;
+    std::vector<VertexId> stack;
+    std::vector<VertexId> component;
+    VertexId nextIndex = 0;
+    VertexId componentCount = 0;
+
+    static constexpr VertexId kUnvisited = std::numeric_limits<VertexId>::max();
+
+    explicit RecursiveTarjan(const CsrGraph<>& g)
+        : graph(g), index(g.VertexCount(), kUnvisited), lowLink(g.VertexCount()), onStack(g.VertexCount()), component(g.VertexCount())
+    {
+        for(VertexId vertex = 0; vertex < g.VertexCount(); ++vertex)
+        {
+            if(index[vertex] == kUnvisited)
+            {
+                Strong_Connect(vertex);
+            }
+        }
+    }
+
+    void Strong_Connect(VertexId v)
+    {
+        index[v] = lowLink[v] = nextIndex++;
+        stack.push_back(v);
+        onStack[v] = true;
+        for(VertexId w : graph.Neighbors(v))
+        {
+            if(index[w] == kUnvisited)
+            {
+                Strong_Connect(w);
+                lowLink[v] = std::min(lowLink[v], lowLink[w]);
+            }
+            else if(onStack[w])
+            {
+                lowLink[v] = std::min(lowLink[v], index[w]);
+            }
+        }
+        if(lowLink[v] == index[v])
+        {
+            VertexId w = 0;
+            do
+            {
+                w = stack.back();
+                stack.pop_back();
+                onStack[w] = false;
+                component[w] = componentCount;
+            } while(w != v);
+            ++componentCount;
+        }
+    }
+};
+
+/* Kosaraju: finish order on the graph, then DFS on the transpose in reverse finish order */
+static std::vector<VertexId> Kosaraju(const CsrGraph<>& graph, const CsrGraph<>& transpose)
+{
+    const std::size_t vertexCount = graph.VertexCount();
+    std::vector<VertexId> finished;
+    finished.reserve(vertexCount);
+    std::vector<bool> visited(vertexCount, false);
+    std::vector<std::pair<VertexId, EdgeId>> path;
+    for(VertexId start = 0; start < vertexCount; ++start)
+    {
+        if(visited[start])
+        {
+            continue;
+        }
+        visited[start] = true;
+        path.push_back({start, graph.Offsets()[start]});
+        while(!path.empty())
+        {
+            auto& [vertex, edge] = path.back();
+            if(edge == graph.Offsets()[vertex + 1])
+            {
+                finished.push_back(vertex);
+                path.pop_back();
+                continue;
+            }
+            const VertexId next = graph.Targets()[edge++];
+            if(!visited[next])
+            {
+                visited[next] = true;
+                path.push_back({next, graph.Offsets()[next]});
+            }
+        }
+    }
+    constexpr VertexId kUnassigned = std::numeric_limits<VertexId>::max();
+    std::vector<VertexId> component(vertexCount, kUnassigned);
+    std::vector<VertexId> stack;
+    VertexId componentCount = 0;
+    for(auto it = finished.rbegin(); it != finished.rend(); ++it)
+    {
+        if(component[*it] != kUnassigned)
+        {
+            continue;
+        }
+        component[*it] = componentCount;
+        stack.push_back(*it);
+        while(!stack.empty())
+        {
+            const VertexId vertex = stack.back();
+            stack.pop_back();
+            for(VertexId previous : transpose.Neighbors(vertex))
+            {
+                if(component[previous] == kUnassigned)
+                {
+                    component[previous] = componentCount;
+                    stack.push_back(previous);
+                }
+            }
+        }
+        ++componentCount;
+    }
+    return component;
+}
+
+/* Both labelings describe the same partition of the vertices */
+static bool Same_Partition(std::span<const VertexId> expected, std::span<const VertexId> component)
+{
+    if(expected.size() != component.size())
+    {
+        return false;
+    }
+    const std::size_t labels = std::max(std::ranges::max(expected), std::ranges::max(component)) + std::size_t{1};
+    constexpr VertexId kUnmapped = std::numeric_limits<VertexId>::max();
+    std::vector<VertexId> forward(labels, kUnmapped);
+    std::vector<VertexId> backward(labels, kUnmapped);
+    for(std::size_t vertex = 0; vertex < expected.size(); ++vertex)
+    {
+        const VertexId a = expected[vertex];
+        const VertexId b = component[vertex];
+        if(forward[a] == kUnmapped && backward[b] == kUnmapped)
+        {
+            forward[a] = b;
+            backward[b] = a;
+        }
+        if(forward[a] != b || backward[b] != a)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Component ids go forward along every edge, members agree with ids, condensation is exact */
+static bool Is_Condensed(const CsrGraph<>& graph, const StronglyConnectedComponents& scc, const CsrGraph<>& dag)
+{
+    const std::size_t componentCount = scc.ComponentCount();
+    if(dag.VertexCount() != componentCount || scc.members.size() != graph.VertexCount())
+    {
+        return false;
+    }
+    for(VertexId component = 0; component < componentCount; ++component)
+    {
+        for(VertexId vertex : scc.Members(component))
+        {
+            if(scc.component[vertex] != component)
+            {
+                return false;
+            }
+        }
+    }
+    std::vector<VertexId> sortedTargets(dag.Targets().begin(), dag.Targets().end());
+    for(VertexId component = 0; component < componentCount; ++component)
+    {
+        const auto begin = sortedTargets.begin() + static_cast<std::ptrdiff_t>(dag.Offsets()[component]);
+        const auto end = sortedTargets.begin() + static_cast<std::ptrdiff_t>(dag.Offsets()[component + 1]);
+        std::sort(begin, end);
+        if(std::adjacent_find(begin, end) != end || (begin != end && *begin <= component))
+        {
+            return false;
+        }
+    }
+    std::vector<bool> used(dag.EdgeCount(), false);
+    for(VertexId vertex = 0; vertex < graph.VertexCount(); ++vertex)
+    {
+        const VertexId from = scc.component[vertex];
+        for(VertexId next : graph.Neighbors(vertex))
+        {
+            const VertexId to = scc.component[next];
+            if(to < from)
+            {
+                return false;
+            }
+            if(to == from)
+            {
+                continue;
+            }
+            const auto begin = sortedTargets.begin() + static_cast<std::ptrdiff_t>(dag.Offsets()[from]);
+            const auto end = sortedTargets.begin() + static_cast<std::ptrdiff_t>(dag.Offsets()[from + 1]);
+            const auto found = std::lower_bound(begin, end, to);
+            if(found == end || *found != to)
+            {
+                return false;
+            }
+            used[static_cast<std::size_t>(found - sortedTargets.begin())] = true;
+        }
+    }
+    /* no condensed edge without an edge of the graph behind it */
+    return std::ranges::all_of(used, [](bool bUsed) { return bUsed; });
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> edgeCounts = args.GetSizes("edges", {400'000, 10'000'000, 100'000'000});
+    const std::size_t degree = std::max<std::size_t>(args.GetSizes("degree", {8}).front(), 1);
+    const std::size_t clusterSize = std::max<std::size_t>(args.GetSizes("cluster", {16}).front(), 1);
+
+    std::printf("%-8s %11s %11s %-36s %10s %10s %9s %11s\n", "shape", "V", "E", "method", "ms", "Medges/s", "speedup", "components");
+    Print_Separator(112);
+
+    bool allCorrect = true;
+    for(std::size_t edgeCount : edgeCounts)
+    {
+        for(const char* shape : {"planted", "rmat", "dag"})
+        {
+            const std::size_t vertexCount = std::max<std::size_t>(edgeCount / degree, 2);
+            std::vector<VertexId> clusterOf;
+            CsrGraph<> graph;
+            CsrGraph<> transpose;
+            {
+                std::vector<Edge> edges;
+                if(std::string(shape) == "planted")
+                {
+                    edges = Generate_Planted(vertexCount, degree, clusterSize, 68, clusterOf);
+                }
+                else if(std::string(shape) == "dag")
+                {
+                    edges = Generate_Dag(vertexCount, degree, 68, clusterOf);
+                }
+                else
+                {
+                    const unsigned scale = static_cast<unsigned>(std::bit_width(vertexCount) - 1);
+                    edges = Generate_Rmat_Edges(scale, std::max<std::size_t>(edgeCount >> scale, 1), 68);
+                }
+                std::size_t usedVertices = clusterOf.size();
+                for(const Edge& edge : edges)
+                {
+                    usedVertices = std::max<std::size_t>(usedVertices, std::size_t{std::max(edge.source, edge.target)} + 1);
+                }
+                graph = CsrGraph<>::From_Edges(usedVertices, edges);
+                for(Edge& edge : edges)
+                {
+                    edge = {edge.target, edge.source};
+                }
+                transpose = CsrGraph<>::From_Edges(usedVertices, edges);
+            }
+
+            double baselineNs = 0;
+            auto report = [&](const std::string& method, double ns, std::size_t components, bool correct)
+            {
+                allCorrect &= correct;
+                baselineNs = baselineNs == 0 ? ns : baselineNs;
+                std::printf("%-8s %11zu %11zu %-36s %10.1f %10.1f %8.2fx %11zu%s\n", shape, graph.VertexCount(), graph.EdgeCount(), method.c_str(),
+                            ns / 1e6, static_cast<double>(graph.EdgeCount()) / ns * 1e3, baselineNs / ns, components, correct ? "" : "  WRONG RESULT");
+            };
+
+            Stopwatch stopwatch;
+            const std::vector<VertexId> kosaraju = Kosaraju(graph, transpose);
+            const double kosarajuNs = stopwatch.ElapsedNs();
+            const std::span<const VertexId> expected = clusterOf.empty() ? std::span<const VertexId>(kosaraju) : std::span<const VertexId>(clusterOf);
+            const std::size_t kosarajuComponents = std::ranges::max(kosaraju) + std::size_t{1};
+
+            if(graph.VertexCount() <= kRecursionDepthLimit)
+            {
+                stopwatch.Restart();
+                const RecursiveTarjan tarjan(graph);
+                const double ns = stopwatch.ElapsedNs();
+                report("Tarjan (recursive)", ns, tarjan.componentCount, Same_Partition(expected, tarjan.component));
+            }
+            else
+            {
+                std::printf("%-8s %11zu %11zu %-36s %10s %10s %9s %11s  (path depth up to %zu overflows the stack)\n", shape, graph.VertexCount(),
+                            graph.EdgeCount(), "Tarjan (recursive)", "skipped", "", "", "", graph.VertexCount());
+            }
+            report("Kosaraju (iterative, needs transpose)", kosarajuNs, kosarajuComponents, Same_Partition(expected, kosaraju));
+
+            stopwatch.Restart();
+            const StronglyConnectedComponents scc = Strongly_Connected_Components(graph);
+            const double sccNs = stopwatch.ElapsedNs();
+            stopwatch.Restart();
+            const CsrGraph<> dag = Condense(graph, scc);
+            const double condenseNs = stopwatch.ElapsedNs();
+            report("Strongly_Connected_Components", sccNs, scc.ComponentCount(), Same_Partition(expected, scc.component));
+            report("  ... plus Condense (" + std::to_string(dag.EdgeCount()) + " edges)", sccNs + condenseNs, dag.VertexCount(),
+                   Is_Condensed(graph, scc, dag));
+        }
+    }
+    Print_Separator(112);
+
+    /* one component per vertex is the case where the component counter runs all the way down */
+    const std::pair<const char*, std::vector<Edge>> smallGraphs[] = {
+        {"single vertex", {}},
+        {"chain 0 -> 1 -> 2", {{0, 1}, {1, 2}}},
+        {"ring 0 -> 1 -> 2 -> 0", {{0, 1}, {1, 2}, {2, 0}}},
+    };
+    for(const auto& [name, edges] : smallGraphs)
+    {
+        const CsrGraph<> graph = CsrGraph<>::From_Edges(edges.empty() ? 1 : 3, edges);
+        const StronglyConnectedComponents scc = Strongly_Connected_Components(graph);
+        const CsrGraph<> dag = Condense(graph, scc);
+        const std::size_t expectedComponents = edges.size() == 3 ? 1 : graph.VertexCount();
+        const bool correct = scc.ComponentCount() == expectedComponents && Is_Condensed(graph, scc, dag);
+        allCorrect &= correct;
+        std::printf("%-36s %zu components%s\n", name, scc.ComponentCount(), correct ? "" : "  WRONG RESULT");
+    }
+    Print_Separator(112);
+    std::printf("%s\n", allCorrect ? "all components and condensations verified" : "SCC VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
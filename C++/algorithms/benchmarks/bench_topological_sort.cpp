@@ -0,0 +1,183 @@
+/*
+ * Topological sort benchmark: recursive DFS against the iterative DFS and Kahn's algorithm.
+ *
+ * Two synthetic DAGs over a random vertex permutation, --degree edges per vertex:
+ *  - wide: --layers layers, every edge goes from one layer to the next (shallow DFS)
+ *  - deep: a Hamiltonian chain through all vertices plus random forward edges, so the DFS path
+ *          is as long as the graph; the recursive version would overflow the stack and is skipped
+ * Compared on each: topologicalSortUtil from TopologicalSort.cpp (recursive, on the CSR graph),
+ * TopologicalSorter::Dfs / Kahn with buffers reused across repetitions and the allocating one
+ * shot Topological_Sort. Every order is checked against every edge. Then one back edge is added
+ * and both methods must report a real cycle.
+ *
+ * Usage:
+ * ./bench_topological_sort --vertices=1M,10M --degree=8 --layers=16
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/graph_benchmark_utils.h"
+#include "graph/csr_graph.h"
+#include "graph/topological_sort.h"
+
+/* Depth up to which the recursive baseline is safe on an 8 MB stack */
+constexpr std::size_t kRecursionDepthLimit = 50'000;
+
+/* TopologicalSort.cpp, topologicalSortUtil unchanged apart from the adjacency type */
+static void Topological_Sort_Util(const CsrGraph<>& graph, VertexId v, std::vector<bool>& visited, std::stack<VertexId>& Stack)
+{
+    visited[v] = true;
+    for(VertexId neighbor : graph.Neighbors(v))
+    {
+        if(!visited[neighbor])
+        {
+            Topological_Sort_Util(graph, neighbor, visited, Stack);
+        }
+    }
+    Stack.push(v);
+}
+
+static std::vector<VertexId> Recursive_Topological_Sort(const CsrGraph<>& graph)
+{
+    std::stack<VertexId> Stack;
+    std::vector<bool> visited(graph.VertexCount(), false);
+    for(std::size_t i = 0; i < graph.VertexCount(); ++i)
+    {
+        if(!visited[i])
+        {
+            Topological_Sort_Util(graph, static_cast<VertexId>(i), visited, Stack);
+        }
+    }
+    std::vector<VertexId> order;
+    order.reserve(graph.VertexCount());
+    while(!Stack.empty())
+    {
+        order.push_back(Stack.top());
+        Stack.pop();
+    }
+    return order;
+}
+
+/* Edges between consecutive ranks of `rankOf`-ordered vertices: layered (wide) or chained (deep) */
+static std::vector<Edge> Generate_Dag(const std::string& shape, std::size_t vertexCount, std::size_t degree, std::size_t layers, std::uint64_t seed)
+{
+    std::vector<VertexId> vertexAt(vertexCount);
+    std::iota(vertexAt.begin(), vertexAt.end(), VertexId{0});
+    std::mt19937_64 generator(seed);
+    std::shuffle(vertexAt.begin(), vertexAt.end(), generator);
+    std::vector<Edge> edges;
+    edges.reserve(vertexCount * degree);
+    if(shape == "deep")
+    {
+        for(std::size_t rank = 0; rank + 1 < vertexCount; ++rank)
+        {
+            edges.push_back({vertexAt[rank], vertexAt[rank + 1]});
+        }
+        std::uniform_int_distribution<std::size_t> pick(0, vertexCount - 1);
+        while(edges.size() < vertexCount * degree)
+        {
+            std::size_t from = pick(generator);
+            std::size_t to = pick(generator);
+            if(from != to)
+            {
+                edges.push_back({vertexAt[std::min(from, to)], vertexAt[std::max(from, to)]});
+            }
+        }
+    }
+    else
+    {
+        const std::size_t width = std::max<std::size_t>(vertexCount / layers, 1);
+        std::uniform_int_distribution<std::size_t> pick(0, width - 1);
+        for(std::size_t layer = 0; layer + 1 < layers && (layer + 1) * width < vertexCount; ++layer)
+        {
+            for(std::size_t i = 0; i < width * degree; ++i)
+            {
+                const std::size_t from = layer * width + pick(generator);
+                const std::size_t to = std::min((layer + 1) * width + pick(generator), vertexCount - 1);
+                edges.push_back({vertexAt[from], vertexAt[to]});
+            }
+        }
+    }
+    return edges;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> vertexCounts = args.GetSizes("vertices", {100'000, 1'000'000, 10'000'000});
+    const std::size_t degree = args.GetSizes("degree", {8}).front();
+    const std::size_t layers = std::max<std::size_t>(args.GetSizes("layers", {16}).front(), 2);
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-6s %12s %12s %-34s %10s %9s\n", "shape", "V", "E", "method", "ms", "speedup");
+    Print_Separator(90);
+
+    bool allCorrect = true;
+    for(const char* shape : {"wide", "deep"})
+    {
+        for(std::size_t vertexCount : vertexCounts)
+        {
+            std::vector<Edge> edges = Generate_Dag(shape, std::max<std::size_t>(vertexCount, 2), degree, layers, 64);
+            const CsrGraph<> graph = CsrGraph<>::From_Edges(std::max<std::size_t>(vertexCount, 2), edges);
+            double baselineNs = 0;
+            auto report = [&](const std::string& method, double ns, bool correct)
+            {
+                allCorrect &= correct;
+                baselineNs = baselineNs == 0 ? ns : baselineNs;
+                std::printf("%-6s %12zu %12zu %-34s %10.2f %8.2fx%s\n", shape, graph.VertexCount(), graph.EdgeCount(), method.c_str(),
+                            ns / 1e6, baselineNs / ns, correct ? "" : "  WRONG RESULT");
+            };
+
+            std::vector<VertexId> dfsOrder;
+            const bool bShallow = (std::string(shape) == "wide" ? layers : graph.VertexCount()) <= kRecursionDepthLimit;
+            if(bShallow)
+            {
+                std::vector<VertexId> recursiveOrder;
+                const double ns = Best_Of_Ns(repetitions, [] {}, [&] { recursiveOrder = Recursive_Topological_Sort(graph); });
+                report("topologicalSortUtil (recursive)", ns, Is_Topological_Order(graph, recursiveOrder));
+                dfsOrder = recursiveOrder;
+            }
+            else
+            {
+                std::printf("%-6s %12zu %12zu %-34s %10s %9s  (path depth ~%zu overflows the stack)\n", shape, graph.VertexCount(),
+                            graph.EdgeCount(), "topologicalSortUtil (recursive)", "skipped", "", graph.VertexCount());
+            }
+
+            TopologicalSorter sorter;
+            std::vector<VertexId> order;
+            bool bSorted = true;
+            double ns = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Dfs(graph, order); });
+            report("TopologicalSorter::Dfs (reused)", ns, bSorted && Is_Topological_Order(graph, order) && (dfsOrder.empty() || dfsOrder == order));
+            ns = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Kahn(graph, order); });
+            report("TopologicalSorter::Kahn (reused)", ns, bSorted && Is_Topological_Order(graph, order));
+            for(ETopologicalSortMethod method : {ETopologicalSortMethod::Dfs, ETopologicalSortMethod::Kahn})
+            {
+                TopologicalSortResult result;
+                ns = Best_Of_Ns(repetitions, [] {}, [&] { result = Topological_Sort(graph, method); });
+                report(std::string("Topological_Sort (") + Topological_Sort_Method_Name(method) + ", one shot)", ns,
+                       !result.HasCycle() && Is_Topological_Order(graph, result.order));
+            }
+
+            /* close a cycle from the last vertex of the order back to the first */
+            edges.push_back({order.back(), order.front()});
+            const CsrGraph<> cyclic = CsrGraph<>::From_Edges(graph.VertexCount(), edges);
+            ns = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Dfs(cyclic, order); });
+            report("Dfs on the graph plus a back edge", ns, !bSorted && order.empty() && Is_Cycle(cyclic, sorter.Cycle()));
+            ns = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Kahn(cyclic, order); });
+            report("Kahn on the graph plus a back edge", ns, !bSorted && order.empty() && Is_Cycle(cyclic, sorter.Cycle()));
+        }
+    }
+    Print_Separator(90);
+    std::printf("%s\n", allCorrect ? "all orders and cycles verified" : "TOPOLOGICAL SORT VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,226 @@
+/*
+ * Vertex reordering benchmark: BFS, DFS and topological sort on randomly labeled graphs before
+ * and after relabeling with each EVertexOrder.
+ *
+ * Every --scales entry gives two graphs of about 2^scale vertices with random ids, the way they
+ * arrive from a file:
+ *  - rmat: Graph 500 RMAT, --edge-factor edges per vertex (social network like, skewed degrees)
+ *  - grid: a square 2D grid plus one random shortcut per 16 vertices (road network like)
+ * Each is traversed as a symmetric graph by a one thread top-down Breadth_First_Search from
+ * --sources sources and by Strongly_Connected_Components (a full DFS), and, with every edge oriented from
+ * the lower to the higher original id, as a DAG by TopologicalSorter::Dfs and Kahn. The
+ * permutation is computed on the symmetric graph and applied to both. Reported per order: the
+ * cost of Vertex_Order + Relabel, and each traversal's time with its speedup over the original
+ * labels. BFS distances and components are translated back through the permutation and must
+ * match, and every topological order must be valid.
+ *
+ * Usage:
+ * ./bench_vertex_reordering --scales=18,20 --edge-factor=16 --sources=8
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/benchmark_utils.h"
+#include "common/graph_benchmark_utils.h"
+#include "graph/breadth_first_search.h"
+#include "graph/csr_graph.h"
+#include "graph/graph_generators.h"
+#include "graph/strongly_connected_components.h"
+#include "graph/topological_sort.h"
+#include "graph/vertex_reordering.h"
+
+/* One shortcut edge per this many grid vertices */
+constexpr std::size_t kGridShortcutSpacing = 16;
+
+/* side x side grid, ids shuffled; each undirected edge listed once */
+static std::vector<Edge> Generate_Grid_Edges(std::size_t side, std::uint64_t seed)
+{
+    const std::size_t vertexCount = side * side;
+    std::vector<VertexId> label(vertexCount);
+    std::iota(label.begin(), label.end(), VertexId{0});
+    std::mt19937_64 generator(seed);
+    std::shuffle(label.begin(), label.end(), generator);
+    std::vector<Edge> edges;
+    edges.reserve(vertexCount * 2 + vertexCount / kGridShortcutSpacing);
+    for(std::size_t row = 0; row < side; ++row)
+    {
+        for(std::size_t column = 0; column < side; ++column)
+        {
+            const std::size_t cell = row * side + column;
+            if(column + 1 < side)
+            {
+                edges.push_back({label[cell], label[cell + 1]});
+            }
+            if(row + 1 < side)
+            {
+                edges.push_back({label[cell], label[cell + side]});
+            }
+        }
+    }
+    std::uniform_int_distribution<std::size_t> pick(0, vertexCount - 1);
+    for(std::size_t i = 0; i < vertexCount / kGridShortcutSpacing; ++i)
+    {
+        edges.push_back({label[pick(generator)], label[pick(generator)]});
+    }
+    return edges;
+}
+
+/*
+ * Traversal times on one labeling
+ */
+struct TraversalRun
+{
+    double bfsNs = 0;
+    double dfsNs = 0;
+    double topoDfsNs = 0;
+    double kahnNs = 0;
+    bool correct = true;
+};
+
+int main(int argc, char** argv)
+{
+    BenchmarkArgs args(argc, argv);
+    const std::vector<std::size_t> scales = args.GetSizes("scales", {18, 20});
+    const std::size_t edgeFactor = args.GetSizes("edge-factor", {16}).front();
+    const std::size_t sourceCount = std::max<std::size_t>(args.GetSizes("sources", {8}).front(), 1);
+    const unsigned repetitions = args.GetUnsigned("reps", 3);
+
+    std::printf("%-5s %10s %11s %-22s %10s %17s %17s %17s %17s\n", "graph", "V", "E", "labels", "reorder ms", "BFS ms", "DFS (SCC) ms",
+                "topo DFS ms", "Kahn ms");
+    Print_Separator(135);
+
+    bool allCorrect = true;
+    for(std::size_t scale : scales)
+    {
+        for(const char* shape : {"rmat", "grid"})
+        {
+            std::vector<Edge> edges;
+            if(std::string(shape) == "rmat")
+            {
+                edges = Generate_Rmat_Edges(static_cast<unsigned>(scale), edgeFactor, 69);
+            }
+            else
+            {
+                edges = Generate_Grid_Edges(static_cast<std::size_t>(std::sqrt(static_cast<double>(std::size_t{1} << scale))), 69);
+            }
+            std::size_t vertexCount = 0;
+            for(Edge& edge : edges)
+            {
+                vertexCount = std::max<std::size_t>(vertexCount, std::size_t{std::max(edge.source, edge.target)} + 1);
+                /* the DAG orientation: lower original id first */
+                edge = {std::min(edge.source, edge.target), std::max(edge.source, edge.target)};
+            }
+            std::erase_if(edges, [](const Edge& edge) { return edge.source == edge.target; });
+            const CsrGraph<> symmetric = CsrGraph<>::From_Edges(vertexCount, Symmetrize_Edges(edges));
+            const CsrGraph<> dag = CsrGraph<>::From_Edges(vertexCount, edges);
+            edges = {};
+
+            std::vector<VertexId> sources;
+            std::mt19937_64 generator(70);
+            std::uniform_int_distribution<VertexId> pick(0, static_cast<VertexId>(vertexCount - 1));
+            while(sources.size() < sourceCount)
+            {
+                const VertexId source = pick(generator);
+                if(symmetric.OutDegree(source) > 0)
+                {
+                    sources.push_back(source);
+                }
+            }
+
+            std::vector<std::vector<std::uint32_t>> expectedDistance;
+            StronglyConnectedComponents expectedScc;
+            TopologicalSorter sorter;
+            std::vector<VertexId> order;
+
+            /* the original labels first (no permutation), then every order against them */
+            auto run = [&](const CsrGraph<>& graph, const CsrGraph<>& orientedDag, const VertexPermutation* permutation)
+            {
+                auto relabeled = [&](VertexId vertex) { return permutation == nullptr ? vertex : permutation->newId[vertex]; };
+                TraversalRun result;
+                for(std::size_t i = 0; i < sources.size(); ++i)
+                {
+                    const VertexId source = sources[i];
+                    std::optional<BfsResult> bfs;
+                    result.bfsNs += Best_Of_Ns(repetitions, [] {}, [&] { bfs = Breadth_First_Search(graph, graph, relabeled(source), 1, EBfsDirection::TopDown); });
+                    if(permutation == nullptr)
+                    {
+                        expectedDistance.push_back(bfs->distance);
+                        continue;
+                    }
+                    const std::vector<std::uint32_t>& expected = expectedDistance[i];
+                    for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+                    {
+                        result.correct &= bfs->distance[relabeled(static_cast<VertexId>(vertex))] == expected[vertex];
+                    }
+                }
+                StronglyConnectedComponents scc;
+                result.dfsNs = Best_Of_Ns(repetitions, [] {}, [&] { scc = Strongly_Connected_Components(graph); });
+                if(permutation == nullptr)
+                {
+                    expectedScc = std::move(scc);
+                }
+                else
+                {
+                    result.correct &= scc.ComponentCount() == expectedScc.ComponentCount();
+                    for(std::size_t component = 0; component < expectedScc.ComponentCount() && result.correct; ++component)
+                    {
+                        const std::span<const VertexId> members = expectedScc.Members(static_cast<VertexId>(component));
+                        const VertexId relabeledComponent = scc.component[relabeled(members.front())];
+                        for(VertexId vertex : members)
+                        {
+                            result.correct &= scc.component[relabeled(vertex)] == relabeledComponent;
+                        }
+                    }
+                }
+                bool bSorted = true;
+                result.topoDfsNs = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Dfs(orientedDag, order); });
+                result.correct &= bSorted && Is_Topological_Order(orientedDag, order);
+                result.kahnNs = Best_Of_Ns(repetitions, [] {}, [&] { bSorted = sorter.Kahn(orientedDag, order); });
+                result.correct &= bSorted && Is_Topological_Order(orientedDag, order);
+                return result;
+            };
+
+            const TraversalRun original = run(symmetric, dag, nullptr);
+            auto report = [&](const char* labels, double reorderNs, const TraversalRun& result)
+            {
+                allCorrect &= result.correct;
+                auto column = [](double ns, double baselineNs)
+                {
+                    char text[32];
+                    std::snprintf(text, sizeof(text), "%9.1f (%4.2fx)", ns / 1e6, baselineNs / ns);
+                    return std::string(text);
+                };
+                std::printf("%-5s %10zu %11zu %-22s %10.1f %17s %17s %17s %17s%s\n", shape, vertexCount, symmetric.EdgeCount(), labels,
+                            reorderNs / 1e6,
+                            column(result.bfsNs, original.bfsNs).c_str(), column(result.dfsNs, original.dfsNs).c_str(),
+                            column(result.topoDfsNs, original.topoDfsNs).c_str(), column(result.kahnNs, original.kahnNs).c_str(),
+                            result.correct ? "" : "  WRONG RESULT");
+            };
+            report("random (input)", 0, original);
+
+            for(EVertexOrder vertexOrder : {EVertexOrder::Degree, EVertexOrder::Rcm, EVertexOrder::Gorder})
+            {
+                Stopwatch stopwatch;
+                const VertexPermutation permutation = Vertex_Order(symmetric, vertexOrder);
+                const CsrGraph<> graph = Relabel(symmetric, permutation);
+                const double reorderNs = stopwatch.ElapsedNs();
+                /* the relabeled DAG keeps the original orientation, so it is still acyclic */
+                const CsrGraph<> orientedDag = Relabel(dag, permutation);
+                report(Vertex_Order_Name(vertexOrder), reorderNs, run(graph, orientedDag, &permutation));
+            }
+        }
+    }
+    Print_Separator(135);
+    std::printf("%s\n", allCorrect ? "all distances, components and orders verified" : "VERTEX REORDERING VERIFICATION FAILED");
+    return allCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Fixed size, uninitialized array of trivial elements whose first element starts on an
+ * `Alignment` byte boundary (a cache line by default).
+ *
+ * Cache conscious layouts only pay off when their blocks line up with cache lines, which
+ * std::vector does not guarantee.
+ *
+ * Example usage:
+ * @code
+ * AlignedBuffer<std::int32_t> nodes(16 * nodeCount);
+ * std::fill_n(nodes.Data(), nodes.Size(), 0);
+ * @endcode
+ */
+template<class T, std::size_t Alignment = 64>
+class AlignedBuffer
+{
+    static_assert(std::is_trivial_v<T>, "AlignedBuffer does not run constructors");
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+
+public:
+    AlignedBuffer() = default;
+
+    explicit AlignedBuffer(const std::size_t size)
+        : m_data(size == 0 ? nullptr : static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{Alignment})))
+        , m_size(size)
+    {
+    }
+
+    T* Data() noexcept { return m_data.get(); }
+    const T* Data() const noexcept { return m_data.get(); }
+    std::size_t Size() const noexcept { return m_size; }
+    std::size_t Bytes() const noexcept { return m_size * sizeof(T); }
+
+    T& operator[](const std::size_t index) noexcept { return m_data.get()[index]; }
+    const T& operator[](const std::size_t index) const noexcept { return m_data.get()[index]; }
+
+private:
+    struct Deleter
+    {
+        void operator()(T* data) const noexcept { ::operator delete(data, std::align_val_t{Alignment}); }
+    };
+
+    std::unique_ptr<T, Deleter> m_data;
+    std::size_t m_size = 0;
+};
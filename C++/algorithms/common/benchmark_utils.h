@@ -0,0 +1,401 @@
+#pragma once
+
+/*
+ * benchmark_utils.h is the small toolbox shared by every executable in benchmarks/.
+ * Timing, command line parsing and input generation live here so each benchmark
+ * only contains the code it is actually measuring.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Monotonic wall clock stopwatch, started on construction.
+ */
+class Stopwatch
+{
+public:
+    Stopwatch() noexcept : m_start(std::chrono::steady_clock::now()) {}
+
+    void Restart() noexcept
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    double ElapsedNs() const noexcept
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    double ElapsedMs() const noexcept
+    {
+        return ElapsedNs() / 1e6;
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Keep the optimizer from deleting a computation whose result is otherwise unused.
+ */
+template<class T>
+inline void Do_Not_Optimize(const T& value) noexcept
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Run `func` `repetitions` times and return the fastest run in nanoseconds.
+ *
+ * @param repetitions: number of timed runs (at least one)
+ * @param setup: called before every run, outside of the timed region
+ * @param func: the code to measure
+ *
+ * @return double: best observed wall time in nanoseconds
+ */
+template<class Setup, class Func>
+double Best_Of_Ns(unsigned repetitions, Setup&& setup, Func&& func)
+{
+    double best = std::numeric_limits<double>::max();
+    for(unsigned i = 0; i < (repetitions == 0 ? 1 : repetitions); ++i)
+    {
+        setup();
+        Stopwatch stopwatch;
+        func();
+        const double elapsed = stopwatch.ElapsedNs();
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+/**
+ * @brief Minimal `--name=value` command line reader.
+ *
+ * Sizes accept scientific notation and k/M/G suffixes so `--sizes=1e6,10M,1G` works.
+ *
+ * Example usage:
+ * @code
+ * BenchmarkArgs args(argc, argv);
+ * std::vector<std::size_t> sizes = args.GetSizes("sizes", {1'000, 1'000'000});
+ * unsigned threads = args.GetUnsigned("threads", Default_Thread_Count());
+ * @endcode
+ */
+class BenchmarkArgs
+{
+public:
+    BenchmarkArgs(int argc, char** argv)
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            m_args.emplace_back(argv[i]);
+        }
+    }
+
+    bool Has(std::string_view name) const
+    {
+        return Find(name).has_value();
+    }
+
+    std::string GetString(std::string_view name, std::string fallback) const
+    {
+        const std::optional<std::string> value = Find(name);
+        return value ? *value : fallback;
+    }
+
+    unsigned GetUnsigned(std::string_view name, unsigned fallback) const
+    {
+        const std::optional<std::string> value = Find(name);
+        return value ? static_cast<unsigned>(Parse_Size(*value)) : fallback;
+    }
+
+    std::vector<std::size_t> GetSizes(std::string_view name, std::vector<std::size_t> fallback) const
+    {
+        const std::optional<std::string> value = Find(name);
+        if(!value)
+        {
+            return fallback;
+        }
+        std::vector<std::size_t> sizes;
+        std::size_t begin = 0;
+        while(begin <= value->size())
+        {
+            std::size_t end = value->find(',', begin);
+            end = end == std::string::npos ? value->size() : end;
+            if(end > begin)
+            {
+                sizes.push_back(Parse_Size(value->substr(begin, end - begin)));
+            }
+            begin = end + 1;
+        }
+        return sizes;
+    }
+
+    std::vector<std::string> GetList(std::string_view name, std::vector<std::string> fallback) const
+    {
+        const std::optional<std::string> value = Find(name);
+        if(!value)
+        {
+            return fallback;
+        }
+        std::vector<std::string> items;
+        std::size_t begin = 0;
+        while(begin <= value->size())
+        {
+            std::size_t end = value->find(',', begin);
+            end = end == std::string::npos ? value->size() : end;
+            if(end > begin)
+            {
+                items.push_back(value->substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        return items;
+    }
+
+    /**
+     * @brief Parse "1000", "1e6", "10M", "2G" into a count.
+     */
+    static std::size_t Parse_Size(const std::string& text)
+    {
+        char* end = nullptr;
+        double value = std::strtod(text.c_str(), &end);
+        switch(end && *end ? *end : '\0')
+        {
+            case 'k': case 'K': value *= 1e3; break;
+            case 'm': case 'M': value *= 1e6; break;
+            case 'g': case 'G': value *= 1e9; break;
+            default: break;
+        }
+        return static_cast<std::size_t>(value);
+    }
+
+private:
+    std::optional<std::string> Find(std::string_view name) const
+    {
+        for(const std::string& arg : m_args)
+        {
+            std::string_view view(arg);
+            if(!view.starts_with("--") || view.substr(2, name.size()) != name)
+            {
+                continue;
+            }
+            view.remove_prefix(name.size() + 2);
+            if(view.empty())
+            {
+                return std::string(1, '1'); /* bare flag */
+            }
+            if(view.front() == '=')
+            {
+                return std::string(view.substr(1));
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<std::string> m_args;
+};
+
+/**
+ * @brief Fill a vector with uniformly distributed values in [minValue, maxValue].
+ *
+ * @param count: number of elements
+ * @param seed: generator seed, benchmarks use fixed seeds so runs are comparable
+ */
+template<class T>
+std::vector<T> Generate_Uniform(std::size_t count, std::uint64_t seed,
+                                T minValue = std::numeric_limits<T>::lowest(),
+                                T maxValue = std::numeric_limits<T>::max())
+{
+    std::vector<T> values(count);
+    std::mt19937_64 generator(seed);
+    if constexpr(std::is_floating_point_v<T>)
+    {
+        std::uniform_real_distribution<T> distribution(minValue, maxValue);
+        for(T& value : values)
+        {
+            value = distribution(generator);
+        }
+    }
+    else
+    {
+        std::uniform_int_distribution<T> distribution(minValue, maxValue);
+        for(T& value : values)
+        {
+            value = distribution(generator);
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Print a horizontal separator sized for the benchmark tables.
+ */
+inline void Print_Separator(int width = 96) noexcept
+{
+    for(int i = 0; i < width; ++i)
+    {
+        std::putchar('-');
+    }
+    std::putchar('\n');
+}
+
+/*
+ * Input shapes used by the sorting and searching benchmarks
+ */
+enum class EDistribution : int
+{
+    Random,     /* uniform over the full int range */
+    Sorted,     /* ascending */
+    Reversed,   /* descending */
+    FewUnique,  /* uniform over 16 distinct keys */
+    Zipf,       /* key k drawn with probability ~ 1 / k, s = 1 */
+    AutoCount   /* Should be last! Number of distributions */
+};
+
+inline const char* Distribution_Name(const EDistribution distribution) noexcept
+{
+    switch(distribution)
+    {
+        case EDistribution::Random:
+            return "random";
+        case EDistribution::Sorted:
+            return "sorted";
+        case EDistribution::Reversed:
+            return "reversed";
+        case EDistribution::FewUnique:
+            return "few-unique";
+        case EDistribution::Zipf:
+            return "zipf";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief Look a distribution up by the name printed by Distribution_Name().
+ *
+ * @return EDistribution: the match, or EDistribution::AutoCount when the name is unknown
+ */
+inline EDistribution Parse_Distribution(std::string_view name) noexcept
+{
+    for(int i = 0; i < static_cast<int>(EDistribution::AutoCount); ++i)
+    {
+        if(name == Distribution_Name(static_cast<EDistribution>(i)))
+        {
+            return static_cast<EDistribution>(i);
+        }
+    }
+    return EDistribution::AutoCount;
+}
+
+/**
+ * @brief Draw `count` Zipf(s = 1) distributed ranks in [1, universe] by inverting the CDF.
+ */
+inline std::vector<std::int32_t> Generate_Zipf(std::size_t count, std::uint64_t seed, std::size_t universe = 1u << 20)
+{
+    std::vector<double> cumulative(universe);
+    double sum = 0.0;
+    for(std::size_t rank = 0; rank < universe; ++rank)
+    {
+        sum += 1.0 / static_cast<double>(rank + 1);
+        cumulative[rank] = sum;
+    }
+    std::vector<std::int32_t> values(count);
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, sum);
+    for(std::int32_t& value : values)
+    {
+        const double target = distribution(generator);
+        std::size_t low = 0;
+        std::size_t high = universe - 1;
+        while(low < high)
+        {
+            const std::size_t mid = low + (high - low) / 2;
+            if(cumulative[mid] < target)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        value = static_cast<std::int32_t>(low + 1);
+    }
+    return values;
+}
+
+/**
+ * @brief Generate `count` int32 keys shaped like `distribution`.
+ */
+inline std::vector<std::int32_t> Generate_Distribution(EDistribution distribution, std::size_t count, std::uint64_t seed)
+{
+    std::vector<std::int32_t> values;
+    switch(distribution)
+    {
+        case EDistribution::Sorted:
+        case EDistribution::Reversed:
+            values = Generate_Uniform<std::int32_t>(count, seed);
+            std::sort(values.begin(), values.end());
+            if(distribution == EDistribution::Reversed)
+            {
+                std::reverse(values.begin(), values.end());
+            }
+            break;
+        case EDistribution::FewUnique:
+            values = Generate_Uniform<std::int32_t>(count, seed, 0, 15);
+            break;
+        case EDistribution::Zipf:
+            values = Generate_Zipf(count, seed);
+            break;
+        case EDistribution::Random:
+        default:
+            values = Generate_Uniform<std::int32_t>(count, seed);
+            break;
+    }
+    return values;
+}
+
+/**
+ * @brief Sorted int64 keys for the index benchmarks.
+ *
+ * @param shape: "uniform" over [0, 2^40), "lognormal" (exp(N(0, 2)) * 1e9, heavy right tail and
+ *               duplicates at the low end) or "clustered" (1000 uniform centres with N(0, 1e5) noise)
+ */
+inline std::vector<std::int64_t> Generate_Sorted_Keys(std::string_view shape, std::size_t count, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::vector<std::int64_t> keys(count);
+    if(shape == "lognormal")
+    {
+        std::lognormal_distribution<double> lognormal(0.0, 2.0);
+        std::generate(keys.begin(), keys.end(), [&] { return static_cast<std::int64_t>(std::min(lognormal(generator) * 1e9, 4e18)); });
+    }
+    else if(shape == "clustered")
+    {
+        std::uniform_int_distribution<std::int64_t> uniform(0, std::int64_t{1} << 40);
+        std::vector<std::int64_t> centres(1'000);
+        std::generate(centres.begin(), centres.end(), [&] { return uniform(generator); });
+        std::uniform_int_distribution<std::size_t> pick(0, centres.size() - 1);
+        std::normal_distribution<double> noise(0.0, 1e5);
+        std::generate(keys.begin(), keys.end(), [&] { return centres[pick(generator)] + static_cast<std::int64_t>(noise(generator)); });
+    }
+    else
+    {
+        std::uniform_int_distribution<std::int64_t> uniform(0, std::int64_t{1} << 40);
+        std::generate(keys.begin(), keys.end(), [&] { return uniform(generator); });
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/*
+ * cpu_features.h answers "may this process run AVX2 / AVX-512 code" at run time.
+ * SIMD kernels are compiled per function with __attribute__((target(...))), so the library
+ * does not need -mavx2 and the same binary still runs on machines without the extension.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ALGORITHMS_X86 1
+#else
+#define ALGORITHMS_X86 0
+#endif /* x86 */
+
+/*
+ * Instruction set levels a kernel can be dispatched to, ordered from slowest to fastest
+ */
+enum class ESimdLevel : int
+{
+    Scalar,
+    Avx2,
+    Avx512,
+    AutoCount /* Should be last! Number of levels */
+};
+
+/**
+ * @brief Best SIMD level supported by the running CPU (detected once, then cached).
+ */
+inline ESimdLevel Detect_Simd_Level() noexcept
+{
+#if ALGORITHMS_X86 && (defined(__GNUC__) || defined(__clang__))
+    static const ESimdLevel level = []
+    {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        {
+            return ESimdLevel::Avx512;
+        }
+        if(__builtin_cpu_supports("avx2"))
+        {
+            return ESimdLevel::Avx2;
+        }
+        return ESimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return ESimdLevel::Scalar;
+#endif
+}
+
+inline const char* Simd_Level_Name(const ESimdLevel level) noexcept
+{
+    switch(level)
+    {
+        case ESimdLevel::Avx512:
+            return "avx512";
+        case ESimdLevel::Avx2:
+            return "avx2";
+        case ESimdLevel::Scalar:
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ * graph_benchmark_utils.h holds the result checks shared by the graph benchmarks, so every
+ * benchmark verifies its orders and cycles the same way.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "graph/csr_graph.h"
+
+/**
+ * @brief True when `order` lists every vertex of `graph` once and every edge goes from an
+ *        earlier to a later position.
+ */
+template<class Weight>
+bool Is_Topological_Order(const CsrGraph<Weight>& graph, std::span<const VertexId> order)
+{
+    if(order.size() != graph.VertexCount())
+    {
+        return false;
+    }
+    std::vector<VertexId> rank(order.size());
+    std::vector<bool> seen(order.size(), false);
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        if(order[i] >= order.size() || seen[order[i]])
+        {
+            return false;
+        }
+        seen[order[i]] = true;
+        rank[order[i]] = static_cast<VertexId>(i);
+    }
+    for(std::size_t vertex = 0; vertex < graph.VertexCount(); ++vertex)
+    {
+        for(VertexId neighbor : graph.Neighbors(static_cast<VertexId>(vertex)))
+        {
+            if(rank[vertex] >= rank[neighbor])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief True when `cycle` is a non empty closed walk in `graph`: every vertex has an edge to the
+ *        next one and the last vertex has an edge back to the first.
+ */
+template<class Weight>
+bool Is_Cycle(const CsrGraph<Weight>& graph, std::span<const VertexId> cycle)
+{
+    if(cycle.empty())
+    {
+        return false;
+    }
+    for(std::size_t i = 0; i < cycle.size(); ++i)
+    {
+        const std::span<const VertexId> neighbors = graph.Neighbors(cycle[i]);
+        if(std::find(neighbors.begin(), neighbors.end(), cycle[(i + 1) % cycle.size()]) == neighbors.end())
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/**
+ * @brief Number of worker threads used when the caller does not ask for a specific count.
+ *
+ * @return unsigned: hardware concurrency, never less than 1
+ */
+inline unsigned Default_Thread_Count() noexcept
+{
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+/**
+ * @brief Split [0, count) into `threads` contiguous chunks and run `func` on each one.
+ *
+ * The calling thread processes the first chunk itself, so `threads == 1` never spawns.
+ * Chunk boundaries are deterministic: chunk `t` is [count * t / threads, count * (t + 1) / threads).
+ *
+ * @param count: number of items to split
+ * @param threads: number of chunks (clamped to [1, count])
+ * @param func: callable as func(chunkIndex, begin, end)
+ *
+ * Example usage:
+ * @code
+ * Parallel_For_Chunks(data.size(), 4, [&](unsigned chunk, std::size_t begin, std::size_t end)
+ * {
+ *     partialSums[chunk] = std::accumulate(data.begin() + begin, data.begin() + end, 0ull);
+ * });
+ * @endcode
+ */
+template<class Func>
+void Parallel_For_Chunks(const std::size_t count, unsigned threads, Func&& func)
+{
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(count, 1)));
+    auto chunkBegin = [&](unsigned chunk) { return count * chunk / threads; };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(threads - 1);
+    for(unsigned chunk = 1; chunk < threads; ++chunk)
+    {
+        workers.emplace_back([&func, chunk, begin = chunkBegin(chunk), end = chunkBegin(chunk + 1)]
+        {
+            func(chunk, begin, end);
+        });
+    }
+    func(0u, chunkBegin(0), chunkBegin(1));
+}
+
+/**
+ * @brief Pin the calling thread to one logical CPU, so that a benchmark measures the same pair
+ * of cores every run.
+ *
+ * @param cpu: logical CPU number
+ * @return bool: false if the CPU does not exist or pinning is not supported here
+ */
+inline bool Pin_Current_Thread(const unsigned cpu) noexcept
+{
+#if defined(__linux__)
+    if(cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+ * perf_counters.h wraps Linux perf_event_open for hardware counters in benchmarks.
+ * Counters are optional: containers, VMs and kernels with perf_event_paranoid > 2 refuse them,
+ * in which case IsAvailable() is false and Read() returns 0, the benchmark keeps running.
+ */
+
+#include <cstdint>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif /* __linux__ */
+
+/*
+ * Hardware events the benchmarks know how to ask for
+ */
+enum class EPerfEvent : int
+{
+    CacheMisses,
+    BranchMisses,
+    Instructions,
+    Cycles,
+    AutoCount /* Should be last! Number of events */
+};
+
+/**
+ * @brief One hardware counter for the calling thread, counting user space only.
+ *
+ * Example usage:
+ * @code
+ * PerfCounter cacheMisses(EPerfEvent::CacheMisses);
+ * cacheMisses.Start();
+ * Run_Workload();
+ * cacheMisses.Stop();
+ * if(cacheMisses.IsAvailable())
+ * {
+ *     std::printf("%llu misses\n", static_cast<unsigned long long>(cacheMisses.Read()));
+ * }
+ * @endcode
+ */
+class PerfCounter
+{
+public:
+    explicit PerfCounter(EPerfEvent event) noexcept
+    {
+#if defined(__linux__)
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = To_Perf_Config(event);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#else
+        (void)event;
+#endif /* __linux__ */
+    }
+
+    ~PerfCounter()
+    {
+#if defined(__linux__)
+        if(m_fd >= 0)
+        {
+            close(m_fd);
+        }
+#endif /* __linux__ */
+    }
+
+    PerfCounter(PerfCounter&& source) = delete;
+    PerfCounter(const PerfCounter& source) = delete;
+    PerfCounter& operator=(PerfCounter&& source) = delete;
+    PerfCounter& operator=(const PerfCounter& source) = delete;
+
+    bool IsAvailable() const noexcept
+    {
+        return m_fd >= 0;
+    }
+
+    /**
+     * @brief Reset the counter to zero and start counting.
+     */
+    void Start() noexcept
+    {
+#if defined(__linux__)
+        if(m_fd >= 0)
+        {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif /* __linux__ */
+    }
+
+    void Stop() noexcept
+    {
+#if defined(__linux__)
+        if(m_fd >= 0)
+        {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif /* __linux__ */
+    }
+
+    /**
+     * @return std::uint64_t: events counted between Start() and Stop(), 0 when unavailable
+     */
+    std::uint64_t Read() const noexcept
+    {
+        std::uint64_t value = 0;
+#if defined(__linux__)
+        if(m_fd >= 0 && ::read(m_fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value)))
+        {
+            value = 0;
+        }
+#endif /* __linux__ */
+        return value;
+    }
+
+private:
+#if defined(__linux__)
+    static std::uint64_t To_Perf_Config(EPerfEvent event) noexcept
+    {
+        switch(event)
+        {
+            case EPerfEvent::CacheMisses:
+                return PERF_COUNT_HW_CACHE_MISSES;
+            case EPerfEvent::BranchMisses:
+                return PERF_COUNT_HW_BRANCH_MISSES;
+            case EPerfEvent::Instructions:
+                return PERF_COUNT_HW_INSTRUCTIONS;
+            case EPerfEvent::Cycles:
+            default:
+                return PERF_COUNT_HW_CPU_CYCLES;
+        }
+    }
+#endif /* __linux__ */
+
+    int m_fd{-1};
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+ * search_benchmark_utils.h holds the repository's original binary searches as the baselines of
+ * the search benchmarks, templated on the key type so every benchmark measures the same code.
+ */
+
+#include <cstdint>
+
+/**
+ * @brief binarySearch from binary_search.cpp before it became branchless, unchanged apart from the types.
+ *
+ * @return std::int64_t: index of `x` in arr[l..r], or -1
+ */
+template<class T>
+std::int64_t Recursive_Binary_Search(const T* arr, std::int64_t l, std::int64_t r, T x)
+{
+    if(r >= l)
+    {
+        const std::int64_t mid = l + (r - l) / 2;
+        if(arr[mid] == x)
+        {
+            return mid;
+        }
+        if(arr[mid] > x)
+        {
+            return Recursive_Binary_Search(arr, l, mid - 1, x);
+        }
+        return Recursive_Binary_Search(arr, mid + 1, r, x);
+    }
+    return -1;
+}
+
+/**
+ * @brief binarySearch from RecursiveBinarySearchAlgorithm.cpp (iterative, two branches per level).
+ *
+ * @return std::int64_t: index of `x` in arr[l..r], or -1
+ */
+template<class T>
+std::int64_t Iterative_Binary_Search(const T* arr, std::int64_t l, std::int64_t r, T x)
+{
+    while(l <= r)
+    {
+        const std::int64_t m = l + (r - l) / 2;
+        if(arr[m] == x)
+        {
+            return m;
+        }
+        if(arr[m] < x)
+        {
+            l = m + 1;
+        }
+        else
+        {
+            r = m - 1;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+/*
+ * work_stealing.h runs a dynamically growing set of small work items on a fixed team of threads.
+ *
+ * Parallel_For_Chunks splits work that is known up front. Task graphs are not like that: a
+ * vertex becomes runnable only when its last predecessor finishes, on whichever thread that was.
+ * Every worker keeps the items it creates in a private stack and runs them LIFO, which keeps the
+ * successor of a finished item hot in cache and costs no synchronization at all. Only while some
+ * worker is idle does a busy worker move the older half of its stack to its shared deque, where
+ * the idle one steals from the front. The shared deques are guarded by a mutex each; they are
+ * touched once per shared batch or steal, not once per item, so a lock free Chase-Lev deque
+ * would buy nothing measurable here.
+ *
+ * Idle workers spin through the victims a few times, yielding, then sleep on an epoch counter
+ * that is bumped whenever work is shared while somebody sleeps. Run returns once every item,
+ * including the ones pushed while running, has been handled.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "common/parallel.h"
+
+/* Rounds over all victims an idle worker makes before it goes to sleep */
+constexpr unsigned kWorkStealingSpinRounds = 64;
+
+/**
+ * @brief Work stealing scheduler for items of type `Item`, handled by one callable per Run.
+ *
+ * The handler is called as handler(item, worker) and may call worker.Push(next) to schedule
+ * more items. The threads live for the duration of one Run, the deques keep their capacity.
+ *
+ * Example usage:
+ * @code
+ * WorkStealingPool<VertexId> pool(8);
+ * pool.Run(std::span<const VertexId>(roots), [&](VertexId vertex, WorkStealingPool<VertexId>::Worker& worker)
+ * {
+ *     for(VertexId child : tree.Children(vertex)) { worker.Push(child); }
+ * });
+ * @endcode
+ */
+template<class Item>
+class WorkStealingPool
+{
+public:
+    /*
+     * Handle of the thread running the handler: where Push puts new items
+     */
+    class Worker
+    {
+    public:
+        void Push(const Item& item)
+        {
+            m_pool.m_queues[m_index].local.push_back(item);
+        }
+
+        unsigned Index() const noexcept { return m_index; }
+
+    private:
+        friend class WorkStealingPool;
+
+        Worker(WorkStealingPool& pool, const unsigned index) noexcept
+            : m_pool(pool)
+            , m_index(index)
+        {
+        }
+
+        WorkStealingPool& m_pool;
+        unsigned m_index;
+    };
+
+    explicit WorkStealingPool(const unsigned threads = Default_Thread_Count())
+        : m_queues(std::max(threads, 1u))
+    {
+    }
+
+    unsigned ThreadCount() const noexcept { return static_cast<unsigned>(m_queues.size()); }
+
+    /* Items taken from another worker's shared deque during the last Run */
+    std::uint64_t Steals() const noexcept { return m_steals.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Handle `seeds` and everything the handler pushes, return when all of it is done.
+     *
+     * @param seeds: initial items, dealt round robin to the workers
+     * @param handler: callable as handler(item, worker)
+     */
+    template<class Handler>
+    void Run(std::span<const Item> seeds, Handler&& handler)
+    {
+        const unsigned threads = ThreadCount();
+        m_steals.store(0, std::memory_order_relaxed);
+        m_idle.store(0, std::memory_order_relaxed);
+        m_pending.store(seeds.size(), std::memory_order_relaxed);
+        for(std::size_t i = 0; i < seeds.size(); ++i)
+        {
+            m_queues[i % threads].items.push_back(seeds[i]);
+        }
+        if(seeds.empty())
+        {
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1);
+        for(unsigned index = 1; index < threads; ++index)
+        {
+            workers.emplace_back([this, &handler, index] { Work(index, handler); });
+        }
+        Work(0, handler);
+    }
+
+private:
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<Item> items;   /* shared, guarded by mutex */
+        std::vector<Item> local;  /* private to the owning worker */
+    };
+
+    /* Move the older half of the private stack to the shared deque, where idle workers find it */
+    void Share(const unsigned index)
+    {
+        Queue& queue = m_queues[index];
+        const std::size_t count = queue.local.size() / 2;
+        m_pending.fetch_add(count, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.insert(queue.items.end(), queue.local.begin(), queue.local.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+        queue.local.erase(queue.local.begin(), queue.local.begin() + static_cast<std::ptrdiff_t>(count));
+        /* pairs with the sleeper's m_sleepers increment: either it sees the items or we see it */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(m_sleepers.load(std::memory_order_relaxed) > 0)
+        {
+            m_epoch.fetch_add(1);
+            m_epoch.notify_all();
+        }
+    }
+
+    bool Pop(const unsigned index, Item& item)
+    {
+        Queue& queue = m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.items.empty())
+        {
+            return false;
+        }
+        item = queue.items.back();
+        queue.items.pop_back();
+        return true;
+    }
+
+    bool Steal(const unsigned thief, Item& item)
+    {
+        const unsigned threads = ThreadCount();
+        for(unsigned offset = 1; offset < threads; ++offset)
+        {
+            Queue& queue = m_queues[(thief + offset) % threads];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(!queue.items.empty())
+            {
+                item = queue.items.front();
+                queue.items.pop_front();
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<class Handler>
+    void Work(const unsigned index, Handler& handler)
+    {
+        Worker worker(*this, index);
+        std::vector<Item>& local = m_queues[index].local;
+        unsigned idleRounds = 0;
+        bool bIdle = false;
+        Item item;
+        while(true)
+        {
+            if(Pop(index, item) || Steal(index, item))
+            {
+                if(bIdle)
+                {
+                    m_idle.fetch_sub(1, std::memory_order_relaxed);
+                    bIdle = false;
+                }
+                idleRounds = 0;
+                /* the item and everything it pushes privately count as one pending item */
+                handler(item, worker);
+                while(!local.empty())
+                {
+                    if(local.size() > 1 && m_idle.load(std::memory_order_relaxed) > 0)
+                    {
+                        Share(index);
+                    }
+                    item = local.back();
+                    local.pop_back();
+                    handler(item, worker);
+                }
+                if(m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    /* the last item is done, wake everybody so they can leave */
+                    m_epoch.fetch_add(1);
+                    m_epoch.notify_all();
+                    return;
+                }
+                continue;
+            }
+            if(m_pending.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+            if(!bIdle)
+            {
+                m_idle.fetch_add(1, std::memory_order_relaxed);
+                bIdle = true;
+            }
+            if(++idleRounds < kWorkStealingSpinRounds)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            /* work shared before our increment is seen by Any_Queued, later sharing bumps the epoch */
+            m_sleepers.fetch_add(1);
+            const std::uint64_t epoch = m_epoch.load();
+            if(!Any_Queued() && m_pending.load() != 0)
+            {
+                m_epoch.wait(epoch);
+            }
+            m_sleepers.fetch_sub(1);
+            idleRounds = 0;
+        }
+    }
+
+    bool Any_Queued()
+    {
+        for(Queue& queue : m_queues)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(!queue.items.empty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Queue> m_queues;
+    alignas(64) std::atomic<std::size_t> m_pending = 0;
+    alignas(64) std::atomic<unsigned> m_idle = 0;
+    alignas(64) std::atomic<std::uint64_t> m_epoch = 0;
+    std::atomic<unsigned> m_sleepers = 0;
+    std::atomic<std::uint64_t> m_steals = 0;
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+/*
+ * circular_buffer.h is a single threaded fixed capacity ring of any element type.
+ *
+ * `Queue` in Circular Queue.cpp stores ints only, fills freed slots with -1, refuses to write
+ * when full, and its displayQueue walks the array in two loops, front to the end and start to
+ * rear, which is how the queue gets used: as a rolling window over the latest values.
+ * CircularBuffer<T> is that window made general:
+ *
+ *  - slots are raw storage; an element is constructed when it is pushed and destroyed when it
+ *    is popped, so freed slots hold nothing and `T` needs no default value
+ *  - EOverflow::Reject makes a push into a full buffer fail, EOverflow::OverwriteOldest move
+ *    assigns the new element over the oldest instead, which keeps the newest Capacity()
+ *    samples of a stream
+ *  - a moved-from buffer is empty with capacity 0 and rejects every push
+ *  - the capacity is exact, not rounded, because it is the window length; indexes wrap with a
+ *    compare and subtract instead of a modulo
+ *  - operator[] and At() address elements by logical index, 0 the oldest
+ *  - Spans() and Newest(count) return the contents as the two contiguous runs displayQueue
+ *    walks, as a RingRegion, so reductions over the window are plain loops over arrays that the
+ *    compiler vectorizes
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "containers/ring_region.h"
+
+/*
+ * What a push into a full CircularBuffer does
+ */
+enum class EOverflow : int
+{
+    Reject,
+    OverwriteOldest,
+    AutoCount /* Should be last! Number of policies */
+};
+
+inline const char* Overflow_Name(const EOverflow overflow) noexcept
+{
+    switch(overflow)
+    {
+        case EOverflow::Reject: return "reject";
+        case EOverflow::OverwriteOldest: return "overwrite oldest";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Fixed capacity FIFO of `T` over one array, for queues and sliding windows.
+ *
+ * Example usage:
+ * @code
+ * CircularBuffer<float> window(1000, EOverflow::OverwriteOldest);
+ * for(float sample : stream)
+ * {
+ *     window.PushBack(sample);
+ *     const RingRegion<const float> runs = window.Spans();
+ *     const float sum = std::reduce(runs.first.begin(), runs.first.end()) + std::reduce(runs.second.begin(), runs.second.end());
+ * }
+ * @endcode
+ */
+template<class T>
+class CircularBuffer
+{
+public:
+    /**
+     * @param capacity: number of elements the buffer holds, exactly
+     * @param overflow: what a push into a full buffer does
+     */
+    explicit CircularBuffer(const std::size_t capacity, const EOverflow overflow = EOverflow::Reject)
+        : CircularBuffer(capacity, overflow, nullptr)
+    {
+        if(capacity == 0)
+        {
+            throw std::invalid_argument("CircularBuffer: capacity must be positive");
+        }
+    }
+
+    CircularBuffer(const CircularBuffer& other) : CircularBuffer(other.m_capacity, other.m_overflow, nullptr)
+    {
+        for(std::size_t i = 0; i < other.m_size; ++i)
+        {
+            EmplaceBack(other[i]);
+        }
+    }
+
+    CircularBuffer(CircularBuffer&& other) noexcept
+        : m_slots(std::exchange(other.m_slots, nullptr)), m_capacity(std::exchange(other.m_capacity, 0)),
+          m_head(std::exchange(other.m_head, 0)), m_size(std::exchange(other.m_size, 0)), m_overflow(other.m_overflow)
+    {
+    }
+
+    CircularBuffer& operator=(CircularBuffer other) noexcept
+    {
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_head, other.m_head);
+        std::swap(m_size, other.m_size);
+        std::swap(m_overflow, other.m_overflow);
+        return *this;
+    }
+
+    ~CircularBuffer()
+    {
+        Clear();
+        if(m_slots != nullptr)
+        {
+            std::allocator<T>().deallocate(m_slots, m_capacity);
+        }
+    }
+
+    std::size_t Capacity() const noexcept { return m_capacity; }
+    std::size_t Size() const noexcept { return m_size; }
+    bool Empty() const noexcept { return m_size == 0; }
+    bool Full() const noexcept { return m_size == m_capacity; }
+    EOverflow Overflow() const noexcept { return m_overflow; }
+
+    /**
+     * @brief Construct an element behind the newest one.
+     * @return bool: false if the buffer is full and rejects or has been moved from, true
+     *               otherwise (also when the oldest element was overwritten)
+     */
+    template<class... Args>
+    bool EmplaceBack(Args&&... args)
+    {
+        if(m_size == m_capacity)
+        {
+            if(m_overflow == EOverflow::Reject || m_capacity == 0)
+            {
+                return false;
+            }
+            /* the slot of the oldest element is the one behind the back; the new element is
+               built first, so arguments may refer to the buffer and a throwing constructor
+               leaves it unchanged (a throwing move assignment may not) */
+            T value(std::forward<Args>(args)...);
+            m_slots[m_head] = std::move(value);
+            m_head = Wrap(m_head + 1);
+            return true;
+        }
+        std::construct_at(&m_slots[Wrap(m_head + m_size)], std::forward<Args>(args)...);
+        ++m_size;
+        return true;
+    }
+
+    bool PushBack(const T& value) { return EmplaceBack(value); }
+    bool PushBack(T&& value) { return EmplaceBack(std::move(value)); }
+
+    /**
+     * @brief Move the oldest element into `value`.
+     * @return bool: false if the buffer is empty, `value` is untouched then
+     */
+    bool PopFront(T& value)
+    {
+        if(m_size == 0)
+        {
+            return false;
+        }
+        value = std::move(m_slots[m_head]);
+        DropFront(1);
+        return true;
+    }
+
+    /* Destroy the `count` oldest elements, or all of them if there are fewer */
+    void DropFront(std::size_t count) noexcept
+    {
+        count = std::min(count, m_size);
+        const RingRegion<T> region = Region(0, count);
+        std::destroy(region.first.begin(), region.first.end());
+        std::destroy(region.second.begin(), region.second.end());
+        m_head = Wrap(m_head + count);
+        m_size -= count;
+    }
+
+    /* Destroy the `count` newest elements, or all of them if there are fewer */
+    void DropBack(std::size_t count) noexcept
+    {
+        count = std::min(count, m_size);
+        const RingRegion<T> region = Region(m_size - count, count);
+        std::destroy(region.first.begin(), region.first.end());
+        std::destroy(region.second.begin(), region.second.end());
+        m_size -= count;
+    }
+
+    void Clear() noexcept { DropFront(m_size); }
+
+    /* Element `index` in logical order, 0 the oldest; unchecked */
+    T& operator[](const std::size_t index) noexcept { return m_slots[Wrap(m_head + index)]; }
+    const T& operator[](const std::size_t index) const noexcept { return m_slots[Wrap(m_head + index)]; }
+
+    const T& At(const std::size_t index) const
+    {
+        if(index >= m_size)
+        {
+            throw std::out_of_range("CircularBuffer::At: index " + std::to_string(index) + " of " + std::to_string(m_size) + " elements");
+        }
+        return (*this)[index];
+    }
+
+    T& Front() noexcept { return (*this)[0]; }
+    const T& Front() const noexcept { return (*this)[0]; }
+    T& Back() noexcept { return (*this)[m_size - 1]; }
+    const T& Back() const noexcept { return (*this)[m_size - 1]; }
+
+    /* All elements, oldest first, as at most two contiguous runs */
+    RingRegion<T> Spans() noexcept { return Region(0, m_size); }
+    RingRegion<const T> Spans() const noexcept { return Const(Region(0, m_size)); }
+
+    /* The newest min(count, Size()) elements, oldest of them first */
+    RingRegion<T> Newest(std::size_t count) noexcept
+    {
+        count = std::min(count, m_size);
+        return Region(m_size - count, count);
+    }
+
+    RingRegion<const T> Newest(std::size_t count) const noexcept
+    {
+        count = std::min(count, m_size);
+        return Const(Region(m_size - count, count));
+    }
+
+private:
+    /* Any capacity, 0 only for the copy of a moved-from buffer */
+    CircularBuffer(const std::size_t capacity, const EOverflow overflow, std::nullptr_t) : m_capacity(capacity), m_overflow(overflow)
+    {
+        if(capacity != 0)
+        {
+            m_slots = std::allocator<T>().allocate(m_capacity);
+        }
+    }
+
+    std::size_t Wrap(const std::size_t index) const noexcept { return index >= m_capacity ? index - m_capacity : index; }
+
+    /* `count` elements from logical index `index` on */
+    RingRegion<T> Region(const std::size_t index, const std::size_t count) const noexcept
+    {
+        const std::size_t start = Wrap(m_head + index);
+        const std::size_t first = std::min(count, m_capacity - start);
+        return {std::span<T>(m_slots + start, first), std::span<T>(m_slots, count - first)};
+    }
+
+    static RingRegion<const T> Const(const RingRegion<T>& region) noexcept { return {region.first, region.second}; }
+
+    T* m_slots = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_head = 0;
+    std::size_t m_size = 0;
+    EOverflow m_overflow = EOverflow::Reject;
+};
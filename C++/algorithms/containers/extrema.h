@@ -0,0 +1,517 @@
+#pragma once
+
+/*
+ * extrema.h keeps track of maxima and minima under pushes and pops, and over sliding windows.
+ *
+ * Maximum_Stack_Element.cpp answers "largest element on the stack" by pushing the running
+ * maximum onto a second std::stack<int> with every element, twice the memory for one query, and
+ * it only works on ints read from cin.
+ *
+ *  - ExtremaStack: a stack with O(1) Push, Pop, Max and Min for any `T` and comparator. The
+ *    auxiliary stacks are compressed: they only grow when a value is a new (or equal) extremum
+ *    and store (value, count) runs, so on typical data they stay a small fraction of the stack
+ *    and a run of equal maxima costs one entry
+ *  - SlidingWindowExtrema: maximum and minimum of the newest `window` values of a stream, with
+ *    the classic monotonic deques (kept in CircularBuffers of capacity `window`), amortized O(1)
+ *    per value
+ *  - Sliding_Window_Max / Sliding_Window_Min: the same for a whole array and a fixed window,
+ *    after van Herk and Gil-Werman. The array is cut into blocks of `window` elements; the
+ *    window starting at i is the suffix of i's block from i on plus the prefix of the next
+ *    block up to i + window - 1, so out[i] = max(suffix[i], prefix[i + window - 1]). That is
+ *    three comparisons per element whatever the window and no data dependent branches. For
+ *    int32 and float the final combine runs in AVX2 / AVX-512, and with AVX-512 the block
+ *    prefix and suffix scans too, as scans of 16 lanes that stop at block boundaries. The work
+ *    is done one tile of blocks at a time so the prefix and suffix scratch stays in cache
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "common/cpu_features.h"
+#include "containers/circular_buffer.h"
+
+#if ALGORITHMS_X86
+#include <immintrin.h>
+#endif /* ALGORITHMS_X86 */
+
+/* Elements of output per block tile in Sliding_Window_Max / Min */
+constexpr std::size_t kExtremaTileElements = 16384;
+
+/**
+ * @brief Stack with constant time Max() and Min().
+ *
+ * Max() and Min() are with respect to `Compare`; among equal elements they return the one
+ * pushed first. Top, Max, Min and Pop require a non-empty stack.
+ *
+ * Example usage:
+ * @code
+ * ExtremaStack<int> stack;
+ * stack.Push(3); stack.Push(7); stack.Push(5);
+ * int largest = stack.Max();   // 7
+ * stack.Pop(); stack.Pop();
+ * largest = stack.Max();       // 3
+ * @endcode
+ */
+template<class T, class Compare = std::less<>>
+class ExtremaStack
+{
+public:
+    explicit ExtremaStack(Compare comp = {}) : m_comp(comp) {}
+
+    void Push(const T& value)
+    {
+        m_values.push_back(value);
+        Record(m_maxima, value, [&](const T& current) { return m_comp(current, value); });
+        Record(m_minima, value, [&](const T& current) { return m_comp(value, current); });
+    }
+
+    void Pop()
+    {
+        const T& value = m_values.back();
+        Forget(m_maxima, value);
+        Forget(m_minima, value);
+        m_values.pop_back();
+    }
+
+    const T& Top() const noexcept { return m_values.back(); }
+    const T& Max() const noexcept { return m_maxima.back().value; }
+    const T& Min() const noexcept { return m_minima.back().value; }
+    std::size_t Size() const noexcept { return m_values.size(); }
+    bool Empty() const noexcept { return m_values.empty(); }
+
+    /* Runs held by both auxiliary stacks together, at most 2 * Size() */
+    std::size_t AuxiliarySize() const noexcept { return m_maxima.size() + m_minima.size(); }
+
+private:
+    /*
+     * `count` consecutive extrema equal to `value`
+     */
+    struct Run
+    {
+        T value;
+        std::size_t count;
+    };
+
+    /* A new extremum starts a run, an equal one extends it, anything else leaves the stack alone */
+    template<class Improves>
+    void Record(std::vector<Run>& runs, const T& value, Improves improves)
+    {
+        if(runs.empty() || improves(runs.back().value))
+        {
+            runs.push_back({value, 1});
+        }
+        else if(!m_comp(value, runs.back().value) && !m_comp(runs.back().value, value))
+        {
+            ++runs.back().count;
+        }
+    }
+
+    /* Values recorded are never beaten by anything above them, so equality finds them again */
+    void Forget(std::vector<Run>& runs, const T& value)
+    {
+        Run& top = runs.back();
+        if(!m_comp(value, top.value) && !m_comp(top.value, value) && --top.count == 0)
+        {
+            runs.pop_back();
+        }
+    }
+
+    std::vector<T> m_values;
+    std::vector<Run> m_maxima;
+    std::vector<Run> m_minima;
+    Compare m_comp;
+};
+
+/**
+ * @brief Maximum and minimum of the newest `window` values of a stream.
+ *
+ * Each deque holds (value, position) candidates: the maxima deque strictly decreasing from the
+ * front, the minima deque strictly increasing, both dropping their front once it leaves the
+ * window. A candidate is pushed once and dropped once, so Push is amortized O(1). Max and Min
+ * require at least one pushed value.
+ *
+ * Example usage:
+ * @code
+ * SlidingWindowExtrema<float> lastSecond(1000);
+ * for(float sample : stream)
+ * {
+ *     lastSecond.Push(sample);
+ *     Plot(lastSecond.Min(), lastSecond.Max());
+ * }
+ * @endcode
+ */
+template<class T, class Compare = std::less<>>
+class SlidingWindowExtrema
+{
+public:
+    explicit SlidingWindowExtrema(const std::size_t window, Compare comp = {})
+        : m_maxima(std::max<std::size_t>(window, 1)), m_minima(std::max<std::size_t>(window, 1)), m_window(window), m_comp(comp)
+    {
+        if(window == 0)
+        {
+            throw std::invalid_argument("SlidingWindowExtrema: window must be positive");
+        }
+    }
+
+    void Push(const T& value)
+    {
+        Advance(m_maxima, value, [&](const T& candidate) { return m_comp(value, candidate); });
+        Advance(m_minima, value, [&](const T& candidate) { return m_comp(candidate, value); });
+        ++m_pushed;
+    }
+
+    const T& Max() const noexcept { return m_maxima.Front().value; }
+    const T& Min() const noexcept { return m_minima.Front().value; }
+    std::size_t Window() const noexcept { return m_window; }
+
+    /* Values currently in the window */
+    std::size_t Size() const noexcept { return static_cast<std::size_t>(std::min<std::uint64_t>(m_pushed, m_window)); }
+
+private:
+    struct Candidate
+    {
+        T value;
+        std::uint64_t position;
+    };
+
+    /* Expire the front, drop every candidate `value` beats from the back, then append it */
+    template<class Survives>
+    void Advance(CircularBuffer<Candidate>& candidates, const T& value, Survives survives)
+    {
+        if(!candidates.Empty() && candidates.Front().position + m_window <= m_pushed)
+        {
+            candidates.DropFront(1);
+        }
+        std::size_t kept = candidates.Size();
+        while(kept > 0 && !survives(candidates[kept - 1].value))
+        {
+            --kept;
+        }
+        candidates.DropBack(candidates.Size() - kept);
+        candidates.PushBack({value, m_pushed});
+    }
+
+    CircularBuffer<Candidate> m_maxima;
+    CircularBuffer<Candidate> m_minima;
+    std::size_t m_window;
+    std::uint64_t m_pushed = 0;
+    Compare m_comp;
+};
+
+namespace detail
+{
+    template<bool bMax, class T>
+    inline T Better(const T a, const T b) noexcept
+    {
+        if constexpr(bMax)
+        {
+            return a < b ? b : a;
+        }
+        else
+        {
+            return b < a ? b : a;
+        }
+    }
+
+    /* Running best from each block's start; `data` starts a block */
+    template<bool bMax, class T>
+    void Block_Prefix_Scalar(const T* data, std::size_t count, std::size_t window, T* out) noexcept
+    {
+        for(std::size_t blockStart = 0; blockStart < count; blockStart += window)
+        {
+            const std::size_t blockEnd = std::min(blockStart + window, count);
+            T running = data[blockStart];
+            out[blockStart] = running;
+            for(std::size_t j = blockStart + 1; j < blockEnd; ++j)
+            {
+                running = Better<bMax>(running, data[j]);
+                out[j] = running;
+            }
+        }
+    }
+
+    /* Running best up to each block's end; `data` starts a block and the last block ends at count */
+    template<bool bMax, class T>
+    void Block_Suffix_Scalar(const T* data, std::size_t count, std::size_t window, T* out) noexcept
+    {
+        for(std::size_t blockStart = 0; blockStart < count; blockStart += window)
+        {
+            std::size_t j = std::min(blockStart + window, count) - 1;
+            T running = data[j];
+            out[j] = running;
+            while(j-- > blockStart)
+            {
+                running = Better<bMax>(running, data[j]);
+                out[j] = running;
+            }
+        }
+    }
+
+    template<bool bMax, class T>
+    void Combine_Scalar(const T* suffix, const T* prefix, std::size_t count, T* out) noexcept
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = Better<bMax>(suffix[i], prefix[i]);
+        }
+    }
+
+#if ALGORITHMS_X86
+    template<bool bMax, class T>
+    __attribute__((target("avx2")))
+    void Combine_Avx2(const T* suffix, const T* prefix, std::size_t count, T* out) noexcept
+    {
+        std::size_t i = 0;
+        for(; i + 8 <= count; i += 8)
+        {
+            if constexpr(std::is_floating_point_v<T>)
+            {
+                const __m256 a = _mm256_loadu_ps(suffix + i);
+                const __m256 b = _mm256_loadu_ps(prefix + i);
+                _mm256_storeu_ps(out + i, bMax ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b));
+            }
+            else
+            {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(suffix + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prefix + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bMax ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b));
+            }
+        }
+        Combine_Scalar<bMax>(suffix + i, prefix + i, count - i, out + i);
+    }
+
+    /*
+     * AVX-512 building blocks on 16 lanes of int32 or float bits; the masked forms keep every
+     * lane defined
+     */
+    constexpr __mmask16 kAllLanes = 0xFFFF;
+
+    /* Lanes in `mask` get the better of a and b, the others keep src */
+    template<bool bMax, class T>
+    __attribute__((target("avx512f")))
+    inline __m512i Better_Avx512(__m512i src, __mmask16 mask, __m512i a, __m512i b) noexcept
+    {
+        if constexpr(std::is_floating_point_v<T>)
+        {
+            const __m512 x = _mm512_castsi512_ps(a);
+            const __m512 y = _mm512_castsi512_ps(b);
+            return _mm512_castps_si512(bMax ? _mm512_mask_max_ps(_mm512_castsi512_ps(src), mask, x, y) : _mm512_mask_min_ps(_mm512_castsi512_ps(src), mask, x, y));
+        }
+        else
+        {
+            return bMax ? _mm512_mask_max_epi32(src, mask, a, b) : _mm512_mask_min_epi32(src, mask, a, b);
+        }
+    }
+
+    template<bool bMax, class T>
+    __attribute__((target("avx512f")))
+    void Combine_Avx512(const T* suffix, const T* prefix, std::size_t count, T* out) noexcept
+    {
+        std::size_t i = 0;
+        for(; i + 16 <= count; i += 16)
+        {
+            const __m512i a = _mm512_loadu_si512(suffix + i);
+            _mm512_storeu_si512(out + i, Better_Avx512<bMax, T>(a, kAllLanes, a, _mm512_loadu_si512(prefix + i)));
+        }
+        Combine_Scalar<bMax>(suffix + i, prefix + i, count - i, out + i);
+    }
+
+    /* Offsets of positions base .. base + 15 inside their window sized blocks */
+    __attribute__((target("avx512f")))
+    inline __m512i Block_Offsets_Avx512(std::size_t base, std::size_t window) noexcept
+    {
+        alignas(64) std::int32_t offsets[16];
+        for(std::size_t lane = 0; lane < 16; ++lane)
+        {
+            offsets[lane] = static_cast<std::int32_t>((base + lane) % window);
+        }
+        return _mm512_load_si512(offsets);
+    }
+
+    /*
+     * Running best from each block's start, 16 positions per step: a Hillis-Steele scan inside
+     * the vector that only combines lanes of the same block, then the previous vector's last
+     * lane is folded into the lanes whose block began before this vector. `data` starts a block.
+     */
+    template<bool bMax, class T>
+    __attribute__((target("avx512f")))
+    void Block_Prefix_Avx512(const T* data, std::size_t count, std::size_t window, T* out) noexcept
+    {
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512i windowVector = _mm512_set1_epi32(static_cast<std::int32_t>(window));
+        const __m512i step = _mm512_set1_epi32(static_cast<std::int32_t>(16 % window));
+        __m512i offsets = Block_Offsets_Avx512(0, window);
+        __m512i carry = _mm512_setzero_si512();
+        for(std::size_t i = 0; i < count; i += 16)
+        {
+            const __mmask16 valid = count - i >= 16 ? kAllLanes : static_cast<__mmask16>((1u << (count - i)) - 1);
+            __m512i v = _mm512_maskz_loadu_epi32(valid, data + i);
+            /* earlier lanes of the same block, the rotations below wrap past lane 0 */
+            const __m512i reach = _mm512_mask_min_epi32(offsets, kAllLanes, offsets, lanes);
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(1)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 15));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(2)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 14));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(4)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 12));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(8)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 8));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpgt_epi32_mask(offsets, lanes), v, carry);
+            _mm512_mask_storeu_epi32(out + i, valid, v);
+            carry = _mm512_mask_permutexvar_epi32(v, kAllLanes, _mm512_set1_epi32(15), v);
+            offsets = _mm512_add_epi32(offsets, step);
+            offsets = _mm512_mask_sub_epi32(offsets, _mm512_cmpge_epi32_mask(offsets, windowVector), offsets, windowVector);
+        }
+    }
+
+    /*
+     * Running best up to each block's end, the mirror image of Block_Prefix_Avx512 walking from
+     * the back; `data` starts a block and the last block ends at count.
+     */
+    template<bool bMax, class T>
+    __attribute__((target("avx512f")))
+    void Block_Suffix_Avx512(const T* data, std::size_t count, std::size_t window, T* out) noexcept
+    {
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512i windowVector = _mm512_set1_epi32(static_cast<std::int32_t>(window));
+        const __m512i lastOffset = _mm512_set1_epi32(static_cast<std::int32_t>(window - 1));
+        const __m512i step = _mm512_set1_epi32(static_cast<std::int32_t>(16 % window));
+        const __m512i nextVector = _mm512_sub_epi32(_mm512_set1_epi32(16), lanes);
+        std::size_t i = (count - 1) / 16 * 16;
+        __m512i offsets = Block_Offsets_Avx512(i, window);
+        __m512i carry = _mm512_setzero_si512();
+        while(true)
+        {
+            const __mmask16 valid = count - i >= 16 ? kAllLanes : static_cast<__mmask16>((1u << (count - i)) - 1);
+            __m512i v = _mm512_maskz_loadu_epi32(valid, data + i);
+            /* positions left in the lane's block, negative past the end of the data */
+            const __m512i toBlockEnd = _mm512_sub_epi32(lastOffset, offsets);
+            const __m512i toDataEnd = _mm512_sub_epi32(_mm512_set1_epi32(static_cast<std::int32_t>(std::min<std::size_t>(count - 1 - i, 1u << 30))), lanes);
+            const __m512i remaining = _mm512_mask_mov_epi32(toBlockEnd, _mm512_cmpgt_epi32_mask(toBlockEnd, toDataEnd), toDataEnd);
+            /* later lanes of the same block, the rotations below wrap past lane 15 */
+            const __m512i reach = _mm512_mask_min_epi32(remaining, kAllLanes, remaining, _mm512_sub_epi32(_mm512_set1_epi32(15), lanes));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(1)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 1));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(2)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 2));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(4)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 4));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(reach, _mm512_set1_epi32(8)), v, _mm512_mask_alignr_epi32(v, kAllLanes, v, v, 8));
+            v = Better_Avx512<bMax, T>(v, _mm512_cmpge_epi32_mask(remaining, nextVector), v, carry);
+            _mm512_mask_storeu_epi32(out + i, valid, v);
+            if(i == 0)
+            {
+                break;
+            }
+            i -= 16;
+            carry = _mm512_mask_permutexvar_epi32(v, kAllLanes, _mm512_setzero_si512(), v);
+            offsets = _mm512_sub_epi32(offsets, step);
+            offsets = _mm512_mask_add_epi32(offsets, _mm512_cmplt_epi32_mask(offsets, _mm512_setzero_si512()), offsets, windowVector);
+        }
+    }
+#endif /* ALGORITHMS_X86 */
+
+    template<bool bMax, class T>
+    void Combine(const T* suffix, const T* prefix, std::size_t count, T* out, ESimdLevel level) noexcept
+    {
+#if ALGORITHMS_X86
+        if constexpr(std::is_same_v<T, std::int32_t> || std::is_same_v<T, float>)
+        {
+            if(level == ESimdLevel::Avx512)
+            {
+                return Combine_Avx512<bMax>(suffix, prefix, count, out);
+            }
+            if(level == ESimdLevel::Avx2)
+            {
+                return Combine_Avx2<bMax>(suffix, prefix, count, out);
+            }
+        }
+#endif /* ALGORITHMS_X86 */
+        (void)level;
+        Combine_Scalar<bMax>(suffix, prefix, count, out);
+    }
+
+    template<bool bMax, class T>
+    std::size_t Sliding_Window_Blocks(std::span<const T> data, std::size_t window, std::span<T> out, ESimdLevel level, const char* name)
+    {
+        static_assert(std::is_arithmetic_v<T>, "sliding window extrema compare arithmetic types with operator<");
+        if(window == 0)
+        {
+            throw std::invalid_argument(std::string(name) + ": window must be positive");
+        }
+        if(data.size() < window)
+        {
+            return 0;
+        }
+        const std::size_t outputs = data.size() - window + 1;
+        if(out.size() < outputs)
+        {
+            throw std::invalid_argument(std::string(name) + ": output holds " + std::to_string(out.size()) + " values, " + std::to_string(outputs) +
+                                        " needed");
+        }
+        const std::size_t tileBlocks = std::max<std::size_t>(kExtremaTileElements / window, 1);
+        /* AVX-512 scans keep block offsets in int32 lanes */
+        const bool bVectorScans = ALGORITHMS_X86 && level == ESimdLevel::Avx512 && (std::is_same_v<T, std::int32_t> || std::is_same_v<T, float>) &&
+                                  window < (std::size_t{1} << 30);
+        std::vector<T> suffix(tileBlocks * window);
+        std::vector<T> prefix((tileBlocks + 1) * window);
+        /* blocks start at multiples of the window, tiles at multiples of a block */
+        for(std::size_t begin = 0; begin < outputs; begin += tileBlocks * window)
+        {
+            const std::size_t end = std::min(outputs, begin + tileBlocks * window);
+            /* the suffixes run to the end of the tile's last block, the prefixes one block past the
+               tile, up to the last element of its last window */
+            const std::size_t suffixEnd = std::min(data.size(), begin + (end - begin + window - 1) / window * window);
+            const std::size_t prefixEnd = std::min(data.size(), end + window - 1);
+            if(bVectorScans)
+            {
+#if ALGORITHMS_X86
+                Block_Suffix_Avx512<bMax>(data.data() + begin, suffixEnd - begin, window, suffix.data());
+                Block_Prefix_Avx512<bMax>(data.data() + begin, prefixEnd - begin, window, prefix.data());
+#endif /* ALGORITHMS_X86 */
+            }
+            else
+            {
+                Block_Suffix_Scalar<bMax>(data.data() + begin, suffixEnd - begin, window, suffix.data());
+                Block_Prefix_Scalar<bMax>(data.data() + begin, prefixEnd - begin, window, prefix.data());
+            }
+            Combine<bMax>(suffix.data(), prefix.data() + window - 1, end - begin, out.data() + begin, level);
+        }
+        return outputs;
+    }
+} /* namespace detail */
+
+/**
+ * @brief out[i] = largest of data[i .. i + window - 1] for every full window.
+ *
+ * int32 and float use AVX2 for the combine step, AVX-512 for the block scans and the combine;
+ * other arithmetic types run scalar.
+ * Floats must not be NaN.
+ *
+ * Example usage:
+ * @code
+ * std::vector<float> peaks(samples.size() - 99);
+ * Sliding_Window_Max<float>(samples, 100, peaks);
+ * @endcode
+ *
+ * @param data: input values
+ * @param window: window length, positive
+ * @param out: at least data.size() - window + 1 values; throws std::invalid_argument if shorter
+ * @param level: SIMD level to use, defaults to the best one the CPU supports
+ *
+ * @return std::size_t: number of values written, 0 if data is shorter than one window
+ */
+template<class T>
+std::size_t Sliding_Window_Max(std::span<const T> data, std::size_t window, std::span<T> out, ESimdLevel level = Detect_Simd_Level())
+{
+    return detail::Sliding_Window_Blocks<true>(data, window, out, level, "Sliding_Window_Max");
+}
+
+/**
+ * @brief out[i] = smallest of data[i .. i + window - 1]; see Sliding_Window_Max.
+ */
+template<class T>
+std::size_t Sliding_Window_Min(std::span<const T> data, std::size_t window, std::span<T> out, ESimdLevel level = Detect_Simd_Level())
+{
+    return detail::Sliding_Window_Blocks<false>(data, window, out, level, "Sliding_Window_Min");
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+/*
+ * mpmc_queue.h is a bounded queue for any number of producer and consumer threads.
+ *
+ * circularqueueusingarray.c keeps its queue in the globals CQ[MAX], front, rear and count, so a
+ * program has exactly one queue and it must never be touched by two threads. MpmcQueue is the
+ * same circular array as an object, and safe under contention, after Dmitry Vyukov's bounded
+ * MPMC queue:
+ *
+ *  - every slot carries a sequence number; slot i starts at i. A producer at position p may
+ *    write the slot when its sequence is p and publishes it by storing p + 1, a consumer at
+ *    position p may read it when its sequence is p + 1 and frees it for the next lap by storing
+ *    p + capacity. The sequence alone orders the element, so there is no lock and no shared
+ *    count, and producers only meet each other on the enqueue position, consumers on the
+ *    dequeue position, each on its own cache line
+ *  - TryPush / TryPop claim a position with a compare exchange only once the slot is ready. A
+ *    slot that is not ready means full (empty) only if no consumer (producer) has claimed it
+ *    yet; otherwise that thread is between its claim and its sequence store and the call
+ *    yields until it is done. Failing there instead, as the original does, reports full or
+ *    empty while a push or pop that already returned says otherwise, which is not linearizable
+ *  - Push / Pop claim the next position unconditionally with a fetch_add, which makes that slot
+ *    theirs for the lap, then wait on the slot's sequence: a short yield loop first, then
+ *    std::atomic::wait (a futex on Linux) so a blocked thread sleeps instead of spinning. The
+ *    side that changes a sequence notifies only when somebody sleeps, counted in m_sleepers
+ *
+ * Try and blocking calls may be mixed freely on one queue.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+/* Yield rounds before a blocking Push / Pop goes to sleep on a slot */
+constexpr unsigned kMpmcSpinRounds = 64;
+
+/**
+ * @brief Bounded multi producer, multi consumer FIFO of `T`.
+ *
+ * Elements are handed out in the order their pushes claimed positions; with several producers
+ * that is the linearization order of the pushes. A position is claimed before the element is
+ * constructed, so constructors and move assignment of `T` must not throw.
+ *
+ * Example usage:
+ * @code
+ * MpmcQueue<Job> queue(4096);
+ * for(unsigned i = 0; i < workers; ++i) { pool.emplace_back([&] { while(true) { Job job = queue.Pop(); if(job.bStop) { break; } job.Run(); } }); }
+ * queue.Push(Job{...});
+ * @endcode
+ */
+template<class T>
+class MpmcQueue
+{
+public:
+    /**
+     * @param capacity: minimum number of elements, rounded up to a power of two and to at least
+     *                  2: with one slot, "published for consumer p" and "free for producer
+     *                  p + 1" would be the same sequence number
+     */
+    explicit MpmcQueue(const std::size_t capacity)
+    {
+        if(capacity == 0 || capacity > (std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 2)))
+        {
+            throw std::invalid_argument("MpmcQueue: capacity " + std::to_string(capacity) + " must be positive and representable");
+        }
+        m_capacity = std::bit_ceil(std::max<std::size_t>(capacity, 2));
+        m_mask = m_capacity - 1;
+        m_slots = std::allocator<Slot>().allocate(m_capacity);
+        for(std::size_t i = 0; i < m_capacity; ++i)
+        {
+            std::construct_at(&m_slots[i].sequence, i);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /* No thread may still be inside a call */
+    ~MpmcQueue()
+    {
+        const std::size_t tail = m_enqueue.position.load(std::memory_order_relaxed);
+        for(std::size_t head = m_dequeue.position.load(std::memory_order_relaxed); head != tail; ++head)
+        {
+            std::destroy_at(m_slots[head & m_mask].Element());
+        }
+        for(std::size_t i = 0; i < m_capacity; ++i)
+        {
+            std::destroy_at(&m_slots[i].sequence);
+        }
+        std::allocator<Slot>().deallocate(m_slots, m_capacity);
+    }
+
+    std::size_t Capacity() const noexcept { return m_capacity; }
+
+    /* Claimed pushes minus claimed pops, clamped to [0, capacity]; a snapshot under contention */
+    std::size_t Size() const noexcept
+    {
+        const std::size_t head = m_dequeue.position.load(std::memory_order_acquire);
+        const std::size_t tail = m_enqueue.position.load(std::memory_order_acquire);
+        const std::ptrdiff_t size = static_cast<std::ptrdiff_t>(tail - head);
+        return size <= 0 ? 0 : std::min(static_cast<std::size_t>(size), m_capacity);
+    }
+
+    bool Empty() const noexcept { return Size() == 0; }
+
+    template<class... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        std::size_t position = m_enqueue.position.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence - position);
+            if(lag == 0)
+            {
+                if(m_enqueue.position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    std::construct_at(slot.Element(), std::forward<Args>(args)...);
+                    Publish(slot, position + 1);
+                    return true;
+                }
+            }
+            else if(lag < 0)
+            {
+                /* last lap's element is still here; full unless a consumer is already taking it */
+                if(static_cast<std::ptrdiff_t>(position - m_dequeue.position.load(std::memory_order_acquire)) >= static_cast<std::ptrdiff_t>(m_capacity))
+                {
+                    return false;
+                }
+                std::this_thread::yield();
+                position = m_enqueue.position.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                position = m_enqueue.position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPush(const T& value) { return TryEmplace(value); }
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    /**
+     * @brief Move the oldest element into `value`.
+     * @return bool: false if the queue is empty, `value` is untouched then
+     */
+    bool TryPop(T& value)
+    {
+        std::size_t position = m_dequeue.position.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+            if(lag == 0)
+            {
+                if(m_dequeue.position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(*slot.Element());
+                    Release(slot, position);
+                    return true;
+                }
+            }
+            else if(lag < 0)
+            {
+                /* nothing published here; empty unless a producer has already claimed the slot */
+                if(static_cast<std::ptrdiff_t>(m_enqueue.position.load(std::memory_order_acquire) - position) <= 0)
+                {
+                    return false;
+                }
+                std::this_thread::yield();
+                position = m_dequeue.position.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                position = m_dequeue.position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /* Wait for room, then emplace */
+    template<class... Args>
+    void Emplace(Args&&... args)
+    {
+        const std::size_t position = m_enqueue.position.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_slots[position & m_mask];
+        Await(slot, position);
+        std::construct_at(slot.Element(), std::forward<Args>(args)...);
+        Publish(slot, position + 1);
+    }
+
+    void Push(const T& value) { Emplace(value); }
+    void Push(T&& value) { Emplace(std::move(value)); }
+
+    /* Wait for an element and return it */
+    T Pop()
+    {
+        const std::size_t position = m_dequeue.position.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_slots[position & m_mask];
+        Await(slot, position + 1);
+        T value = std::move(*slot.Element());
+        Release(slot, position);
+        return value;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* Element() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    struct alignas(64) Position
+    {
+        std::atomic<std::size_t> position = 0;
+    };
+
+    /* Destroy the element read at `position` and hand the slot to the next lap's producer */
+    void Release(Slot& slot, const std::size_t position)
+    {
+        std::destroy_at(slot.Element());
+        Publish(slot, position + m_capacity);
+    }
+
+    void Publish(Slot& slot, const std::size_t sequence)
+    {
+        slot.sequence.store(sequence, std::memory_order_release);
+        /* pairs with the sleeper's m_sleepers increment: either it sees the sequence or we see it */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(m_sleepers.load(std::memory_order_relaxed) > 0)
+        {
+            slot.sequence.notify_all();
+        }
+    }
+
+    /* Block until the slot's sequence reaches `sequence`, which only the thread owning the previous step can store */
+    void Await(Slot& slot, const std::size_t sequence)
+    {
+        for(unsigned round = 0; round < kMpmcSpinRounds; ++round)
+        {
+            if(slot.sequence.load(std::memory_order_acquire) == sequence)
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        m_sleepers.fetch_add(1);
+        while(true)
+        {
+            const std::size_t current = slot.sequence.load();
+            if(current == sequence)
+            {
+                break;
+            }
+            slot.sequence.wait(current);
+        }
+        m_sleepers.fetch_sub(1);
+    }
+
+    Position m_enqueue;
+    Position m_dequeue;
+    /* threads asleep in Await */
+    alignas(64) std::atomic<std::uint32_t> m_sleepers = 0;
+    /* read only after construction */
+    alignas(64) Slot* m_slots = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_mask = 0;
+};
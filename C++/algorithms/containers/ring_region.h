@@ -0,0 +1,29 @@
+#pragma once
+
+/*
+ * ring_region.h is the view the ring containers hand out over consecutive slots of their array.
+ *
+ * Slots that run past the end of the array continue at its start, so a run of them is one or
+ * two contiguous pieces. Handing those out as spans lets callers copy, construct or reduce over
+ * plain arrays (which the compiler vectorizes) instead of going through an index wrap per
+ * element.
+ */
+
+#include <cstddef>
+#include <span>
+
+/**
+ * @brief Consecutive ring slots, split in two spans where they wrap past the end of the array.
+ *
+ * `second` is empty unless the region wraps; with a double mapped SpscRing it is always empty.
+ */
+template<class T>
+struct RingRegion
+{
+    std::span<T> first;
+    std::span<T> second;
+
+    std::size_t Size() const noexcept { return first.size() + second.size(); }
+    bool Empty() const noexcept { return Size() == 0; }
+    T& operator[](const std::size_t i) const noexcept { return i < first.size() ? first[i] : second[i - first.size()]; }
+};
@@ -0,0 +1,350 @@
+#pragma once
+
+/*
+ * spsc_ring.h is a lock free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * `Queue` in Circular Queue.cpp marks emptiness with front == -1, detects full with a modulo
+ * test, (front - 1) % (size - 1), that is only right together with a separate front == 0 case,
+ * prints on full or empty, returns INT_MIN as an error, and works on one thread only.
+ * SpscRing keeps the same idea, a fixed array used circularly, and makes it fast across threads:
+ *
+ *  - head and tail are free running counters; the slot is counter & (capacity - 1) with the
+ *    capacity rounded up to a power of two, and tail - head is the size, so full and empty
+ *    need no sentinel and every slot is usable
+ *  - the producer alone writes the tail and the consumer alone writes the head, each published
+ *    with a release store and read by the other side with an acquire load, which orders the
+ *    element itself
+ *  - each side keeps a cached copy of the other side's counter on its own cache line and only
+ *    reloads it when the cached value says full (producer) or empty (consumer), so in steady
+ *    state the two cores do not bounce a cache line per element
+ *  - PushBulk / PopBulk move up to a span of elements with one counter update
+ *  - ReserveWrite / CommitWrite and ReserveRead / CommitRead skip even that copy: they hand out
+ *    the free (filled) slots themselves as a RingRegion, two spans when the region wraps past
+ *    the end of the array, so a producer constructs elements in place and a consumer works on
+ *    them where they lie; one counter store publishes the whole batch
+ *  - ERingBacking::DoubleMapped maps the same memory twice back to back (memfd_create and two
+ *    mmap calls), so slot capacity + i is slot i and every region is a single span; this needs
+ *    a trivially copyable `T` and Linux, and rounds the capacity up to a whole number of pages
+ *
+ * Failure is a false return, a short count or an empty region, never an error value or a
+ * message.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "containers/ring_region.h"
+
+/*
+ * Where a ring keeps its slots
+ */
+enum class ERingBacking : int
+{
+    Heap,
+    DoubleMapped,
+    AutoCount /* Should be last! Number of backings */
+};
+
+inline const char* Ring_Backing_Name(const ERingBacking backing) noexcept
+{
+    switch(backing)
+    {
+        case ERingBacking::Heap: return "heap";
+        case ERingBacking::DoubleMapped: return "double mapped";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Bounded single producer, single consumer FIFO of `T`.
+ *
+ * Push side calls (TryPush, TryEmplace, PushBulk) must come from one thread, pop side calls
+ * (TryPop, PopBulk) from one other thread. Size queries are exact on either side only with
+ * respect to that side's own operations.
+ *
+ * Example usage:
+ * @code
+ * SpscRing<Packet> ring(1024);
+ * std::jthread consumer([&] { Packet packet; while(running) { if(ring.TryPop(packet)) { Handle(packet); } } });
+ * while(!ring.TryPush(Receive())) { std::this_thread::yield(); }
+ * @endcode
+ */
+template<class T>
+class SpscRing
+{
+public:
+    /**
+     * @param capacity: minimum number of elements, rounded up to a power of two (and for a double
+     *                  mapped ring to a whole number of pages)
+     * @param backing: ERingBacking::DoubleMapped throws std::runtime_error where it is unavailable
+     */
+    explicit SpscRing(const std::size_t capacity, const ERingBacking backing = ERingBacking::Heap)
+        : m_backing(backing)
+    {
+        if(capacity == 0 || capacity > (std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 2)) / sizeof(T))
+        {
+            throw std::invalid_argument("SpscRing: capacity " + std::to_string(capacity) + " must be positive and representable");
+        }
+        m_capacity = std::bit_ceil(capacity);
+        if(backing == ERingBacking::DoubleMapped)
+        {
+            Map_Twice();
+        }
+        else
+        {
+            m_slots = std::allocator<T>().allocate(m_capacity);
+        }
+        m_mask = m_capacity - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing()
+    {
+        const std::size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        for(std::size_t head = m_consumer.head.load(std::memory_order_relaxed); head != tail; ++head)
+        {
+            std::destroy_at(&m_slots[head & m_mask]);
+        }
+        if(m_backing == ERingBacking::DoubleMapped)
+        {
+            ::munmap(m_slots, 2 * m_capacity * sizeof(T));
+        }
+        else
+        {
+            std::allocator<T>().deallocate(m_slots, m_capacity);
+        }
+    }
+
+    std::size_t Capacity() const noexcept { return m_capacity; }
+    ERingBacking Backing() const noexcept { return m_backing; }
+
+    /* Elements in the ring; only a snapshot while the other side is running */
+    std::size_t Size() const noexcept
+    {
+        return m_producer.tail.load(std::memory_order_acquire) - m_consumer.head.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const noexcept { return Size() == 0; }
+
+    template<class... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        const std::size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        if(tail - m_producer.cachedHead == m_capacity)
+        {
+            m_producer.cachedHead = m_consumer.head.load(std::memory_order_acquire);
+            if(tail - m_producer.cachedHead == m_capacity)
+            {
+                return false;
+            }
+        }
+        std::construct_at(&m_slots[tail & m_mask], std::forward<Args>(args)...);
+        m_producer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& value) { return TryEmplace(value); }
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    /**
+     * @brief Move the oldest element into `value`.
+     * @return bool: false if the ring is empty, `value` is untouched then
+     */
+    bool TryPop(T& value)
+    {
+        const std::size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        if(head == m_consumer.cachedTail)
+        {
+            m_consumer.cachedTail = m_producer.tail.load(std::memory_order_acquire);
+            if(head == m_consumer.cachedTail)
+            {
+                return false;
+            }
+        }
+        T& slot = m_slots[head & m_mask];
+        value = std::move(slot);
+        std::destroy_at(&slot);
+        m_consumer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy as many of `values` as fit, in order, and publish them at once.
+     * @return std::size_t: number of elements pushed, 0 if the ring is full
+     */
+    std::size_t PushBulk(std::span<const T> values)
+    {
+        const RingRegion<T> region = ReserveWrite(values.size());
+        std::uninitialized_copy_n(values.data(), region.first.size(), region.first.data());
+        std::uninitialized_copy_n(values.data() + region.first.size(), region.second.size(), region.second.data());
+        CommitWrite(region.Size());
+        return region.Size();
+    }
+
+    /**
+     * @brief Move up to values.size() of the oldest elements into `values`.
+     * @return std::size_t: number of elements popped, 0 if the ring is empty
+     */
+    std::size_t PopBulk(std::span<T> values)
+    {
+        const RingRegion<T> region = ReserveRead(values.size());
+        T* out = values.data();
+        for(const std::span<T> run : {region.first, region.second})
+        {
+            out = std::move(run.begin(), run.end(), out);
+        }
+        CommitRead(region.Size());
+        return region.Size();
+    }
+
+    /**
+     * @brief Hand out up to `maxCount` free slots, oldest first, without publishing anything.
+     *
+     * The slots hold no objects: construct the first n of them in order (std::construct_at or
+     * plain assignment for trivial `T`), then CommitWrite(n). Producer side only; the region
+     * stays valid until the next producer side call.
+     *
+     * Example usage:
+     * @code
+     * const RingRegion<Packet> region = ring.ReserveWrite(32);
+     * for(std::size_t i = 0; i < region.Size(); ++i) { std::construct_at(&region[i], Receive()); }
+     * ring.CommitWrite(region.Size());
+     * @endcode
+     * @return RingRegion<T>: empty if the ring is full
+     */
+    RingRegion<T> ReserveWrite(const std::size_t maxCount) noexcept
+    {
+        const std::size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        if(m_capacity - (tail - m_producer.cachedHead) < maxCount)
+        {
+            m_producer.cachedHead = m_consumer.head.load(std::memory_order_acquire);
+        }
+        return Region(tail, std::min(maxCount, m_capacity - (tail - m_producer.cachedHead)));
+    }
+
+    /* Publish the first `count` slots of the last ReserveWrite, which must now hold elements */
+    void CommitWrite(const std::size_t count) noexcept
+    {
+        m_producer.tail.store(m_producer.tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Hand out up to `maxCount` of the oldest elements in place, without removing them.
+     *
+     * Consumer side only; the region stays valid until the next consumer side call. CommitRead(n)
+     * destroys the first n and gives their slots back to the producer.
+     * @return RingRegion<T>: empty if the ring is empty
+     */
+    RingRegion<T> ReserveRead(const std::size_t maxCount) noexcept
+    {
+        const std::size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        if(m_consumer.cachedTail - head < maxCount)
+        {
+            m_consumer.cachedTail = m_producer.tail.load(std::memory_order_acquire);
+        }
+        return Region(head, std::min(maxCount, m_consumer.cachedTail - head));
+    }
+
+    /* Remove the first `count` elements of the last ReserveRead */
+    void CommitRead(const std::size_t count) noexcept
+    {
+        const std::size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        if constexpr(!std::is_trivially_destructible_v<T>)
+        {
+            const RingRegion<T> region = Region(head, count);
+            std::destroy(region.first.begin(), region.first.end());
+            std::destroy(region.second.begin(), region.second.end());
+        }
+        m_consumer.head.store(head + count, std::memory_order_release);
+    }
+
+private:
+    RingRegion<T> Region(const std::size_t position, const std::size_t count) const noexcept
+    {
+        const std::size_t offset = position & m_mask;
+        const std::size_t first = m_backing == ERingBacking::DoubleMapped ? count : std::min(count, m_capacity - offset);
+        return {std::span<T>(m_slots + offset, first), std::span<T>(m_slots, count - first)};
+    }
+
+    /* Reserve twice the bytes, then map one memfd over both halves */
+    void Map_Twice()
+    {
+#if defined(__linux__)
+        if constexpr(!std::is_trivially_copyable_v<T>)
+        {
+            throw std::invalid_argument("SpscRing: a double mapped ring needs a trivially copyable element type");
+        }
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        m_capacity = std::max(m_capacity, page / std::gcd(page, sizeof(T)));
+        const std::size_t bytes = m_capacity * sizeof(T);
+        const int descriptor = ::memfd_create("spsc_ring", MFD_CLOEXEC);
+        if(descriptor < 0)
+        {
+            throw std::runtime_error(std::string("SpscRing: memfd_create failed: ") + std::strerror(errno));
+        }
+        void* base = MAP_FAILED;
+        if(::ftruncate(descriptor, static_cast<off_t>(bytes)) == 0)
+        {
+            base = ::mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        bool bMapped = base != MAP_FAILED;
+        for(std::size_t half = 0; half < 2 && bMapped; ++half)
+        {
+            char* const address = static_cast<char*>(base) + half * bytes;
+            bMapped = ::mmap(address, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, descriptor, 0) == address;
+        }
+        const int error = errno;
+        ::close(descriptor);
+        if(!bMapped)
+        {
+            if(base != MAP_FAILED)
+            {
+                ::munmap(base, 2 * bytes);
+            }
+            throw std::runtime_error(std::string("SpscRing: double mapping failed: ") + std::strerror(error));
+        }
+        m_slots = static_cast<T*>(base);
+#else
+        throw std::runtime_error("SpscRing: double mapping needs Linux");
+#endif
+    }
+
+    /* written by the producer only; cachedHead is its last seen copy of the head */
+    struct alignas(64) ProducerSide
+    {
+        std::atomic<std::size_t> tail = 0;
+        std::size_t cachedHead = 0;
+    };
+
+    /* written by the consumer only; cachedTail is its last seen copy of the tail */
+    struct alignas(64) ConsumerSide
+    {
+        std::atomic<std::size_t> head = 0;
+        std::size_t cachedTail = 0;
+    };
+
+    ProducerSide m_producer;
+    ConsumerSide m_consumer;
+    /* read only after construction, shared by both sides */
+    alignas(64) T* m_slots = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_mask = 0;
+    ERingBacking m_backing = ERingBacking::Heap;
+};
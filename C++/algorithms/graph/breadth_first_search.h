@@ -0,0 +1,317 @@
+#pragma once
+
+/*
+ * breadth_first_search.h is a parallel, direction optimizing BFS over CsrGraph.
+ *
+ * DFS in C Program/dfs.c recurses once per vertex and prints as it goes; for reachability and
+ * hop distances on large graphs a level synchronous BFS parallelizes far better. Each level is
+ * expanded one of two ways (Beamer, Asanovic, Patterson):
+ *
+ *  - top-down: every frontier vertex scans its out-edges and claims unvisited targets by an
+ *    atomic fetch_or on the visited bitset. Cheap while the frontier is small.
+ *  - bottom-up: every unvisited vertex scans its in-edges until it finds a parent in the
+ *    frontier bitset, then stops. On the few huge middle levels of a small world graph most
+ *    edges of the frontier lead to visited vertices anyway, and bottom-up skips them. Threads
+ *    own whole 64 vertex words here, so no atomics are needed.
+ *
+ * The switch follows the paper: go bottom-up once the frontier's edges exceed 1 / kBfsAlpha of
+ * the edges still unexplored, and back top-down once the frontier shrinks below 1 / kBfsBeta of
+ * the vertices. Work inside a level is handed out in blocks through an atomic cursor, since
+ * RMAT degrees are far too skewed for static chunks. The team of threads lives for the whole
+ * search and meets at a barrier twice per level.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/parallel.h"
+#include "graph/csr_graph.h"
+
+/* Switch to bottom-up when frontier edges > unexplored edges / kBfsAlpha */
+constexpr std::uint64_t kBfsAlpha = 14;
+/* Switch back to top-down when frontier vertices < vertices / kBfsBeta */
+constexpr std::uint64_t kBfsBeta = 24;
+/* Frontier vertices per cursor step top-down, 64 vertex words per step bottom-up */
+constexpr std::size_t kBfsTopDownBlock = 64;
+constexpr std::size_t kBfsBottomUpBlock = 16;
+
+constexpr std::uint32_t kBfsUnreached = std::numeric_limits<std::uint32_t>::max();
+
+/*
+ * How Breadth_First_Search expands each level
+ */
+enum class EBfsDirection : int
+{
+    Auto,
+    TopDown,
+    BottomUp,
+    AutoCount /* Should be last! Number of directions */
+};
+
+inline const char* Bfs_Direction_Name(const EBfsDirection direction) noexcept
+{
+    switch(direction)
+    {
+        case EBfsDirection::TopDown:
+            return "top-down";
+        case EBfsDirection::BottomUp:
+            return "bottom-up";
+        case EBfsDirection::Auto:
+        default:
+            return "direction optimizing";
+    }
+}
+
+/*
+ * Result of Breadth_First_Search
+ */
+struct BfsResult
+{
+    std::vector<std::uint32_t> distance; /* hops from the source, kBfsUnreached if unreachable */
+    std::vector<VertexId> parent;        /* predecessor on a shortest path, the source is its own parent */
+    std::size_t reachedVertices = 0;
+    std::size_t topDownLevels = 0;
+    std::size_t bottomUpLevels = 0;
+
+    bool Reached(const VertexId vertex) const noexcept { return distance[vertex] != kBfsUnreached; }
+};
+
+/**
+ * @brief Parallel BFS from `source`, switching between top-down and bottom-up per level.
+ *
+ * @param graph: out-edges
+ * @param transpose: in-edges of the same graph, for the bottom-up steps; pass `graph` itself
+ *        when it is symmetric
+ * @param source: start vertex
+ * @param threads: size of the thread team
+ * @param direction: Auto, or force one expansion for every level
+ * @return BfsResult: distances and a BFS tree as parent pointers
+ *
+ * Example usage:
+ * @code
+ * const CsrGraph<> graph = CsrGraph<>::From_Edges(vertexCount, Symmetrize_Edges(edges));
+ * const BfsResult bfs = Breadth_First_Search(graph, graph, source, 8);
+ * @endcode
+ */
+template<class Weight>
+BfsResult Breadth_First_Search(const CsrGraph<Weight>& graph, const CsrGraph<Weight>& transpose, const VertexId source,
+                               unsigned threads = Default_Thread_Count(), const EBfsDirection direction = EBfsDirection::Auto)
+{
+    const std::size_t vertexCount = graph.VertexCount();
+    if(source >= vertexCount || transpose.VertexCount() != vertexCount)
+    {
+        throw std::out_of_range("Breadth_First_Search: source " + std::to_string(source) + " outside of " + std::to_string(vertexCount) +
+                                " vertices or transpose of a different size");
+    }
+    threads = std::max(threads, 1u);
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    const std::span<const EdgeId> inOffsets = transpose.Offsets();
+    const std::span<const VertexId> inSources = transpose.Targets();
+    const std::size_t wordCount = (vertexCount + 63) / 64;
+
+    BfsResult result;
+    result.distance.assign(vertexCount, kBfsUnreached);
+    result.parent.assign(vertexCount, std::numeric_limits<VertexId>::max());
+    result.distance[source] = 0;
+    result.parent[source] = source;
+
+    /* bits past the last vertex count as visited, so bottom-up never looks at them */
+    std::vector<std::uint64_t> visited(wordCount, 0);
+    if(vertexCount % 64 != 0)
+    {
+        visited.back() = ~std::uint64_t{0} << (vertexCount % 64);
+    }
+    visited[source / 64] |= std::uint64_t{1} << (source % 64);
+    std::vector<std::uint64_t> frontierBits;
+    std::vector<std::uint64_t> nextBits;
+    std::vector<VertexId> queue = {source};
+    std::vector<std::vector<VertexId>> nextQueues(threads);
+
+    struct alignas(64) Tally
+    {
+        std::size_t vertices = 0;
+        std::uint64_t edges = 0;
+    };
+    std::vector<Tally> tallies(threads);
+
+    bool bBottomUp = direction == EBfsDirection::BottomUp;
+    if(bBottomUp)
+    {
+        frontierBits.assign(wordCount, 0);
+        frontierBits[source / 64] |= std::uint64_t{1} << (source % 64);
+        nextBits.assign(wordCount, 0);
+    }
+    std::size_t frontierVertices = 1;
+    std::uint64_t unexploredEdges = graph.EdgeCount() - graph.OutDegree(source);
+    std::uint32_t level = 0;
+    bool bDone = false;
+    std::atomic<std::size_t> cursor = 0;
+    std::barrier barrier(threads);
+
+    auto topDown = [&](const unsigned thread)
+    {
+        Tally& tally = tallies[thread];
+        std::vector<VertexId>& next = nextQueues[thread];
+        for(std::size_t begin = cursor.fetch_add(kBfsTopDownBlock); begin < queue.size(); begin = cursor.fetch_add(kBfsTopDownBlock))
+        {
+            for(std::size_t i = begin; i < std::min(begin + kBfsTopDownBlock, queue.size()); ++i)
+            {
+                const VertexId vertex = queue[i];
+                for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+                {
+                    const VertexId target = targets[edge];
+                    const std::uint64_t bit = std::uint64_t{1} << (target % 64);
+                    std::atomic_ref<std::uint64_t> word(visited[target / 64]);
+                    /* test before the locked or: most targets are visited already */
+                    if((word.load(std::memory_order_relaxed) & bit) != 0 || (word.fetch_or(bit, std::memory_order_relaxed) & bit) != 0)
+                    {
+                        continue;
+                    }
+                    result.parent[target] = vertex;
+                    result.distance[target] = level + 1;
+                    next.push_back(target);
+                    tally.edges += graph.OutDegree(target);
+                }
+            }
+        }
+        tally.vertices = next.size();
+    };
+
+    auto bottomUp = [&](const unsigned thread)
+    {
+        Tally& tally = tallies[thread];
+        tally = {};
+        for(std::size_t begin = cursor.fetch_add(kBfsBottomUpBlock); begin < wordCount; begin = cursor.fetch_add(kBfsBottomUpBlock))
+        {
+            for(std::size_t word = begin; word < std::min(begin + kBfsBottomUpBlock, wordCount); ++word)
+            {
+                std::uint64_t unvisited = ~visited[word];
+                std::uint64_t found = 0;
+                while(unvisited != 0)
+                {
+                    const VertexId vertex = static_cast<VertexId>(word * 64 + static_cast<std::size_t>(std::countr_zero(unvisited)));
+                    unvisited &= unvisited - 1;
+                    for(EdgeId edge = inOffsets[vertex]; edge < inOffsets[vertex + 1]; ++edge)
+                    {
+                        const VertexId parent = inSources[edge];
+                        if((frontierBits[parent / 64] >> (parent % 64)) & 1)
+                        {
+                            result.parent[vertex] = parent;
+                            result.distance[vertex] = level + 1;
+                            found |= std::uint64_t{1} << (vertex % 64);
+                            ++tally.vertices;
+                            tally.edges += graph.OutDegree(vertex);
+                            break;
+                        }
+                    }
+                }
+                visited[word] |= found;
+                nextBits[word] = found;
+            }
+        }
+    };
+
+    /* thread 0, between the barriers: turn this level's output into the next frontier */
+    auto advance = [&]
+    {
+        std::size_t nextVertices = 0;
+        std::uint64_t nextEdges = 0;
+        for(Tally& tally : tallies)
+        {
+            nextVertices += tally.vertices;
+            nextEdges += tally.edges;
+            tally = {};
+        }
+        (bBottomUp ? result.bottomUpLevels : result.topDownLevels) += 1;
+        const bool bWasBottomUp = bBottomUp;
+        if(direction == EBfsDirection::Auto)
+        {
+            bBottomUp = bBottomUp ? !(nextVertices < frontierVertices && nextVertices < vertexCount / kBfsBeta)
+                                  : nextEdges > unexploredEdges / kBfsAlpha;
+        }
+        unexploredEdges -= std::min(unexploredEdges, nextEdges);
+        frontierVertices = nextVertices;
+        result.reachedVertices += nextVertices;
+        ++level;
+        cursor.store(0, std::memory_order_relaxed);
+        bDone = nextVertices == 0;
+
+        if(!bWasBottomUp)
+        {
+            queue.clear();
+            for(std::vector<VertexId>& next : nextQueues)
+            {
+                queue.insert(queue.end(), next.begin(), next.end());
+                next.clear();
+            }
+            if(bBottomUp)
+            {
+                frontierBits.assign(wordCount, 0);
+                nextBits.resize(wordCount);
+                for(VertexId vertex : queue)
+                {
+                    frontierBits[vertex / 64] |= std::uint64_t{1} << (vertex % 64);
+                }
+            }
+            return;
+        }
+        frontierBits.swap(nextBits);
+        if(!bBottomUp)
+        {
+            queue.clear();
+            for(std::size_t word = 0; word < wordCount; ++word)
+            {
+                for(std::uint64_t bits = frontierBits[word]; bits != 0; bits &= bits - 1)
+                {
+                    queue.push_back(static_cast<VertexId>(word * 64 + static_cast<std::size_t>(std::countr_zero(bits))));
+                }
+            }
+        }
+    };
+
+    auto work = [&](const unsigned thread)
+    {
+        while(true)
+        {
+            if(bBottomUp)
+            {
+                bottomUp(thread);
+            }
+            else
+            {
+                topDown(thread);
+            }
+            barrier.arrive_and_wait();
+            if(thread == 0)
+            {
+                advance();
+            }
+            barrier.arrive_and_wait();
+            if(bDone)
+            {
+                return;
+            }
+        }
+    };
+
+    result.reachedVertices = 1;
+    std::vector<std::jthread> team;
+    team.reserve(threads - 1);
+    for(unsigned thread = 1; thread < threads; ++thread)
+    {
+        team.emplace_back(work, thread);
+    }
+    work(0);
+    return result;
+}
@@ -0,0 +1,424 @@
+#pragma once
+
+/*
+ * csr_file.h stores a CsrGraph on disk in a form that is used in place after mmap.
+ *
+ * Building a graph from a text edge list means parsing every number and then running addEdge
+ * once per edge, which for multi GB lists takes far longer than the algorithm afterwards. The
+ * binary file is the CSR arrays exactly as they sit in memory:
+ *
+ *   header (CsrFileHeader, 64 bytes) | offsets | targets | weights (optional)
+ *
+ * Every section starts on a kCsrFileAlignment boundary, so after mmap the arrays are correctly
+ * aligned spans into the mapping and Map_Csr_File is O(1): no parsing, no copy, pages are read
+ * when first touched (bPopulate reads them all up front instead). The byte order and the weight
+ * type size are recorded and checked.
+ *
+ * Parse_Edge_List reads the "source target [weight]" text format (lines starting with '#' or '%'
+ * are comments, as in SNAP and Matrix Market files) with one thread per chunk of the mapped
+ * text; chunks are cut at line ends. Convert_Edge_List goes from text to the binary file.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/parallel.h"
+#include "graph/csr_graph.h"
+
+/* Section alignment in the file: a page, so every array starts on its own page once mapped */
+constexpr std::uint64_t kCsrFileAlignment = 4096;
+constexpr char kCsrFileMagic[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+constexpr std::uint32_t kCsrFileVersion = 1;
+/* Written as is; reads back differently on a machine of the other byte order */
+constexpr std::uint32_t kCsrFileByteOrderMark = 0x01020304;
+
+/*
+ * First 64 bytes of a CSR file; the section positions are byte offsets from the file start
+ */
+struct CsrFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrderMark;
+    std::uint64_t vertexCount;
+    std::uint64_t edgeCount;
+    std::uint32_t weightBytes; /* 0 for an unweighted graph, else sizeof(Weight) */
+    std::uint32_t reserved;
+    std::uint64_t offsetsPosition;
+    std::uint64_t targetsPosition;
+    std::uint64_t weightsPosition;
+};
+static_assert(sizeof(CsrFileHeader) == 64, "the header is one cache line");
+
+namespace detail
+{
+    inline std::uint64_t Align_File_Position(const std::uint64_t position) noexcept
+    {
+        return (position + kCsrFileAlignment - 1) / kCsrFileAlignment * kCsrFileAlignment;
+    }
+
+    [[noreturn]] inline void Throw_File_Error(const std::string& what, const std::string& path)
+    {
+        throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+
+    /*
+     * Read only mapping of a whole file, unmapped by the destructor
+     */
+    class FileMapping
+    {
+    public:
+        FileMapping(const std::string& path, const bool bPopulate)
+        {
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+            if(descriptor < 0)
+            {
+                Throw_File_Error("cannot open", path);
+            }
+            struct stat status = {};
+            if(::fstat(descriptor, &status) != 0)
+            {
+                ::close(descriptor);
+                Throw_File_Error("cannot stat", path);
+            }
+            m_size = static_cast<std::size_t>(status.st_size);
+            if(m_size > 0)
+            {
+                void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | (bPopulate ? MAP_POPULATE : 0), descriptor, 0);
+                if(data == MAP_FAILED)
+                {
+                    ::close(descriptor);
+                    Throw_File_Error("cannot map", path);
+                }
+                m_data = static_cast<const char*>(data);
+            }
+            ::close(descriptor);
+        }
+
+        ~FileMapping()
+        {
+            if(m_data != nullptr)
+            {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+        }
+
+        FileMapping(const FileMapping&) = delete;
+        FileMapping& operator=(const FileMapping&) = delete;
+
+        const char* Data() const noexcept { return m_data; }
+        std::size_t Size() const noexcept { return m_size; }
+
+    private:
+        const char* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    /* Parse "source target [weight]" lines of text[begin, end); returns false on a malformed line */
+    template<class Weight>
+    bool Parse_Edge_Lines(const char* begin, const char* const end, std::vector<Edge>& edges, std::vector<Weight>& weights,
+                          std::size_t& weightedLines)
+    {
+        auto skipBlanks = [&]
+        {
+            while(begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r' || *begin == ','))
+            {
+                ++begin;
+            }
+        };
+        while(begin < end)
+        {
+            skipBlanks();
+            if(begin == end || *begin == '\n' || *begin == '#' || *begin == '%')
+            {
+                begin = std::find(begin, end, '\n');
+                begin += begin < end ? 1 : 0;
+                continue;
+            }
+            Edge edge = {};
+            std::from_chars_result parsed = std::from_chars(begin, end, edge.source);
+            if(parsed.ec != std::errc())
+            {
+                return false;
+            }
+            begin = parsed.ptr;
+            skipBlanks();
+            parsed = std::from_chars(begin, end, edge.target);
+            if(parsed.ec != std::errc())
+            {
+                return false;
+            }
+            begin = parsed.ptr;
+            edges.push_back(edge);
+            skipBlanks();
+            if(begin < end && *begin != '\n')
+            {
+                Weight weight = {};
+                parsed = std::from_chars(begin, end, weight);
+                if(parsed.ec != std::errc())
+                {
+                    return false;
+                }
+                begin = parsed.ptr;
+                weights.push_back(weight);
+                ++weightedLines;
+                skipBlanks();
+            }
+            if(begin < end && *begin != '\n')
+            {
+                return false;
+            }
+            begin += begin < end ? 1 : 0;
+        }
+        return true;
+    }
+} /* namespace detail */
+
+/**
+ * @brief Write `graph` as a CSR file that Map_Csr_File can use in place.
+ *
+ * Example usage:
+ * @code
+ * Write_Csr_File("graph.csr", graph);
+ * const CsrGraph<> mapped = Map_Csr_File<float>("graph.csr");
+ * @endcode
+ */
+template<class Weight>
+void Write_Csr_File(const std::string& path, const CsrGraph<Weight>& graph)
+{
+    CsrFileHeader header = {};
+    std::copy(std::begin(kCsrFileMagic), std::end(kCsrFileMagic), header.magic);
+    header.version = kCsrFileVersion;
+    header.byteOrderMark = kCsrFileByteOrderMark;
+    header.vertexCount = graph.VertexCount();
+    header.edgeCount = graph.EdgeCount();
+    header.weightBytes = graph.IsWeighted() ? static_cast<std::uint32_t>(sizeof(Weight)) : 0;
+    header.offsetsPosition = detail::Align_File_Position(sizeof(CsrFileHeader));
+    header.targetsPosition = detail::Align_File_Position(header.offsetsPosition + graph.Offsets().size_bytes());
+    header.weightsPosition = graph.IsWeighted() ? detail::Align_File_Position(header.targetsPosition + graph.Targets().size_bytes()) : 0;
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if(!file)
+    {
+        detail::Throw_File_Error("cannot create", path);
+    }
+    std::uint64_t position = 0;
+    auto writeAt = [&](const std::uint64_t target, const void* data, const std::size_t bytes)
+    {
+        static constexpr char kPadding[kCsrFileAlignment] = {};
+        const std::size_t padding = static_cast<std::size_t>(target - position);
+        if(std::fwrite(kPadding, 1, padding, file.get()) != padding || std::fwrite(data, 1, bytes, file.get()) != bytes)
+        {
+            detail::Throw_File_Error("cannot write", path);
+        }
+        position = target + bytes;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.offsetsPosition, graph.Offsets().data(), graph.Offsets().size_bytes());
+    writeAt(header.targetsPosition, graph.Targets().data(), graph.Targets().size_bytes());
+    if(graph.IsWeighted())
+    {
+        writeAt(header.weightsPosition, graph.EdgeWeights().data(), graph.EdgeWeights().size_bytes());
+    }
+    if(std::fclose(file.release()) != 0)
+    {
+        detail::Throw_File_Error("cannot write", path);
+    }
+}
+
+/**
+ * @brief Open a CSR file as a graph whose arrays point straight into the mapping.
+ *
+ * The mapping stays alive as long as any copy of the returned graph does. Only the header, the
+ * section sizes and the first and last offset are checked by default; a file from an untrusted
+ * source needs bValidate, since a forged interior offset or target makes every traversal read
+ * out of bounds.
+ *
+ * @param bPopulate: read the whole file in now (MAP_POPULATE) instead of on first touch
+ * @param bValidate: also check that the offsets never decrease and every target is below the
+ *                   vertex count, one pass over both arrays that reads every page
+ */
+template<class Weight = float>
+CsrGraph<Weight> Map_Csr_File(const std::string& path, const bool bPopulate = false, const bool bValidate = false)
+{
+    auto mapping = std::make_shared<const detail::FileMapping>(path, bPopulate);
+    const char* data = mapping->Data();
+    CsrFileHeader header = {};
+    if(mapping->Size() < sizeof(header))
+    {
+        throw std::runtime_error("Map_Csr_File: " + path + " is too short for a CSR file");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if(!std::equal(std::begin(kCsrFileMagic), std::end(kCsrFileMagic), header.magic) || header.version != kCsrFileVersion)
+    {
+        throw std::runtime_error("Map_Csr_File: " + path + " is not a version " + std::to_string(kCsrFileVersion) + " CSR file");
+    }
+    if(header.byteOrderMark != kCsrFileByteOrderMark)
+    {
+        throw std::runtime_error("Map_Csr_File: " + path + " was written with the other byte order");
+    }
+    if(header.weightBytes != 0 && header.weightBytes != sizeof(Weight))
+    {
+        throw std::runtime_error("Map_Csr_File: " + path + " has " + std::to_string(header.weightBytes) + " byte weights, expected " +
+                                 std::to_string(sizeof(Weight)));
+    }
+    if(header.vertexCount > std::numeric_limits<VertexId>::max())
+    {
+        throw std::runtime_error("Map_Csr_File: " + path + " has " + std::to_string(header.vertexCount) + " vertices, more than vertex ids can address");
+    }
+    const std::uint64_t weightCount = header.weightBytes != 0 ? header.edgeCount : 0;
+    /* counts are compared against the room left, a product of a forged count could wrap */
+    auto fits = [&](const std::uint64_t position, const std::uint64_t count, const std::size_t elementBytes)
+    {
+        return position % kCsrFileAlignment == 0 && position <= mapping->Size() && count <= (mapping->Size() - position) / elementBytes;
+    };
+    if(!fits(header.offsetsPosition, header.vertexCount + 1, sizeof(EdgeId)) || !fits(header.targetsPosition, header.edgeCount, sizeof(VertexId)) ||
+       (weightCount != 0 && !fits(header.weightsPosition, weightCount, sizeof(Weight))))
+    {
+        throw std::runtime_error("Map_Csr_File: " + path + " is truncated or its sections are misplaced");
+    }
+    const std::span<const EdgeId> offsets(reinterpret_cast<const EdgeId*>(data + header.offsetsPosition), header.vertexCount + 1);
+    const std::span<const VertexId> targets(reinterpret_cast<const VertexId*>(data + header.targetsPosition), header.edgeCount);
+    const std::span<const Weight> weights(weightCount != 0 ? reinterpret_cast<const Weight*>(data + header.weightsPosition) : nullptr, weightCount);
+    if(bValidate)
+    {
+        const auto decrease = std::adjacent_find(offsets.begin(), offsets.end(), [](EdgeId current, EdgeId next) { return next < current; });
+        if(decrease != offsets.end())
+        {
+            throw std::runtime_error("Map_Csr_File: " + path + " has decreasing offsets after vertex " +
+                                     std::to_string(decrease - offsets.begin()));
+        }
+        const auto outside = std::find_if(targets.begin(), targets.end(), [&](VertexId target) { return target >= header.vertexCount; });
+        if(outside != targets.end())
+        {
+            throw std::runtime_error("Map_Csr_File: " + path + " has edge target " + std::to_string(*outside) + " outside of " +
+                                     std::to_string(header.vertexCount) + " vertices");
+        }
+    }
+    return CsrGraph<Weight>(offsets, targets, weights, std::move(mapping));
+}
+
+/*
+ * Result of Parse_Edge_List
+ */
+template<class Weight>
+struct EdgeList
+{
+    std::vector<Edge> edges;
+    std::vector<Weight> weights; /* empty unless every line has a third column */
+    std::size_t vertexCount = 0; /* largest vertex id + 1 */
+};
+
+/**
+ * @brief Parse a "source target [weight]" text edge list with `threads` threads.
+ *
+ * The mapped text is cut into one chunk per thread at line ends; the chunks are concatenated in
+ * file order, so the edge order matches the file.
+ *
+ * Example usage:
+ * @code
+ * const EdgeList<float> list = Parse_Edge_List<float>("edges.txt", 8);
+ * const CsrGraph<> graph = CsrGraph<>::From_Edges(list.vertexCount, list.edges, list.weights);
+ * @endcode
+ */
+template<class Weight = float>
+EdgeList<Weight> Parse_Edge_List(const std::string& path, unsigned threads = Default_Thread_Count())
+{
+    const detail::FileMapping mapping(path, false);
+    const char* const text = mapping.Data();
+    const std::size_t size = mapping.Size();
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(size / (1 << 16) + 1)));
+
+    struct Chunk
+    {
+        std::vector<Edge> edges;
+        std::vector<Weight> weights;
+        std::size_t weightedLines = 0;
+        std::size_t vertexCount = 0;
+        bool bValid = true;
+    };
+    std::vector<Chunk> chunks(threads);
+    /* chunk t starts after the first line end at or past size * t / threads */
+    auto chunkStart = [&](const std::size_t chunk)
+    {
+        if(chunk == 0 || chunk >= threads)
+        {
+            return chunk == 0 ? std::size_t{0} : size;
+        }
+        const char* lineEnd = std::find(text + size * chunk / threads, text + size, '\n');
+        return static_cast<std::size_t>(lineEnd - text) + (lineEnd < text + size ? 1 : 0);
+    };
+    Parallel_For_Chunks(threads, threads, [&](unsigned, std::size_t first, std::size_t)
+    {
+        Chunk& chunk = chunks[first];
+        const std::size_t begin = chunkStart(first);
+        const std::size_t end = std::max(begin, chunkStart(first + 1));
+        chunk.edges.reserve((end - begin) / 12);
+        chunk.bValid = detail::Parse_Edge_Lines(text + begin, text + end, chunk.edges, chunk.weights, chunk.weightedLines);
+        for(const Edge& edge : chunk.edges)
+        {
+            chunk.vertexCount = std::max<std::size_t>(chunk.vertexCount, std::size_t{std::max(edge.source, edge.target)} + 1);
+        }
+    });
+
+    EdgeList<Weight> list;
+    std::size_t edgeCount = 0;
+    std::size_t weightedLines = 0;
+    for(const Chunk& chunk : chunks)
+    {
+        if(!chunk.bValid)
+        {
+            throw std::runtime_error("Parse_Edge_List: malformed line in " + path);
+        }
+        edgeCount += chunk.edges.size();
+        weightedLines += chunk.weightedLines;
+        list.vertexCount = std::max(list.vertexCount, chunk.vertexCount);
+    }
+    if(weightedLines != 0 && weightedLines != edgeCount)
+    {
+        throw std::runtime_error("Parse_Edge_List: " + path + " mixes weighted and unweighted lines");
+    }
+    /* the first chunk's arrays become the result, the others are appended */
+    list.edges = std::move(chunks.front().edges);
+    list.weights = std::move(chunks.front().weights);
+    list.edges.reserve(edgeCount);
+    list.weights.reserve(weightedLines);
+    for(std::size_t i = 1; i < chunks.size(); ++i)
+    {
+        list.edges.insert(list.edges.end(), chunks[i].edges.begin(), chunks[i].edges.end());
+        list.weights.insert(list.weights.end(), chunks[i].weights.begin(), chunks[i].weights.end());
+        chunks[i] = {};
+    }
+    return list;
+}
+
+/**
+ * @brief Text edge list to CSR file: Parse_Edge_List, CsrGraph::From_Edges, Write_Csr_File.
+ *
+ * @return CsrGraph<Weight>: the graph that was written, in memory
+ */
+template<class Weight = float>
+CsrGraph<Weight> Convert_Edge_List(const std::string& textPath, const std::string& csrPath, const unsigned threads = Default_Thread_Count())
+{
+    EdgeList<Weight> list = Parse_Edge_List<Weight>(textPath, threads);
+    CsrGraph<Weight> graph = CsrGraph<Weight>::From_Edges(list.vertexCount, list.edges, list.weights);
+    list = {};
+    Write_Csr_File(csrPath, graph);
+    return graph;
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+/*
+ * csr_graph.h is the compressed sparse row graph the graph algorithms run on.
+ *
+ * The graphs in TopologicalSort.cpp (list<int>[V]) and C Program/dfs.c (a malloc'd node per edge)
+ * spend one heap node per edge, so every traversal step is a pointer chase to a random address.
+ * CSR keeps all out-edges of vertex v contiguous in targets[offsets[v], offsets[v + 1]): a
+ * traversal streams through one array and the whole graph is two allocations (three weighted).
+ *
+ * Building takes two passes over the edge list: count the out-degrees, prefix sum them into
+ * offsets, then drop every edge into the next free slot of its source. Edges of a vertex keep
+ * the order they were added in. CsrBuilder collects edges one at a time, the way addEdge is used
+ * today, and converts to CSR once.
+ *
+ * The graph only looks at its arrays through spans. Whoever owns the memory (the vectors it was
+ * built from, or a memory mapped file, see csr_file.h) is kept alive by a shared pointer, so
+ * copies of an immutable graph share one set of arrays.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using VertexId = std::uint32_t;
+using EdgeId = std::uint64_t;
+
+struct Edge
+{
+    VertexId source;
+    VertexId target;
+};
+
+/**
+ * @brief Immutable directed graph in compressed sparse row form, optionally weighted.
+ *
+ * @tparam Weight: type of the optional edge weights, kept in an array parallel to the targets
+ *
+ * Example usage:
+ * @code
+ * const std::vector<Edge> edges = {{5, 2}, {5, 0}, {4, 0}, {4, 1}, {2, 3}, {3, 1}};
+ * const CsrGraph<> graph = CsrGraph<>::From_Edges(6, edges);
+ * for(VertexId neighbor : graph.Neighbors(5)) { ... }
+ * @endcode
+ */
+template<class Weight = float>
+class CsrGraph
+{
+public:
+    using WeightType = Weight;
+
+    CsrGraph() = default;
+
+    /**
+     * @brief Adopt ready made CSR arrays.
+     *
+     * @param offsets: vertexCount + 1 non decreasing entries starting at 0 and ending at targets.size()
+     * @param targets: edge targets grouped by source
+     * @param weights: empty, or one weight per target
+     */
+    CsrGraph(std::vector<EdgeId> offsets, std::vector<VertexId> targets, std::vector<Weight> weights = {})
+    {
+        if(offsets.empty())
+        {
+            offsets.push_back(0);
+        }
+        if(!std::is_sorted(offsets.begin(), offsets.end()))
+        {
+            throw std::invalid_argument("CsrGraph: offsets do not describe the targets array");
+        }
+        auto storage = std::make_shared<Storage>(Storage{std::move(offsets), std::move(targets), std::move(weights)});
+        Attach(storage->offsets, storage->targets, storage->weights, storage);
+    }
+
+    /**
+     * @brief View CSR arrays owned by someone else, e.g. a mapped file, without copying them.
+     *
+     * Only the sizes and the first and last offset are checked, so that opening a graph does not
+     * touch all of its pages.
+     *
+     * @param owner: kept alive as long as any copy of the graph exists
+     */
+    CsrGraph(std::span<const EdgeId> offsets, std::span<const VertexId> targets, std::span<const Weight> weights,
+             std::shared_ptr<const void> owner)
+    {
+        Attach(offsets, targets, weights, std::move(owner));
+    }
+
+    /**
+     * @brief Build from an edge list in two passes (count, prefix sum, fill).
+     *
+     * @param vertexCount: vertices are 0 ... vertexCount - 1
+     * @param edges: directed edges in any order
+     * @param weights: empty, or one weight per edge
+     */
+    static CsrGraph From_Edges(const std::size_t vertexCount, std::span<const Edge> edges, std::span<const Weight> weights = {})
+    {
+        if(!weights.empty() && weights.size() != edges.size())
+        {
+            throw std::invalid_argument("CsrGraph::From_Edges: weights must be empty or parallel to the edges");
+        }
+        std::vector<EdgeId> offsets(vertexCount + 1, 0);
+        for(const Edge& edge : edges)
+        {
+            if(edge.source >= vertexCount || edge.target >= vertexCount)
+            {
+                throw std::out_of_range("CsrGraph::From_Edges: edge " + std::to_string(edge.source) + " -> " +
+                                        std::to_string(edge.target) + " outside of " + std::to_string(vertexCount) + " vertices");
+            }
+            ++offsets[edge.source + 1];
+        }
+        for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            offsets[vertex + 1] += offsets[vertex];
+        }
+
+        /* next free slot per source, starts as a copy of the offsets */
+        std::vector<EdgeId> cursor(offsets.begin(), offsets.end() - 1);
+        std::vector<VertexId> targets(edges.size());
+        std::vector<Weight> edgeWeights(weights.size());
+        for(std::size_t i = 0; i < edges.size(); ++i)
+        {
+            const EdgeId slot = cursor[edges[i].source]++;
+            targets[slot] = edges[i].target;
+            if(!weights.empty())
+            {
+                edgeWeights[slot] = weights[i];
+            }
+        }
+        return CsrGraph(std::move(offsets), std::move(targets), std::move(edgeWeights));
+    }
+
+    std::size_t VertexCount() const noexcept { return m_offsets.size() - 1; }
+    std::size_t EdgeCount() const noexcept { return m_targets.size(); }
+    bool IsWeighted() const noexcept { return !m_weights.empty(); }
+
+    std::size_t OutDegree(const VertexId vertex) const noexcept
+    {
+        return static_cast<std::size_t>(m_offsets[vertex + 1] - m_offsets[vertex]);
+    }
+
+    std::span<const VertexId> Neighbors(const VertexId vertex) const noexcept
+    {
+        return m_targets.subspan(m_offsets[vertex], OutDegree(vertex));
+    }
+
+    /* Weights parallel to Neighbors(vertex), empty for an unweighted graph */
+    std::span<const Weight> Weights(const VertexId vertex) const noexcept
+    {
+        if(m_weights.empty())
+        {
+            return {};
+        }
+        return m_weights.subspan(m_offsets[vertex], OutDegree(vertex));
+    }
+
+    std::span<const EdgeId> Offsets() const noexcept { return m_offsets; }
+    std::span<const VertexId> Targets() const noexcept { return m_targets; }
+    std::span<const Weight> EdgeWeights() const noexcept { return m_weights; }
+
+    std::size_t MemoryBytes() const noexcept
+    {
+        return m_offsets.size() * sizeof(EdgeId) + m_targets.size() * sizeof(VertexId) + m_weights.size() * sizeof(Weight);
+    }
+
+private:
+    struct Storage
+    {
+        std::vector<EdgeId> offsets;
+        std::vector<VertexId> targets;
+        std::vector<Weight> weights;
+    };
+
+    static constexpr EdgeId kEmptyOffsets[1] = {0};
+
+    void Attach(std::span<const EdgeId> offsets, std::span<const VertexId> targets, std::span<const Weight> weights,
+                std::shared_ptr<const void> owner)
+    {
+        if(offsets.empty() || offsets.front() != 0 || offsets.back() != targets.size())
+        {
+            throw std::invalid_argument("CsrGraph: offsets do not describe the targets array");
+        }
+        if(!weights.empty() && weights.size() != targets.size())
+        {
+            throw std::invalid_argument("CsrGraph: weights must be empty or parallel to the targets");
+        }
+        m_offsets = offsets;
+        m_targets = targets;
+        m_weights = weights;
+        m_owner = std::move(owner);
+    }
+
+    std::span<const EdgeId> m_offsets = kEmptyOffsets;
+    std::span<const VertexId> m_targets;
+    std::span<const Weight> m_weights;
+    std::shared_ptr<const void> m_owner;
+};
+
+/**
+ * @brief The graph with every edge reversed, i.e. the in-edges of each vertex, weights included.
+ * In-edges of a vertex come in order of their source.
+ */
+template<class Weight>
+CsrGraph<Weight> Transpose(const CsrGraph<Weight>& graph)
+{
+    const std::size_t vertexCount = graph.VertexCount();
+    std::vector<EdgeId> offsets(vertexCount + 1, 0);
+    for(VertexId target : graph.Targets())
+    {
+        ++offsets[target + 1];
+    }
+    for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+    std::vector<EdgeId> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<VertexId> sources(graph.EdgeCount());
+    std::vector<Weight> weights(graph.EdgeWeights().size());
+    for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        for(EdgeId edge = graph.Offsets()[vertex]; edge < graph.Offsets()[vertex + 1]; ++edge)
+        {
+            const EdgeId slot = cursor[graph.Targets()[edge]]++;
+            sources[slot] = static_cast<VertexId>(vertex);
+            if(!weights.empty())
+            {
+                weights[slot] = graph.EdgeWeights()[edge];
+            }
+        }
+    }
+    return CsrGraph<Weight>(std::move(offsets), std::move(sources), std::move(weights));
+}
+
+/**
+ * @brief Mutable edge collector that converts to CsrGraph once all edges are known.
+ *
+ * Adding an edge is an append to a flat array; the graph grows to cover every vertex id it sees.
+ *
+ * Example usage:
+ * @code
+ * CsrBuilder<> builder(6);
+ * builder.AddEdge(5, 2);
+ * builder.AddEdge(5, 0);
+ * const CsrGraph<> graph = std::move(builder).Build();
+ * @endcode
+ */
+template<class Weight = float>
+class CsrBuilder
+{
+public:
+    explicit CsrBuilder(const std::size_t vertexCount = 0)
+        : m_vertexCount(vertexCount)
+    {
+    }
+
+    void Reserve(const std::size_t edgeCount)
+    {
+        m_edges.reserve(edgeCount);
+    }
+
+    void AddEdge(const VertexId source, const VertexId target)
+    {
+        if(!m_weights.empty())
+        {
+            throw std::logic_error("CsrBuilder: unweighted edge added to a weighted graph");
+        }
+        Append(source, target);
+    }
+
+    void AddEdge(const VertexId source, const VertexId target, const Weight weight)
+    {
+        if(m_weights.size() != m_edges.size())
+        {
+            throw std::logic_error("CsrBuilder: weighted edge added to an unweighted graph");
+        }
+        Append(source, target);
+        m_weights.push_back(weight);
+    }
+
+    /* Both directions, as addEdge in C Program/dfs.c does */
+    void AddUndirectedEdge(const VertexId first, const VertexId second)
+    {
+        AddEdge(first, second);
+        AddEdge(second, first);
+    }
+
+    std::size_t VertexCount() const noexcept { return m_vertexCount; }
+    std::size_t EdgeCount() const noexcept { return m_edges.size(); }
+
+    CsrGraph<Weight> Build() &&
+    {
+        CsrGraph<Weight> graph = CsrGraph<Weight>::From_Edges(m_vertexCount, m_edges, m_weights);
+        m_edges = {};
+        m_weights = {};
+        return graph;
+    }
+
+private:
+    void Append(const VertexId source, const VertexId target)
+    {
+        m_vertexCount = std::max<std::size_t>(m_vertexCount, std::size_t{std::max(source, target)} + 1);
+        m_edges.push_back({source, target});
+    }
+
+    std::size_t m_vertexCount;
+    std::vector<Edge> m_edges;
+    std::vector<Weight> m_weights;
+};
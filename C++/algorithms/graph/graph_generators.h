@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * graph_generators.h builds the synthetic edge lists the graph benchmarks run on.
+ *
+ * RMAT (recursive matrix) picks every edge by descending 2^scale x 2^scale adjacency matrix
+ * quadrants with probabilities a, b, c, d; the Graph 500 parameters give the skewed degree
+ * distribution and small diameter of social and web graphs, which is where direction
+ * optimizing BFS and vertex reordering matter. Vertex labels are permuted afterwards so that
+ * the hubs are not all at low ids.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "graph/csr_graph.h"
+
+/**
+ * @brief Graph 500 style RMAT edge list: 2^scale vertices, edgeFactor * 2^scale directed edges.
+ *
+ * Self loops and duplicate edges are kept, as in the Graph 500 generator.
+ *
+ * @param scale: log2 of the vertex count, at most 31
+ * @param edgeFactor: edges per vertex
+ * @param seed: generator seed
+ *
+ * Example usage:
+ * @code
+ * const std::vector<Edge> edges = Generate_Rmat_Edges(20, 16, 66);
+ * const CsrGraph<> graph = CsrGraph<>::From_Edges(std::size_t{1} << 20, Symmetrize_Edges(edges));
+ * @endcode
+ */
+inline std::vector<Edge> Generate_Rmat_Edges(const unsigned scale, const std::size_t edgeFactor, const std::uint64_t seed,
+                                             const double a = 0.57, const double b = 0.19, const double c = 0.19)
+{
+    const std::size_t vertexCount = std::size_t{1} << scale;
+    const std::size_t edgeCount = vertexCount * edgeFactor;
+    /* quadrant thresholds on 16 bit random numbers: [0, ab) top row, [ab, abc) bottom left */
+    const std::uint32_t thresholdA = static_cast<std::uint32_t>(a * 65536);
+    const std::uint32_t thresholdB = static_cast<std::uint32_t>((a + b) * 65536);
+    const std::uint32_t thresholdC = static_cast<std::uint32_t>((a + b + c) * 65536);
+
+    std::mt19937_64 generator(seed);
+    std::vector<Edge> edges(edgeCount);
+    for(Edge& edge : edges)
+    {
+        VertexId source = 0;
+        VertexId target = 0;
+        std::uint64_t bits = 0;
+        for(unsigned level = 0; level < scale; ++level)
+        {
+            if(level % 4 == 0)
+            {
+                bits = generator();
+            }
+            const std::uint32_t draw = static_cast<std::uint32_t>(bits & 0xFFFF);
+            bits >>= 16;
+            source = (source << 1) | (draw >= thresholdB ? 1u : 0u);
+            target = (target << 1) | ((draw >= thresholdA && draw < thresholdB) || draw >= thresholdC ? 1u : 0u);
+        }
+        edge = {source, target};
+    }
+
+    std::vector<VertexId> label(vertexCount);
+    std::iota(label.begin(), label.end(), VertexId{0});
+    std::shuffle(label.begin(), label.end(), generator);
+    for(Edge& edge : edges)
+    {
+        edge = {label[edge.source], label[edge.target]};
+    }
+    return edges;
+}
+
+/**
+ * @brief Both directions of every edge, self loops once, so the CSR graph is symmetric.
+ */
+inline std::vector<Edge> Symmetrize_Edges(const std::vector<Edge>& edges)
+{
+    std::vector<Edge> symmetric;
+    symmetric.reserve(2 * edges.size());
+    for(const Edge& edge : edges)
+    {
+        symmetric.push_back(edge);
+        if(edge.source != edge.target)
+        {
+            symmetric.push_back({edge.target, edge.source});
+        }
+    }
+    return symmetric;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+/*
+ * incremental_topological_order.h keeps a topological order up to date while edges are added.
+ *
+ * Recomputing the order after every addEdge costs O(V + E) per edit even though a new edge
+ * u -> v with u already in front of v changes nothing, and otherwise only the vertices placed
+ * between v and u can be affected. This is the Pearce-Kelly algorithm:
+ *
+ *  - every vertex has a position; an edge that already points forward is just recorded
+ *  - for a backward edge (position(v) < position(u)) search forward from v through vertices
+ *    placed before u, and backward from u through vertices placed after v. Reaching u from v
+ *    means the edge would close a cycle: it is rejected and the path is reported
+ *  - otherwise the vertices found backward move to the front of the positions the two searches
+ *    visited, those found forward to the back, and nothing outside the searched region moves
+ *
+ * Both searches are iterative and share one visit stamp array, bumped per edge instead of cleared.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "graph/csr_graph.h"
+
+/**
+ * @brief Topological order of a growing DAG, updated per inserted edge (Pearce-Kelly).
+ *
+ * Example usage:
+ * @code
+ * IncrementalTopologicalOrder order(6);
+ * order.AddEdge(5, 2);
+ * if(!order.AddEdge(2, 5))
+ * {
+ *     Report_Cycle(order.Cycle()); // 5 2: the rejected edge 2 -> 5 closes it
+ * }
+ * for(VertexId vertex : order.Order()) { ... }
+ * @endcode
+ */
+class IncrementalTopologicalOrder
+{
+public:
+    explicit IncrementalTopologicalOrder(const std::size_t vertexCount = 0)
+    {
+        for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            AddVertex();
+        }
+    }
+
+    /* A new vertex without edges, placed last */
+    VertexId AddVertex()
+    {
+        const VertexId vertex = static_cast<VertexId>(m_vertexAt.size());
+        m_successors.emplace_back();
+        m_predecessors.emplace_back();
+        m_position.push_back(vertex);
+        m_vertexAt.push_back(vertex);
+        m_visited.push_back(0);
+        m_parent.push_back(0);
+        return vertex;
+    }
+
+    /**
+     * @brief Insert source -> target and repair the order.
+     *
+     * @return bool: false if the edge would close a cycle; the edge is then not inserted and
+     *         Cycle() holds target, ..., source
+     */
+    bool AddEdge(const VertexId source, const VertexId target)
+    {
+        if(source >= VertexCount() || target >= VertexCount())
+        {
+            throw std::out_of_range("IncrementalTopologicalOrder::AddEdge: edge " + std::to_string(source) + " -> " +
+                                    std::to_string(target) + " outside of " + std::to_string(VertexCount()) + " vertices");
+        }
+        m_cycle.clear();
+        if(source == target)
+        {
+            m_cycle.push_back(source);
+            return false;
+        }
+        if(m_position[source] > m_position[target])
+        {
+            if(++m_stamp == 0)
+            {
+                std::fill(m_visited.begin(), m_visited.end(), 0);
+                m_stamp = 1;
+            }
+            if(!Search_Forward(source, target))
+            {
+                return false;
+            }
+            Search_Backward(source, target);
+            Reorder();
+        }
+        m_successors[source].push_back(target);
+        m_predecessors[target].push_back(source);
+        ++m_edgeCount;
+        return true;
+    }
+
+    std::size_t VertexCount() const noexcept { return m_vertexAt.size(); }
+    std::size_t EdgeCount() const noexcept { return m_edgeCount; }
+
+    /* All vertices, every accepted edge points from an earlier to a later one */
+    std::span<const VertexId> Order() const noexcept { return m_vertexAt; }
+
+    std::size_t Position(const VertexId vertex) const noexcept { return m_position[vertex]; }
+
+    std::span<const VertexId> Successors(const VertexId vertex) const noexcept { return m_successors[vertex]; }
+
+    /* The cycle the last rejected edge would have closed, each vertex has an edge to the next */
+    std::span<const VertexId> Cycle() const noexcept { return m_cycle; }
+
+    /* Vertices that changed position over all insertions so far */
+    std::uint64_t MovedVertices() const noexcept { return m_moved; }
+
+private:
+    /* Vertices reachable from target that sit before source; false (and m_cycle) if source is one */
+    bool Search_Forward(const VertexId source, const VertexId target)
+    {
+        const VertexId upper = m_position[source];
+        m_forward.clear();
+        m_stack.assign(1, target);
+        m_visited[target] = m_stamp;
+        while(!m_stack.empty())
+        {
+            const VertexId vertex = m_stack.back();
+            m_stack.pop_back();
+            m_forward.push_back(vertex);
+            for(VertexId next : m_successors[vertex])
+            {
+                if(next == source)
+                {
+                    /* target -> ... -> vertex -> source, and the new edge goes back to target */
+                    for(VertexId step = vertex; step != target; step = m_parent[step])
+                    {
+                        m_cycle.push_back(step);
+                    }
+                    m_cycle.push_back(target);
+                    std::reverse(m_cycle.begin(), m_cycle.end());
+                    m_cycle.push_back(source);
+                    return false;
+                }
+                if(m_visited[next] != m_stamp && m_position[next] < upper)
+                {
+                    m_visited[next] = m_stamp;
+                    m_parent[next] = vertex;
+                    m_stack.push_back(next);
+                }
+            }
+        }
+        return true;
+    }
+
+    /* Vertices that reach source and sit after target */
+    void Search_Backward(const VertexId source, const VertexId target)
+    {
+        const VertexId lower = m_position[target];
+        m_backward.clear();
+        m_stack.assign(1, source);
+        m_visited[source] = m_stamp;
+        while(!m_stack.empty())
+        {
+            const VertexId vertex = m_stack.back();
+            m_stack.pop_back();
+            m_backward.push_back(vertex);
+            for(VertexId previous : m_predecessors[vertex])
+            {
+                if(m_visited[previous] != m_stamp && m_position[previous] > lower)
+                {
+                    m_visited[previous] = m_stamp;
+                    m_stack.push_back(previous);
+                }
+            }
+        }
+    }
+
+    /* Hand the positions both searches own to the backward set first, keeping each set's order */
+    void Reorder()
+    {
+        auto byPosition = [this](VertexId first, VertexId second) { return m_position[first] < m_position[second]; };
+        std::sort(m_backward.begin(), m_backward.end(), byPosition);
+        std::sort(m_forward.begin(), m_forward.end(), byPosition);
+        m_slots.clear();
+        for(VertexId vertex : m_backward)
+        {
+            m_slots.push_back(m_position[vertex]);
+        }
+        for(VertexId vertex : m_forward)
+        {
+            m_slots.push_back(m_position[vertex]);
+        }
+        std::sort(m_slots.begin(), m_slots.end());
+        std::size_t slot = 0;
+        for(const std::vector<VertexId>* moved : {&m_backward, &m_forward})
+        {
+            for(VertexId vertex : *moved)
+            {
+                m_position[vertex] = m_slots[slot];
+                m_vertexAt[m_slots[slot]] = vertex;
+                ++slot;
+            }
+        }
+        m_moved += m_slots.size();
+    }
+
+    std::vector<std::vector<VertexId>> m_successors;
+    std::vector<std::vector<VertexId>> m_predecessors;
+    std::vector<VertexId> m_position;  /* vertex -> position */
+    std::vector<VertexId> m_vertexAt;  /* position -> vertex */
+    std::size_t m_edgeCount = 0;
+    std::uint64_t m_moved = 0;
+
+    /* scratch, reused by every insertion */
+    std::vector<std::uint32_t> m_visited;
+    std::uint32_t m_stamp = 0;
+    std::vector<VertexId> m_parent;
+    std::vector<VertexId> m_stack;
+    std::vector<VertexId> m_forward;
+    std::vector<VertexId> m_backward;
+    std::vector<VertexId> m_slots;
+    std::vector<VertexId> m_cycle;
+};
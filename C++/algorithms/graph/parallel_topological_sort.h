@@ -0,0 +1,292 @@
+#pragma once
+
+/*
+ * parallel_topological_sort.h schedules a dependency DAG for parallel execution.
+ *
+ * TopologicalSorter produces one sequence, and running the tasks in that sequence leaves every
+ * core but one idle even when most tasks do not depend on each other. Two ways out:
+ *
+ *  - Topological_Levels: Kahn's algorithm one level at a time. Level 0 is the sources, level
+ *    k + 1 is every vertex whose last predecessor sits in level k, so all vertices of a level can
+ *    run concurrently. Each level is split across the threads, which decrement the in-degrees of
+ *    the successors atomically; whoever takes a counter to zero owns that vertex for the next
+ *    level. A level smaller than kParallelLevelMinVertices is expanded by one thread right away
+ *    (a chain of narrow levels would otherwise pay a barrier per vertex).
+ *  - Run_Task_Graph: no levels at all. A vertex's task is pushed on a WorkStealingPool the moment
+ *    its in-degree counter hits zero, so a long task only holds back its own successors rather
+ *    than the whole next level. The first ready successor is run by the same worker directly.
+ *
+ * Both leave the vertices behind a cycle unscheduled; Topological_Levels reports the cycle.
+ */
+
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "common/parallel.h"
+#include "common/work_stealing.h"
+#include "graph/csr_graph.h"
+#include "graph/topological_sort.h"
+
+/* Levels below this size are expanded by a single thread, larger ones by the whole team */
+constexpr std::size_t kParallelLevelMinVertices = 4096;
+
+/*
+ * Result of Topological_Levels: the vertices grouped by level, level after level
+ */
+struct TopologicalLevels
+{
+    std::vector<VertexId> order;          /* level 0, then level 1, ...; order inside a level is unspecified */
+    std::vector<std::size_t> levelBegin;  /* level k is order[levelBegin[k], levelBegin[k + 1]) */
+    std::vector<VertexId> cycle;          /* empty when the graph is a DAG */
+
+    std::size_t LevelCount() const noexcept { return levelBegin.empty() ? 0 : levelBegin.size() - 1; }
+
+    std::span<const VertexId> Level(const std::size_t level) const noexcept
+    {
+        return std::span<const VertexId>(order).subspan(levelBegin[level], levelBegin[level + 1] - levelBegin[level]);
+    }
+
+    bool HasCycle() const noexcept { return !cycle.empty(); }
+};
+
+namespace detail
+{
+    /* In-degree of every vertex, counted by `threads` threads over their share of the sources */
+    template<class Weight>
+    std::vector<VertexId> Parallel_In_Degrees(const CsrGraph<Weight>& graph, const unsigned threads)
+    {
+        const std::span<const VertexId> targets = graph.Targets();
+        const std::span<const EdgeId> offsets = graph.Offsets();
+        std::vector<VertexId> inDegree(graph.VertexCount(), 0);
+        if(threads == 1)
+        {
+            for(VertexId target : targets)
+            {
+                ++inDegree[target];
+            }
+            return inDegree;
+        }
+        Parallel_For_Chunks(graph.VertexCount(), threads, [&](unsigned, std::size_t begin, std::size_t end)
+        {
+            for(EdgeId edge = offsets[begin]; edge < offsets[end]; ++edge)
+            {
+                std::atomic_ref<VertexId>(inDegree[targets[edge]]).fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        return inDegree;
+    }
+} /* namespace detail */
+
+/**
+ * @brief Group the vertices into levels that can each run in parallel (level synchronous Kahn).
+ *
+ * @param graph: the dependency graph, an edge u -> v means u has to run before v
+ * @param threads: size of the thread team
+ * @return TopologicalLevels: every vertex on success; on a cycle the levels stop short and
+ *         `cycle` holds one cycle
+ *
+ * Example usage:
+ * @code
+ * const TopologicalLevels levels = Topological_Levels(graph, 8);
+ * for(std::size_t level = 0; level < levels.LevelCount(); ++level)
+ * {
+ *     Run_In_Parallel(levels.Level(level));
+ * }
+ * @endcode
+ */
+template<class Weight>
+TopologicalLevels Topological_Levels(const CsrGraph<Weight>& graph, unsigned threads = Default_Thread_Count())
+{
+    const std::size_t vertexCount = graph.VertexCount();
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    threads = std::max(threads, 1u);
+
+    TopologicalLevels result;
+    std::vector<VertexId> inDegree = detail::Parallel_In_Degrees(graph, threads);
+    result.order.resize(vertexCount);
+    std::size_t tail = 0;
+    for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        if(inDegree[vertex] == 0)
+        {
+            result.order[tail++] = static_cast<VertexId>(vertex);
+        }
+    }
+    result.levelBegin.push_back(0);
+
+    /* the current level is order[levelBegin.back(), tail); one thread takes every level on its own */
+    const std::size_t serialBelow = threads == 1 ? vertexCount + 1 : kParallelLevelMinVertices;
+    auto expandSerially = [&]
+    {
+        while(tail > result.levelBegin.back() && tail - result.levelBegin.back() < serialBelow)
+        {
+            const std::size_t begin = result.levelBegin.back();
+            const std::size_t end = tail;
+            result.levelBegin.push_back(end);
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                const VertexId vertex = result.order[i];
+                for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+                {
+                    if(--inDegree[targets[edge]] == 0)
+                    {
+                        result.order[tail++] = targets[edge];
+                    }
+                }
+            }
+        }
+    };
+
+    expandSerially();
+    if(tail > result.levelBegin.back())
+    {
+        std::vector<std::vector<VertexId>> next(threads);
+        std::barrier barrier(threads);
+        bool bDone = false;
+        auto work = [&](const unsigned thread)
+        {
+            while(true)
+            {
+                const std::size_t begin = result.levelBegin.back();
+                const std::size_t size = tail - begin;
+                for(std::size_t i = begin + size * thread / threads; i < begin + size * (thread + 1) / threads; ++i)
+                {
+                    const VertexId vertex = result.order[i];
+                    for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+                    {
+                        if(std::atomic_ref<VertexId>(inDegree[targets[edge]]).fetch_sub(1, std::memory_order_relaxed) == 1)
+                        {
+                            next[thread].push_back(targets[edge]);
+                        }
+                    }
+                }
+                barrier.arrive_and_wait();
+                if(thread == 0)
+                {
+                    result.levelBegin.push_back(tail);
+                    for(std::vector<VertexId>& found : next)
+                    {
+                        std::copy(found.begin(), found.end(), result.order.begin() + static_cast<std::ptrdiff_t>(tail));
+                        tail += found.size();
+                        found.clear();
+                    }
+                    expandSerially();
+                    bDone = tail == result.levelBegin.back();
+                }
+                barrier.arrive_and_wait();
+                if(bDone)
+                {
+                    return;
+                }
+            }
+        };
+        std::vector<std::jthread> team;
+        team.reserve(threads - 1);
+        for(unsigned thread = 1; thread < threads; ++thread)
+        {
+            team.emplace_back(work, thread);
+        }
+        work(0);
+    }
+
+    if(tail != vertexCount)
+    {
+        result.order.resize(tail);
+        TopologicalSorter sorter;
+        std::vector<VertexId> unused;
+        sorter.Dfs(graph, unused);
+        result.cycle.assign(sorter.Cycle().begin(), sorter.Cycle().end());
+    }
+    return result;
+}
+
+/**
+ * @brief Run task(vertex) for every vertex, each one after all of its predecessors, on a work
+ * stealing pool. A task starts as soon as its last predecessor has finished.
+ *
+ * Everything a task wrote is visible to the tasks of its successors. Tasks on or behind a cycle
+ * never become ready and are not run.
+ *
+ * @param graph: the dependency graph, an edge u -> v means task u has to finish before task v
+ * @param pool: the threads to run on
+ * @param task: callable as task(vertex), invoked concurrently for independent vertices
+ * @return std::size_t: number of tasks run, VertexCount() unless the graph has a cycle
+ *
+ * Example usage:
+ * @code
+ * WorkStealingPool<VertexId> pool(8);
+ * const std::size_t ran = Run_Task_Graph(graph, pool, [&](VertexId vertex) { Build_Target(vertex); });
+ * @endcode
+ */
+template<class Weight, class Task>
+std::size_t Run_Task_Graph(const CsrGraph<Weight>& graph, WorkStealingPool<VertexId>& pool, Task&& task)
+{
+    const std::size_t vertexCount = graph.VertexCount();
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    std::vector<VertexId> inDegree = detail::Parallel_In_Degrees(graph, pool.ThreadCount());
+    std::vector<VertexId> sources;
+    for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        if(inDegree[vertex] == 0)
+        {
+            sources.push_back(static_cast<VertexId>(vertex));
+        }
+    }
+
+    struct alignas(64) Counter
+    {
+        std::size_t value = 0;
+    };
+    std::vector<Counter> ran(pool.ThreadCount());
+    constexpr VertexId kNone = std::numeric_limits<VertexId>::max();
+
+    const bool bShared = pool.ThreadCount() > 1;
+    pool.Run(std::span<const VertexId>(sources), [&](VertexId vertex, WorkStealingPool<VertexId>::Worker& worker)
+    {
+        while(vertex != kNone)
+        {
+            /* a locked decrement stalls until its line arrives, so fetch all of them up front */
+            for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+            {
+                __builtin_prefetch(&inDegree[targets[edge]], 1);
+            }
+            task(vertex);
+            ++ran[worker.Index()].value;
+            VertexId continuation = kNone;
+            for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+            {
+                /* acq_rel: the last decrement sees the writes of every predecessor's task */
+                const VertexId remaining = bShared ? std::atomic_ref<VertexId>(inDegree[targets[edge]]).fetch_sub(1, std::memory_order_acq_rel) - 1
+                                                   : --inDegree[targets[edge]];
+                if(remaining != 0)
+                {
+                    continue;
+                }
+                if(continuation == kNone)
+                {
+                    continuation = targets[edge];
+                }
+                else
+                {
+                    worker.Push(targets[edge]);
+                }
+            }
+            vertex = continuation;
+        }
+    });
+
+    std::size_t total = 0;
+    for(const Counter& counter : ran)
+    {
+        total += counter.value;
+    }
+    return total;
+}
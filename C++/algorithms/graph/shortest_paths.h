@@ -0,0 +1,623 @@
+#pragma once
+
+/*
+ * shortest_paths.h computes single source shortest paths over weighted CsrGraphs, picking the
+ * algorithm by what is known about the graph:
+ *
+ *  - DAG (a topological order is at hand, see topological_sort.h): Dag_Shortest_Paths relaxes
+ *    the out-edges of every vertex once, in order, O(V + E) with no queue. Negative weights are
+ *    fine. Dag_Longest_Paths is the same pass maximizing from every vertex at once, the critical
+ *    path of a task graph whose edge weights are durations.
+ *  - non-negative weights: Dijkstra, with one of two queues.
+ *      radix heap:      a monotone queue. Dijkstra only ever pops keys >= the last one popped,
+ *                       so entries are binned by the highest bit in which they differ from it;
+ *                       a pop redistributes one bin. Floating point keys are binned by their bit
+ *                       pattern, which orders the same as the value for non-negative numbers.
+ *      4-ary heap:      half the depth of a binary heap, and the four children of a node
+ *                       share a cache line.
+ *  - many cores: Delta_Stepping (Meyer, Sanders; organised as in the GAP benchmark suite). The
+ *    tentative distances are cut into buckets of width delta; all vertices of the lowest
+ *    non-empty bucket are relaxed in parallel, a new distance is published by a compare-exchange
+ *    loop and the target is queued in the relaxing thread's own bucket of the new distance. The
+ *    team meets at a barrier to pick the next bucket and gather its vertices into the frontier.
+ *
+ * An unweighted graph counts every edge as weight 1. Parents form a shortest path tree: the
+ * source (for Dag_Longest_Paths every path start) is its own parent, unreached vertices have
+ * kNoParent. Path_To follows them back.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/parallel.h"
+#include "graph/csr_graph.h"
+
+constexpr VertexId kNoParent = std::numeric_limits<VertexId>::max();
+/* Frontier vertices per cursor step in Delta_Stepping */
+constexpr std::size_t kDeltaSteppingBlock = 64;
+
+/*
+ * Priority queue used by Dijkstra
+ */
+enum class EDijkstraQueue : int
+{
+    RadixHeap,
+    QuaternaryHeap,
+    AutoCount /* Should be last! Number of queues */
+};
+
+inline const char* Dijkstra_Queue_Name(const EDijkstraQueue queue) noexcept
+{
+    switch(queue)
+    {
+        case EDijkstraQueue::QuaternaryHeap:
+            return "4-ary heap";
+        case EDijkstraQueue::RadixHeap:
+        default:
+            return "radix heap";
+    }
+}
+
+/*
+ * Result of the shortest (or longest) path functions
+ */
+template<class Weight>
+struct ShortestPaths
+{
+    static constexpr Weight kUnreached = std::numeric_limits<Weight>::has_infinity ? std::numeric_limits<Weight>::infinity()
+                                                                                   : std::numeric_limits<Weight>::max();
+
+    std::vector<Weight> distance; /* kUnreached if there is no path */
+    std::vector<VertexId> parent; /* previous vertex on a best path, path starts are their own parent */
+
+    bool Reached(const VertexId vertex) const noexcept { return parent[vertex] != kNoParent; }
+};
+
+/**
+ * @brief Vertices of the best path ending at `target`, start first; empty if it is unreached.
+ */
+template<class Weight>
+std::vector<VertexId> Path_To(const ShortestPaths<Weight>& paths, VertexId target)
+{
+    std::vector<VertexId> path;
+    if(!paths.Reached(target))
+    {
+        return path;
+    }
+    path.push_back(target);
+    while(paths.parent[target] != target)
+    {
+        target = paths.parent[target];
+        path.push_back(target);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+namespace detail
+{
+    template<class Weight>
+    Weight Edge_Weight(const CsrGraph<Weight>& graph, const EdgeId edge) noexcept
+    {
+        return graph.IsWeighted() ? graph.EdgeWeights()[edge] : Weight{1};
+    }
+
+    template<class Weight>
+    void Check_Source(const CsrGraph<Weight>& graph, const VertexId source, const char* caller)
+    {
+        if(source >= graph.VertexCount())
+        {
+            throw std::out_of_range(std::string(caller) + ": source " + std::to_string(source) + " outside of " +
+                                    std::to_string(graph.VertexCount()) + " vertices");
+        }
+    }
+
+    template<class Weight>
+    void Check_Order(const CsrGraph<Weight>& graph, std::span<const VertexId> order, const char* caller)
+    {
+        if(order.size() != graph.VertexCount())
+        {
+            throw std::invalid_argument(std::string(caller) + ": order of " + std::to_string(order.size()) + " vertices for a graph of " +
+                                        std::to_string(graph.VertexCount()));
+        }
+    }
+
+    template<class Weight>
+    void Check_Non_Negative(const CsrGraph<Weight>& graph, const char* caller)
+    {
+        for(const Weight weight : graph.EdgeWeights())
+        {
+            if(weight < Weight{0})
+            {
+                throw std::invalid_argument(std::string(caller) + ": negative edge weight, use Dag_Shortest_Paths on a DAG");
+            }
+        }
+    }
+
+    /* Unsigned key ordered like the (non-negative) distance */
+    template<class Weight>
+    auto Radix_Key(const Weight distance) noexcept
+    {
+        if constexpr(std::is_same_v<Weight, float>)
+        {
+            return std::bit_cast<std::uint32_t>(distance);
+        }
+        else if constexpr(std::is_same_v<Weight, double>)
+        {
+            return std::bit_cast<std::uint64_t>(distance);
+        }
+        else
+        {
+            return static_cast<std::make_unsigned_t<Weight>>(distance);
+        }
+    }
+
+    /*
+     * Monotone priority queue for unsigned keys: every pushed key must be >= the last popped one.
+     * Bin 0 holds keys equal to the last popped key, bin b keys whose highest bit differing from it
+     * is bit b - 1. Stale entries are left in and skipped by the caller.
+     */
+    template<class Key>
+    class RadixHeap
+    {
+    public:
+        bool Empty() const noexcept { return m_size == 0; }
+
+        void Push(const Key key, const VertexId vertex)
+        {
+            m_bins[Bin(key)].push_back({key, vertex});
+            ++m_size;
+        }
+
+        std::pair<Key, VertexId> Pop()
+        {
+            if(m_bins[0].empty())
+            {
+                std::size_t bin = 1;
+                while(m_bins[bin].empty())
+                {
+                    ++bin;
+                }
+                /* the smallest key of the first non-empty bin becomes the reference, the rest of the bin spreads to lower bins */
+                m_last = std::min_element(m_bins[bin].begin(), m_bins[bin].end())->first;
+                for(const std::pair<Key, VertexId>& entry : m_bins[bin])
+                {
+                    m_bins[Bin(entry.first)].push_back(entry);
+                }
+                m_bins[bin].clear();
+            }
+            const std::pair<Key, VertexId> entry = m_bins[0].back();
+            m_bins[0].pop_back();
+            --m_size;
+            return entry;
+        }
+
+    private:
+        std::size_t Bin(const Key key) const noexcept { return static_cast<std::size_t>(std::bit_width(static_cast<Key>(key ^ m_last))); }
+
+        std::array<std::vector<std::pair<Key, VertexId>>, std::numeric_limits<Key>::digits + 1> m_bins;
+        Key m_last = 0;
+        std::size_t m_size = 0;
+    };
+
+    /*
+     * 4-ary min-heap of (key, vertex). No decrease-key: an improved vertex is pushed again and the
+     * caller skips the stale entry, which saves the position array and its random writes.
+     */
+    template<class Weight>
+    class QuaternaryHeap
+    {
+    public:
+        bool Empty() const noexcept { return m_heap.empty(); }
+
+        void Push(const Weight key, const VertexId vertex)
+        {
+            std::size_t slot = m_heap.size();
+            m_heap.emplace_back();
+            while(slot > 0 && key < m_heap[(slot - 1) / 4].first)
+            {
+                m_heap[slot] = m_heap[(slot - 1) / 4];
+                slot = (slot - 1) / 4;
+            }
+            m_heap[slot] = {key, vertex};
+        }
+
+        std::pair<Weight, VertexId> Pop()
+        {
+            const std::pair<Weight, VertexId> top = m_heap.front();
+            const std::pair<Weight, VertexId> last = m_heap.back();
+            m_heap.pop_back();
+            if(m_heap.empty())
+            {
+                return top;
+            }
+            /* move the hole down to where `last` fits */
+            std::size_t slot = 0;
+            while(true)
+            {
+                const std::size_t first = 4 * slot + 1;
+                if(first >= m_heap.size())
+                {
+                    break;
+                }
+                std::size_t best = first;
+                for(std::size_t child = first + 1; child < std::min(first + 4, m_heap.size()); ++child)
+                {
+                    best = m_heap[child].first < m_heap[best].first ? child : best;
+                }
+                if(!(m_heap[best].first < last.first))
+                {
+                    break;
+                }
+                m_heap[slot] = m_heap[best];
+                slot = best;
+            }
+            m_heap[slot] = last;
+            return top;
+        }
+
+    private:
+        std::vector<std::pair<Weight, VertexId>> m_heap;
+    };
+} /* namespace detail */
+
+/**
+ * @brief Shortest paths from `source` on a DAG in one pass over its topological order.
+ *
+ * @param order: a topological order of `graph`, e.g. from TopologicalSorter
+ *
+ * Example usage:
+ * @code
+ * std::vector<VertexId> order;
+ * TopologicalSorter().Dfs(graph, order);
+ * const ShortestPaths<float> paths = Dag_Shortest_Paths(graph, order, source);
+ * @endcode
+ */
+template<class Weight>
+ShortestPaths<Weight> Dag_Shortest_Paths(const CsrGraph<Weight>& graph, std::span<const VertexId> order, const VertexId source)
+{
+    detail::Check_Source(graph, source, "Dag_Shortest_Paths");
+    detail::Check_Order(graph, order, "Dag_Shortest_Paths");
+    ShortestPaths<Weight> result;
+    result.distance.assign(graph.VertexCount(), ShortestPaths<Weight>::kUnreached);
+    result.parent.assign(graph.VertexCount(), kNoParent);
+    result.distance[source] = Weight{0};
+    result.parent[source] = source;
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    /* nothing before the source in the order is reachable */
+    for(auto it = std::find(order.begin(), order.end(), source); it != order.end(); ++it)
+    {
+        const VertexId vertex = *it;
+        if(result.parent[vertex] == kNoParent)
+        {
+            continue;
+        }
+        for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+        {
+            const Weight distance = result.distance[vertex] + detail::Edge_Weight(graph, edge);
+            if(distance < result.distance[targets[edge]])
+            {
+                result.distance[targets[edge]] = distance;
+                result.parent[targets[edge]] = vertex;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Longest path ending at every vertex of a DAG, starting anywhere, in one pass over its
+ * topological order. The largest distance is the length of the critical path.
+ *
+ * Example usage:
+ * @code
+ * const ShortestPaths<float> longest = Dag_Longest_Paths(taskGraph, order);
+ * const std::vector<VertexId> criticalPath = Critical_Path(longest);
+ * @endcode
+ */
+template<class Weight>
+ShortestPaths<Weight> Dag_Longest_Paths(const CsrGraph<Weight>& graph, std::span<const VertexId> order)
+{
+    detail::Check_Order(graph, order, "Dag_Longest_Paths");
+    ShortestPaths<Weight> result;
+    result.distance.assign(graph.VertexCount(), Weight{0});
+    result.parent.resize(graph.VertexCount());
+    for(std::size_t vertex = 0; vertex < graph.VertexCount(); ++vertex)
+    {
+        result.parent[vertex] = static_cast<VertexId>(vertex);
+    }
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    for(const VertexId vertex : order)
+    {
+        for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+        {
+            const Weight distance = result.distance[vertex] + detail::Edge_Weight(graph, edge);
+            if(result.distance[targets[edge]] < distance)
+            {
+                result.distance[targets[edge]] = distance;
+                result.parent[targets[edge]] = vertex;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief The longest of the paths computed by Dag_Longest_Paths, start first.
+ */
+template<class Weight>
+std::vector<VertexId> Critical_Path(const ShortestPaths<Weight>& longest)
+{
+    if(longest.distance.empty())
+    {
+        return {};
+    }
+    const auto end = std::max_element(longest.distance.begin(), longest.distance.end());
+    return Path_To(longest, static_cast<VertexId>(end - longest.distance.begin()));
+}
+
+/**
+ * @brief Dijkstra's algorithm from `source`; every weight must be non-negative.
+ *
+ * @param queue: RadixHeap (monotone, integer or floating point weights) or QuaternaryHeap
+ *
+ * Example usage:
+ * @code
+ * const ShortestPaths<float> paths = Dijkstra(roads, home, EDijkstraQueue::RadixHeap);
+ * const std::vector<VertexId> route = Path_To(paths, work);
+ * @endcode
+ */
+template<class Weight>
+ShortestPaths<Weight> Dijkstra(const CsrGraph<Weight>& graph, const VertexId source, const EDijkstraQueue queue = EDijkstraQueue::RadixHeap)
+{
+    detail::Check_Source(graph, source, "Dijkstra");
+    detail::Check_Non_Negative(graph, "Dijkstra");
+    ShortestPaths<Weight> result;
+    result.distance.assign(graph.VertexCount(), ShortestPaths<Weight>::kUnreached);
+    result.parent.assign(graph.VertexCount(), kNoParent);
+    result.distance[source] = Weight{0};
+    result.parent[source] = source;
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+
+    /* relax the out-edges of a settled vertex, `improved` queues a target */
+    auto relax = [&](const VertexId vertex, auto&& improved)
+    {
+        for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+        {
+            const Weight distance = result.distance[vertex] + detail::Edge_Weight(graph, edge);
+            const VertexId target = targets[edge];
+            if(distance < result.distance[target])
+            {
+                result.distance[target] = distance;
+                result.parent[target] = vertex;
+                improved(target, distance);
+            }
+        }
+    };
+
+    switch(queue)
+    {
+        case EDijkstraQueue::RadixHeap:
+        {
+            using Key = decltype(detail::Radix_Key(Weight{}));
+            detail::RadixHeap<Key> heap;
+            heap.Push(detail::Radix_Key(Weight{0}), source);
+            while(!heap.Empty())
+            {
+                const auto [key, vertex] = heap.Pop();
+                if(key != detail::Radix_Key(result.distance[vertex]))
+                {
+                    continue; /* stale: the vertex was queued again with a smaller distance */
+                }
+                relax(vertex, [&](const VertexId target, const Weight distance) { heap.Push(detail::Radix_Key(distance), target); });
+            }
+            break;
+        }
+        case EDijkstraQueue::QuaternaryHeap:
+        {
+            detail::QuaternaryHeap<Weight> heap;
+            heap.Push(Weight{0}, source);
+            while(!heap.Empty())
+            {
+                const auto [distance, vertex] = heap.Pop();
+                if(result.distance[vertex] < distance)
+                {
+                    continue;
+                }
+                relax(vertex, [&](const VertexId target, const Weight improved) { heap.Push(improved, target); });
+            }
+            break;
+        }
+        default:
+            throw std::invalid_argument("Dijkstra: unknown queue " + std::to_string(static_cast<int>(queue)));
+    }
+    return result;
+}
+
+/**
+ * @brief Parallel delta-stepping shortest paths from `source`; every weight must be non-negative.
+ *
+ * @param delta: bucket width. Small values approach Dijkstra (little wasted work, many rounds),
+ *        large ones Bellman-Ford. 0 picks max weight / average out-degree.
+ * @param threads: size of the thread team
+ * @return ShortestPaths: parents are derived from the final distances, so with zero weight
+ *         cycles they may form a cycle instead of a tree
+ *
+ * Example usage:
+ * @code
+ * const ShortestPaths<float> paths = Delta_Stepping(roads, home, 0.0f, 8);
+ * @endcode
+ */
+template<class Weight>
+ShortestPaths<Weight> Delta_Stepping(const CsrGraph<Weight>& graph, const VertexId source, Weight delta = Weight{0},
+                                     unsigned threads = Default_Thread_Count())
+{
+    detail::Check_Source(graph, source, "Delta_Stepping");
+    detail::Check_Non_Negative(graph, "Delta_Stepping");
+    threads = std::max(threads, 1u);
+    const std::size_t vertexCount = graph.VertexCount();
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    constexpr Weight kUnreached = ShortestPaths<Weight>::kUnreached;
+    if(!(delta > Weight{0}))
+    {
+        const Weight maxWeight = graph.IsWeighted() ? *std::max_element(graph.EdgeWeights().begin(), graph.EdgeWeights().end()) : Weight{1};
+        const double averageDegree = static_cast<double>(graph.EdgeCount()) / static_cast<double>(std::max<std::size_t>(vertexCount, 1));
+        delta = static_cast<Weight>(static_cast<double>(maxWeight) / std::max(averageDegree, 1.0));
+        delta = delta > Weight{0} ? delta : Weight{1};
+    }
+
+    ShortestPaths<Weight> result;
+    result.distance.assign(vertexCount, kUnreached);
+    result.parent.assign(vertexCount, kNoParent);
+    result.distance[source] = Weight{0};
+    auto binOf = [delta](const Weight distance) { return static_cast<std::size_t>(distance / delta); };
+
+    /* per thread buckets; the frontier holds the current bucket of every thread */
+    std::vector<std::vector<std::vector<VertexId>>> bins(threads);
+    std::vector<std::size_t> copyOffset(threads + 1, 0);
+    std::vector<VertexId> frontier = {source};
+    std::size_t bin = 0;
+    bool bDone = false;
+    std::atomic<std::size_t> cursor = 0;
+    std::barrier barrier(threads);
+
+    auto process = [&](const unsigned thread)
+    {
+        std::vector<std::vector<VertexId>>& local = bins[thread];
+        for(std::size_t begin = cursor.fetch_add(kDeltaSteppingBlock); begin < frontier.size(); begin = cursor.fetch_add(kDeltaSteppingBlock))
+        {
+            for(std::size_t i = begin; i < std::min(begin + kDeltaSteppingBlock, frontier.size()); ++i)
+            {
+                const VertexId vertex = frontier[i];
+                const Weight vertexDistance = std::atomic_ref<Weight>(result.distance[vertex]).load(std::memory_order_relaxed);
+                /* improved into an earlier bucket after it was queued here, and relaxed there */
+                if(binOf(vertexDistance) != bin)
+                {
+                    continue;
+                }
+                for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+                {
+                    const Weight distance = vertexDistance + detail::Edge_Weight(graph, edge);
+                    std::atomic_ref<Weight> target(result.distance[targets[edge]]);
+                    Weight current = target.load(std::memory_order_relaxed);
+                    while(distance < current && !target.compare_exchange_weak(current, distance, std::memory_order_relaxed))
+                    {
+                    }
+                    if(distance < current)
+                    {
+                        const std::size_t targetBin = binOf(distance);
+                        if(targetBin >= local.size())
+                        {
+                            local.resize(targetBin + 1);
+                        }
+                        local[targetBin].push_back(targets[edge]);
+                    }
+                }
+            }
+        }
+    };
+
+    /* thread 0, between the barriers: the next non-empty bucket and where each thread copies its part */
+    auto plan = [&]
+    {
+        std::size_t next = std::numeric_limits<std::size_t>::max();
+        for(const std::vector<std::vector<VertexId>>& local : bins)
+        {
+            for(std::size_t b = bin; b < std::min(local.size(), next); ++b)
+            {
+                if(!local[b].empty())
+                {
+                    next = b;
+                    break;
+                }
+            }
+        }
+        bDone = next == std::numeric_limits<std::size_t>::max();
+        if(bDone)
+        {
+            return;
+        }
+        bin = next;
+        for(unsigned thread = 0; thread < threads; ++thread)
+        {
+            copyOffset[thread + 1] = copyOffset[thread] + (bin < bins[thread].size() ? bins[thread][bin].size() : 0);
+        }
+        frontier.resize(copyOffset[threads]);
+        cursor.store(0, std::memory_order_relaxed);
+    };
+
+    auto work = [&](const unsigned thread)
+    {
+        while(true)
+        {
+            process(thread);
+            barrier.arrive_and_wait();
+            if(thread == 0)
+            {
+                plan();
+            }
+            barrier.arrive_and_wait();
+            if(bDone)
+            {
+                return;
+            }
+            std::vector<std::vector<VertexId>>& local = bins[thread];
+            if(bin < local.size())
+            {
+                std::copy(local[bin].begin(), local[bin].end(), frontier.begin() + static_cast<std::ptrdiff_t>(copyOffset[thread]));
+                local[bin].clear();
+            }
+            barrier.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::jthread> team;
+    team.reserve(threads - 1);
+    for(unsigned thread = 1; thread < threads; ++thread)
+    {
+        team.emplace_back(work, thread);
+    }
+    work(0);
+    team.clear();
+
+    /* any tight edge gives a parent; every reached vertex but the source has one */
+    result.parent[source] = source;
+    Parallel_For_Chunks(vertexCount, threads, [&](unsigned, std::size_t begin, std::size_t end)
+    {
+        for(std::size_t vertex = begin; vertex < end; ++vertex)
+        {
+            if(result.distance[vertex] == kUnreached)
+            {
+                continue;
+            }
+            for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+            {
+                const VertexId target = targets[edge];
+                if(target != source && result.distance[vertex] + detail::Edge_Weight(graph, edge) == result.distance[target])
+                {
+                    VertexId expected = kNoParent;
+                    std::atomic_ref<VertexId>(result.parent[target]).compare_exchange_strong(expected, static_cast<VertexId>(vertex),
+                                                                                              std::memory_order_relaxed);
+                }
+            }
+        }
+    });
+    return result;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+/*
+ * strongly_connected_components.h collapses the cycles of a directed graph.
+ *
+ * Topological sorting needs a DAG; a dependency graph with cycles first has to be condensed:
+ * every strongly connected component (a maximal set of vertices that all reach each other)
+ * becomes one vertex. Strongly_Connected_Components is Pearce's space efficient variant of
+ * Tarjan's algorithm, written with an explicit stack:
+ *
+ *  - one rindex per vertex replaces Tarjan's index, lowlink and on-stack flag: it holds the
+ *    DFS index while a vertex is open and is overwritten with a counter running down from V - 1
+ *    once its component is complete
+ *  - a root bit per vertex and two stacks (the DFS path with one edge cursor per frame, and the
+ *    vertices of components not yet complete)
+ *
+ * So memory is 4 bytes + 1 bit per vertex plus the stacks, all linear in V, with nothing per
+ * edge. Components complete sinks first, which makes (number of components - 1 - completion
+ * rank) a topological order of the condensation; the component ids are assigned that way, so an
+ * edge u -> v always has component(u) <= component(v) and no separate sort of the condensation
+ * is needed. Condense builds the condensation itself as a CsrGraph without duplicate edges.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graph/csr_graph.h"
+
+/* Out-edges whose targets are prefetched when the DFS enters a vertex */
+constexpr EdgeId kSccPrefetchEdges = 16;
+
+/*
+ * Result of Strongly_Connected_Components
+ */
+struct StronglyConnectedComponents
+{
+    std::vector<VertexId> component;     /* vertex -> component; ids are a topological order of the condensation */
+    std::vector<VertexId> memberOffsets; /* component c is members[memberOffsets[c], memberOffsets[c + 1]) */
+    std::vector<VertexId> members;       /* vertices grouped by component */
+
+    std::size_t ComponentCount() const noexcept { return memberOffsets.empty() ? 0 : memberOffsets.size() - 1; }
+
+    std::span<const VertexId> Members(const VertexId componentId) const noexcept
+    {
+        return std::span<const VertexId>(members).subspan(memberOffsets[componentId], memberOffsets[componentId + 1] - memberOffsets[componentId]);
+    }
+};
+
+/**
+ * @brief Strongly connected components by Pearce's iterative algorithm, in topological order.
+ *
+ * @return StronglyConnectedComponents: every edge u -> v has component[u] <= component[v], equal
+ *         exactly when u and v lie on a common cycle
+ *
+ * Example usage:
+ * @code
+ * const StronglyConnectedComponents scc = Strongly_Connected_Components(graph);
+ * const CsrGraph<> dag = Condense(graph, scc);
+ * for(VertexId component = 0; component < scc.ComponentCount(); ++component)
+ * {
+ *     Build_Together(scc.Members(component)); // dependencies of earlier components are done
+ * }
+ * @endcode
+ */
+template<class Weight>
+StronglyConnectedComponents Strongly_Connected_Components(const CsrGraph<Weight>& graph)
+{
+    struct Frame
+    {
+        EdgeId nextEdge;
+        VertexId vertex;
+    };
+
+    const std::size_t vertexCount = graph.VertexCount();
+    const std::span<const EdgeId> offsets = graph.Offsets();
+    const std::span<const VertexId> targets = graph.Targets();
+    StronglyConnectedComponents result;
+    if(vertexCount == 0)
+    {
+        result.memberOffsets = {0};
+        return result;
+    }
+    /* rindex lives in result.component and is turned into the component id at the end */
+    std::vector<VertexId>& rindex = result.component;
+    rindex.assign(vertexCount, 0);
+    std::vector<bool> root(vertexCount, false);
+    std::vector<Frame> path;
+    std::vector<VertexId> open;
+    VertexId index = 1;
+    VertexId completed = static_cast<VertexId>(vertexCount - 1);
+
+    auto beginVisit = [&](const VertexId vertex)
+    {
+        path.push_back({offsets[vertex], vertex});
+        /* the DFS itself can not run ahead, but the edges of this vertex are all checked soon */
+        for(EdgeId edge = offsets[vertex]; edge < std::min(offsets[vertex + 1], offsets[vertex] + kSccPrefetchEdges); ++edge)
+        {
+            __builtin_prefetch(&rindex[targets[edge]]);
+        }
+        root[vertex] = true;
+        rindex[vertex] = index++;
+    };
+
+    for(std::size_t start = 0; start < vertexCount; ++start)
+    {
+        if(rindex[start] != 0)
+        {
+            continue;
+        }
+        beginVisit(static_cast<VertexId>(start));
+        while(!path.empty())
+        {
+            Frame& frame = path.back();
+            const VertexId vertex = frame.vertex;
+            bool bDescended = false;
+            for(; frame.nextEdge < offsets[vertex + 1]; ++frame.nextEdge)
+            {
+                const VertexId next = targets[frame.nextEdge];
+                if(rindex[next] == 0)
+                {
+                    /* the cursor stays on this edge, it is finished when `next` returns */
+                    beginVisit(next);
+                    bDescended = true;
+                    break;
+                }
+                if(rindex[next] < rindex[vertex])
+                {
+                    rindex[vertex] = rindex[next];
+                    root[vertex] = false;
+                }
+            }
+            if(bDescended)
+            {
+                continue;
+            }
+            path.pop_back();
+            if(root[vertex])
+            {
+                /* vertex and everything above it on `open` form one component */
+                --index;
+                while(!open.empty() && rindex[vertex] <= rindex[open.back()])
+                {
+                    rindex[open.back()] = completed;
+                    open.pop_back();
+                    --index;
+                }
+                rindex[vertex] = completed--;
+            }
+            else
+            {
+                open.push_back(vertex);
+            }
+        }
+    }
+
+    /* completed ran down from V - 1, one step per component, sinks first; with V components it
+       wrapped to UINT32_MAX, so the count is taken modulo 2^32 like the ids below */
+    const std::size_t componentCount = static_cast<VertexId>(vertexCount - 1 - completed);
+    result.memberOffsets.assign(componentCount + 1, 0);
+    for(VertexId& id : rindex)
+    {
+        id = id - completed - 1;
+        ++result.memberOffsets[id + 1];
+    }
+    for(std::size_t id = 0; id < componentCount; ++id)
+    {
+        result.memberOffsets[id + 1] += result.memberOffsets[id];
+    }
+    result.members.resize(vertexCount);
+    std::vector<VertexId> cursor(result.memberOffsets.begin(), result.memberOffsets.end() - 1);
+    for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        result.members[cursor[rindex[vertex]]++] = static_cast<VertexId>(vertex);
+    }
+    return result;
+}
+
+/**
+ * @brief The condensation: one vertex per component, one edge per pair of components that an
+ * edge of `graph` connects. Vertex ids are the component ids, so 0, 1, ... is a topological order.
+ */
+template<class Weight>
+CsrGraph<Weight> Condense(const CsrGraph<Weight>& graph, const StronglyConnectedComponents& scc)
+{
+    const std::size_t componentCount = scc.ComponentCount();
+    std::vector<EdgeId> offsets(componentCount + 1, 0);
+    std::vector<VertexId> targets;
+    /* last component that already has an edge to this one; component + 1, 0 for none */
+    std::vector<VertexId> lastSource(componentCount, 0);
+    for(std::size_t component = 0; component < componentCount; ++component)
+    {
+        for(VertexId vertex : scc.Members(static_cast<VertexId>(component)))
+        {
+            for(VertexId next : graph.Neighbors(vertex))
+            {
+                const VertexId target = scc.component[next];
+                if(target != component && lastSource[target] != component + 1)
+                {
+                    lastSource[target] = static_cast<VertexId>(component + 1);
+                    targets.push_back(target);
+                }
+            }
+        }
+        offsets[component + 1] = targets.size();
+    }
+    targets.shrink_to_fit();
+    return CsrGraph<Weight>(std::move(offsets), std::move(targets));
+}
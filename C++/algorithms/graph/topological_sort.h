@@ -0,0 +1,257 @@
+#pragma once
+
+/*
+ * topological_sort.h orders the vertices of a CsrGraph so every edge points forward.
+ *
+ * Graph::topologicalSortUtil in TopologicalSort.cpp recurses once per vertex on the current path,
+ * so a dependency chain of a few hundred thousand vertices overflows the thread stack, and on a
+ * cyclic graph it quietly prints an order that violates the back edge. Both algorithms here are
+ * iterative and report a cycle instead:
+ *
+ *  - Dfs: explicit stack DFS with three vertex states; the result is the reverse postorder, the
+ *    same order the recursive version prints. Meeting a vertex that is still on the stack is a
+ *    back edge, and the stack above it is the cycle.
+ *  - Kahn: repeatedly takes vertices whose predecessors are all placed. The output array doubles
+ *    as the FIFO queue. Vertices left over at the end lie on or behind a cycle, which is then
+ *    extracted with the DFS.
+ *
+ * TopologicalSorter keeps its scratch arrays between calls, so sorting many graphs (or the same
+ * graph again after an edit) does not allocate once the buffers have grown.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graph/csr_graph.h"
+
+/*
+ * Algorithm used by Topological_Sort
+ */
+enum class ETopologicalSortMethod : int
+{
+    Dfs,
+    Kahn,
+    AutoCount /* Should be last! Number of methods */
+};
+
+inline const char* Topological_Sort_Method_Name(const ETopologicalSortMethod method) noexcept
+{
+    switch(method)
+    {
+        case ETopologicalSortMethod::Kahn:
+            return "kahn";
+        case ETopologicalSortMethod::Dfs:
+        default:
+            return "dfs";
+    }
+}
+
+/**
+ * @brief Iterative topological sorts with reusable scratch buffers.
+ *
+ * Example usage:
+ * @code
+ * TopologicalSorter sorter;
+ * std::vector<VertexId> order;
+ * if(!sorter.Dfs(graph, order))
+ * {
+ *     Report_Cycle(sorter.Cycle()); // v0 -> v1 -> ... -> v0
+ * }
+ * @endcode
+ */
+class TopologicalSorter
+{
+public:
+    /**
+     * @brief Topological order by depth first search (reverse postorder, roots in id order).
+     *
+     * @param order: output, all vertices on success; left empty when the graph has a cycle
+     * @return bool: false when the graph has a cycle, Cycle() then holds one
+     */
+    template<class Weight>
+    bool Dfs(const CsrGraph<Weight>& graph, std::vector<VertexId>& order)
+    {
+        const std::size_t vertexCount = graph.VertexCount();
+        order.resize(vertexCount);
+        m_cycle.clear();
+        if(!Depth_First(graph, order.data()))
+        {
+            order.clear();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Topological order by Kahn's algorithm (sources first, in id order, then FIFO).
+     *
+     * @param order: output, all vertices on success; left empty when the graph has a cycle
+     * @return bool: false when the graph has a cycle, Cycle() then holds one
+     */
+    template<class Weight>
+    bool Kahn(const CsrGraph<Weight>& graph, std::vector<VertexId>& order)
+    {
+        const std::size_t vertexCount = graph.VertexCount();
+        const std::span<const EdgeId> offsets = graph.Offsets();
+        const std::span<const VertexId> targets = graph.Targets();
+        m_cycle.clear();
+        m_inDegree.assign(vertexCount, 0);
+        for(VertexId target : targets)
+        {
+            ++m_inDegree[target];
+        }
+        order.resize(vertexCount);
+        std::size_t tail = 0;
+        for(std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            if(m_inDegree[vertex] == 0)
+            {
+                order[tail++] = static_cast<VertexId>(vertex);
+            }
+        }
+        /* order[0, head) is final, order[head, tail) is the queue */
+        for(std::size_t head = 0; head < tail; ++head)
+        {
+            const VertexId vertex = order[head];
+            for(EdgeId edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+            {
+                if(--m_inDegree[targets[edge]] == 0)
+                {
+                    order[tail++] = targets[edge];
+                }
+            }
+        }
+        if(tail == vertexCount)
+        {
+            return true;
+        }
+        order.clear();
+        /* only the cycle is wanted now; reuse the in-degree array as the DFS output */
+        m_inDegree.resize(vertexCount);
+        Depth_First(graph, m_inDegree.data());
+        return false;
+    }
+
+    /* The cycle found by the last failed call, each vertex has an edge to the next, the last to the first */
+    std::span<const VertexId> Cycle() const noexcept { return m_cycle; }
+
+    /* Bytes held by the scratch buffers */
+    std::size_t MemoryBytes() const noexcept
+    {
+        return m_state.capacity() + m_stack.capacity() * sizeof(Frame) + m_inDegree.capacity() * sizeof(VertexId) +
+               m_cycle.capacity() * sizeof(VertexId);
+    }
+
+private:
+    enum class EVisit : std::uint8_t
+    {
+        New,
+        OnStack,
+        Done,
+        AutoCount /* Should be last! Number of states */
+    };
+
+    struct Frame
+    {
+        EdgeId nextEdge;
+        EdgeId endEdge;
+        VertexId vertex;
+    };
+
+    /* Writes the reverse postorder backwards into output[0, V); false and m_cycle filled on a back edge */
+    template<class Weight>
+    bool Depth_First(const CsrGraph<Weight>& graph, VertexId* output)
+    {
+        const std::size_t vertexCount = graph.VertexCount();
+        const std::span<const EdgeId> offsets = graph.Offsets();
+        const std::span<const VertexId> targets = graph.Targets();
+        m_state.assign(vertexCount, EVisit::New);
+        m_stack.clear();
+        std::size_t position = vertexCount;
+        for(std::size_t root = 0; root < vertexCount; ++root)
+        {
+            if(m_state[root] != EVisit::New)
+            {
+                continue;
+            }
+            m_state[root] = EVisit::OnStack;
+            m_stack.push_back({offsets[root], offsets[root + 1], static_cast<VertexId>(root)});
+            while(!m_stack.empty())
+            {
+                Frame& frame = m_stack.back();
+                if(frame.nextEdge == frame.endEdge)
+                {
+                    m_state[frame.vertex] = EVisit::Done;
+                    output[--position] = frame.vertex;
+                    m_stack.pop_back();
+                    continue;
+                }
+                const VertexId next = targets[frame.nextEdge++];
+                if(m_state[next] == EVisit::New)
+                {
+                    m_state[next] = EVisit::OnStack;
+                    m_stack.push_back({offsets[next], offsets[next + 1], next});
+                }
+                else if(m_state[next] == EVisit::OnStack)
+                {
+                    Extract_Cycle(next);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /* The stack from `first` up to the top is a path, and the top has an edge back to `first` */
+    void Extract_Cycle(const VertexId first)
+    {
+        std::size_t bottom = m_stack.size();
+        while(m_stack[bottom - 1].vertex != first)
+        {
+            --bottom;
+        }
+        for(std::size_t i = bottom - 1; i < m_stack.size(); ++i)
+        {
+            m_cycle.push_back(m_stack[i].vertex);
+        }
+    }
+
+    std::vector<EVisit> m_state;
+    std::vector<Frame> m_stack;
+    std::vector<VertexId> m_inDegree;
+    std::vector<VertexId> m_cycle;
+};
+
+/*
+ * Result of the one shot Topological_Sort
+ */
+struct TopologicalSortResult
+{
+    std::vector<VertexId> order; /* empty when the graph has a cycle */
+    std::vector<VertexId> cycle; /* empty when the graph is a DAG */
+
+    bool HasCycle() const noexcept { return !cycle.empty(); }
+};
+
+/**
+ * @brief One shot topological sort, allocates its scratch buffers per call.
+ *
+ * Example usage:
+ * @code
+ * const TopologicalSortResult result = Topological_Sort(graph, ETopologicalSortMethod::Kahn);
+ * @endcode
+ */
+template<class Weight>
+TopologicalSortResult Topological_Sort(const CsrGraph<Weight>& graph, const ETopologicalSortMethod method = ETopologicalSortMethod::Dfs)
+{
+    TopologicalSorter sorter;
+    TopologicalSortResult result;
+    const bool bSorted = method == ETopologicalSortMethod::Kahn ? sorter.Kahn(graph, result.order) : sorter.Dfs(graph, result.order);
+    if(!bSorted)
+    {
+        result.cycle.assign(sorter.Cycle().begin(), sorter.Cycle().end());
+    }
+    return result;
+}
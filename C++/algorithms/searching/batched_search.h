@@ -0,0 +1,150 @@
+#pragma once
+
+/*
+ * batched_search.h answers many independent lower bound queries against one sorted array.
+ *
+ * A single binary search is latency bound: each probe address depends on the previous compare,
+ * so at most one cache miss is in flight. Here a group of queries advances in lockstep, one
+ * halving step for every query of the group per round, so the group's loads are independent and
+ * overlap (the interleaved / coroutine style of hiding memory latency, with the per query state
+ * reduced to one offset). The branchless halving makes this cheap: every query over the same
+ * array goes through exactly the same sequence of range lengths, only the offsets differ.
+ *
+ * Sorting the queries first is optional. Neighbouring queries then walk nearly the same path and
+ * share the cache lines of the lower levels, at the cost of the sort and a scatter of the results.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "sorting/key_value_sort.h"
+
+/*
+ * Order in which a batch visits its queries
+ */
+enum class EQueryOrder : int
+{
+    AsGiven,
+    Sorted,
+    AutoCount /* Should be last! Number of orders */
+};
+
+inline const char* Query_Order_Name(const EQueryOrder order) noexcept
+{
+    switch(order)
+    {
+        case EQueryOrder::Sorted:
+            return "sorted";
+        case EQueryOrder::AsGiven:
+        default:
+            return "as-given";
+    }
+}
+
+namespace detail
+{
+    /**
+     * @brief Lower bound of queries[0, count) in data[0, size), Lanes queries advancing in lockstep.
+     */
+    template<std::size_t Lanes, class T, class Compare>
+    void Lower_Bound_Lanes(const T* data, const std::size_t size, const T* queries, std::size_t* positions, const std::size_t count, Compare comp)
+    {
+        if(size == 0)
+        {
+            std::fill(positions, positions + count, std::size_t{0});
+            return;
+        }
+        for(std::size_t group = 0; group < count; group += Lanes)
+        {
+            const std::size_t lanes = std::min(Lanes, count - group);
+            const T* laneQueries = queries + group;
+            std::size_t base[Lanes] = {};
+            std::size_t length = size;
+            while(length > 1)
+            {
+                const std::size_t half = length / 2;
+                const std::size_t nextProbe = (length - half) / 2; /* probe offset of the next round, 0 when it is the last */
+                for(std::size_t lane = 0; lane < lanes; ++lane)
+                {
+                    /* multiply instead of ?: so GCC does not turn the select back into a branch */
+                    base[lane] += half * static_cast<std::size_t>(comp(data[base[lane] + half - 1], laneQueries[lane]));
+                    __builtin_prefetch(data + base[lane] + (nextProbe == 0 ? 0 : nextProbe - 1));
+                }
+                length -= half;
+            }
+            for(std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                positions[group + lane] = base[lane] + static_cast<std::size_t>(comp(data[base[lane]], laneQueries[lane]));
+            }
+        }
+    }
+} /* namespace detail */
+
+/**
+ * @brief positions[i] = std::lower_bound(sorted, queries[i]) - sorted.begin() for every query.
+ *
+ * @tparam Lanes: queries in flight at once, 16 - 32 saturates the miss handling of current cores
+ * @param sorted: keys in ascending order under `comp`
+ * @param queries: keys to look up, any order
+ * @param positions: output, same length as queries
+ * @param order: EQueryOrder::Sorted visits the queries in ascending order (results still line up with `queries`)
+ * @param comp: strict weak ordering `sorted` is sorted by
+ *
+ * Example usage:
+ * @code
+ * std::vector<std::size_t> positions(queries.size());
+ * Lower_Bound_Batch(std::span<const std::int64_t>(table), std::span<const std::int64_t>(queries), std::span(positions));
+ * @endcode
+ */
+template<std::size_t Lanes = 16, class T, class Compare = std::less<>>
+void Lower_Bound_Batch(std::span<const T> sorted, std::span<const T> queries, std::span<std::size_t> positions,
+                       const EQueryOrder order = EQueryOrder::AsGiven, Compare comp = {})
+{
+    static_assert(Lanes > 0, "a batch needs at least one lane");
+    if(order != EQueryOrder::Sorted)
+    {
+        detail::Lower_Bound_Lanes<Lanes>(sorted.data(), sorted.size(), queries.data(), positions.data(), queries.size(), comp);
+        return;
+    }
+
+    std::vector<std::uint32_t> visitOrder;
+    if constexpr(std::is_arithmetic_v<T> && (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>))
+    {
+        visitOrder = Arg_Sort(queries);
+    }
+    else
+    {
+        visitOrder = Arg_Sort(queries, comp);
+    }
+    std::vector<T> sortedQueries(queries.size());
+    for(std::size_t i = 0; i < queries.size(); ++i)
+    {
+        sortedQueries[i] = queries[visitOrder[i]];
+    }
+    std::vector<std::size_t> sortedPositions(queries.size());
+    detail::Lower_Bound_Lanes<Lanes>(sorted.data(), sorted.size(), sortedQueries.data(), sortedPositions.data(), queries.size(), comp);
+    for(std::size_t i = 0; i < queries.size(); ++i)
+    {
+        positions[visitOrder[i]] = sortedPositions[i];
+    }
+}
+
+/**
+ * @brief Batched membership test: found[i] tells whether queries[i] occurs in `sorted`.
+ */
+template<std::size_t Lanes = 16, class T, class Compare = std::less<>>
+void Contains_Batch(std::span<const T> sorted, std::span<const T> queries, std::span<bool> found,
+                    const EQueryOrder order = EQueryOrder::AsGiven, Compare comp = {})
+{
+    std::vector<std::size_t> positions(queries.size());
+    Lower_Bound_Batch<Lanes>(sorted, queries, std::span(positions), order, comp);
+    for(std::size_t i = 0; i < queries.size(); ++i)
+    {
+        found[i] = positions[i] < sorted.size() && !comp(queries[i], sorted[positions[i]]);
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+ * binary_search.h is a branchless replacement for the recursive binarySearch in binary_search.cpp.
+ *
+ * Every step halves the range with a conditional move instead of a data dependent branch, so
+ * there is nothing for the branch predictor to get wrong (on random queries it is wrong half
+ * the time). Because the loop no longer speculates down one side, the next probe address is
+ * unknown until the comparison retires; both candidates are therefore prefetched one level
+ * ahead, which overlaps the cache miss of level i + 1 with the compare of level i.
+ *
+ * The functions mirror std::lower_bound / upper_bound / equal_range and work with any random
+ * access iterator and comparator; prefetching is only issued for contiguous iterators.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace detail
+{
+    template<class Iterator>
+    inline void Prefetch_At(Iterator position) noexcept
+    {
+        if constexpr(std::contiguous_iterator<Iterator>)
+        {
+            __builtin_prefetch(std::to_address(position));
+        }
+    }
+
+    /**
+     * @brief Shared branchless halving loop.
+     *
+     * `goesRight(element)` must be monotone over the range (false ... false true ... true reversed:
+     * true for a prefix, then false). Returns the first position where it is false.
+     */
+    template<bool bPrefetch, class Iterator, class GoesRight>
+    Iterator Branchless_Partition_Point(Iterator first, Iterator last, GoesRight goesRight)
+    {
+        std::size_t length = static_cast<std::size_t>(std::distance(first, last));
+        if(length == 0)
+        {
+            return first;
+        }
+        std::size_t base = 0;
+        while(length > 1)
+        {
+            const std::size_t half = length / 2;
+            if constexpr(bPrefetch)
+            {
+                /* the next probe is at base + next - 1 or base + half + next - 1; when next is 0
+                   there is none and base / base + half are prefetched instead, without a branch */
+                const std::size_t next = (length - half) / 2;
+                const std::size_t probe = next - static_cast<std::size_t>(next != 0);
+                Prefetch_At(first + static_cast<std::ptrdiff_t>(base + probe));
+                Prefetch_At(first + static_cast<std::ptrdiff_t>(base + half + probe));
+            }
+            base += goesRight(first[static_cast<std::ptrdiff_t>(base + half - 1)]) ? half : 0;
+            length -= half;
+        }
+        return first + static_cast<std::ptrdiff_t>(base + (goesRight(first[static_cast<std::ptrdiff_t>(base)]) ? 1 : 0));
+    }
+} /* namespace detail */
+
+/**
+ * @brief First position in the sorted range whose element is not less than `value`.
+ *
+ * @tparam bPrefetch: prefetch both possible next probes (default); pays off once the table outgrows
+ *                   L2 (a few MB), costs ~10-20 ns per query on tables that stay in cache
+ * @param first, last: sorted random access range
+ * @param value: key to look for
+ * @param comp: strict weak ordering the range is sorted by
+ *
+ * Example usage:
+ * @code
+ * auto position = Lower_Bound(table.begin(), table.end(), key);
+ * bool bFound = position != table.end() && *position == key;
+ * @endcode
+ *
+ * @return Iterator: same result as std::lower_bound
+ */
+template<bool bPrefetch = true, class Iterator, class T, class Compare = std::less<>>
+Iterator Lower_Bound(Iterator first, Iterator last, const T& value, Compare comp = {})
+{
+    return detail::Branchless_Partition_Point<bPrefetch>(first, last, [&](const auto& element) { return comp(element, value); });
+}
+
+/**
+ * @brief First position in the sorted range whose element is greater than `value`.
+ *
+ * @return Iterator: same result as std::upper_bound
+ */
+template<bool bPrefetch = true, class Iterator, class T, class Compare = std::less<>>
+Iterator Upper_Bound(Iterator first, Iterator last, const T& value, Compare comp = {})
+{
+    return detail::Branchless_Partition_Point<bPrefetch>(first, last, [&](const auto& element) { return !comp(value, element); });
+}
+
+/**
+ * @brief Range of elements equivalent to `value`.
+ *
+ * The upper bound search starts from the lower bound instead of `first`.
+ *
+ * @return std::pair<Iterator, Iterator>: same result as std::equal_range
+ */
+template<bool bPrefetch = true, class Iterator, class T, class Compare = std::less<>>
+std::pair<Iterator, Iterator> Equal_Range(Iterator first, Iterator last, const T& value, Compare comp = {})
+{
+    Iterator lower = Lower_Bound<bPrefetch>(first, last, value, comp);
+    return {lower, Upper_Bound<bPrefetch>(lower, last, value, comp)};
+}
+
+/**
+ * @brief Drop-in for binarySearch(arr, l, r, x): index of `value` in the sorted span, or -1.
+ *
+ * When the key occurs more than once the first occurrence is returned.
+ */
+template<class T, class Compare = std::less<>>
+std::ptrdiff_t Binary_Search_Index(std::span<const T> data, const T& value, Compare comp = {})
+{
+    const auto position = Lower_Bound(data.begin(), data.end(), value, comp);
+    return position != data.end() && !comp(value, *position) ? position - data.begin() : -1;
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+/*
+ * interpolation_search.h holds the searches that use more than one comparison's worth of
+ * information per probe.
+ *
+ *  - Interpolation_Lower_Bound guesses the position from the key values at both ends of the range.
+ *    On near uniform keys it needs O(log log n) probes instead of log2(n). Every guess is followed by
+ *    a guard probe kInterpolationGuard positions further, so a close guess ends the search at once.
+ *    When a step fails to halve the range, a binary step follows, which bounds the worst case
+ *    (skewed keys) to about 2 log2(n) probes.
+ *  - Exponential_Lower_Bound gallops from a hint (a previous result, a cursor in a merge) with steps
+ *    1, 2, 4, ... and binary searches the last step, O(log d) for an answer d positions away.
+ *  - AdaptiveSearch times interpolation and the branchless binary search once on keys sampled from
+ *    an array and answers every later lookup with whichever was faster on that array.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "searching/binary_search.h"
+
+/*
+ * Distance of the guard probe behind every interpolated probe
+ */
+constexpr std::size_t kInterpolationGuard = 8;
+
+/*
+ * Ranges this short are finished with a branchless binary search
+ */
+constexpr std::size_t kInterpolationFinish = 32;
+
+/*
+ * Strategies AdaptiveSearch chooses from
+ */
+enum class ESearchStrategy : int
+{
+    Binary,
+    Interpolation,
+    AutoCount /* Should be last! Number of strategies */
+};
+
+inline const char* Search_Strategy_Name(const ESearchStrategy strategy) noexcept
+{
+    switch(strategy)
+    {
+        case ESearchStrategy::Interpolation:
+            return "interpolation";
+        case ESearchStrategy::Binary:
+        default:
+            return "binary";
+    }
+}
+
+namespace detail
+{
+    /**
+     * @brief Interpolation lower bound that also counts its interpolation steps.
+     *
+     * Invariant: the answer is in [low, high], data[low - 1] < value and value <= data[high].
+     */
+    template<class T>
+    std::size_t Interpolation_Lower_Bound_Counted(const T* data, const std::size_t size, const T value, std::size_t& steps) noexcept
+    {
+        std::size_t low = 0;
+        std::size_t high = size;
+        while(high - low > kInterpolationFinish)
+        {
+            ++steps;
+            const T left = data[low];
+            const T right = data[high - 1];
+            if(!(left < value))
+            {
+                return low;
+            }
+            if(right < value)
+            {
+                return high;
+            }
+            /* left < value <= right, but 64 bit keys above 2^53 can round to equal doubles, which
+               gives 0 / 0 or x / 0: probe the middle then */
+            const double denominator = static_cast<double>(right) - static_cast<double>(left);
+            const double fraction = (static_cast<double>(value) - static_cast<double>(left)) / denominator;
+            const std::size_t span = high - 1 - low;
+            const std::size_t probe = denominator > 0.0 && fraction >= 0.0 && fraction <= 1.0
+                                          ? low + std::min(static_cast<std::size_t>(fraction * static_cast<double>(span)), span)
+                                          : low + span / 2;
+            const std::size_t before = high - low;
+            if(data[probe] < value)
+            {
+                low = probe + 1;
+                const std::size_t guard = probe + kInterpolationGuard;
+                if(guard < high)
+                {
+                    if(data[guard] < value)
+                    {
+                        low = guard + 1;
+                    }
+                    else
+                    {
+                        high = guard;
+                    }
+                }
+            }
+            else
+            {
+                high = probe;
+                if(probe >= low + kInterpolationGuard)
+                {
+                    const std::size_t guard = probe - kInterpolationGuard;
+                    if(data[guard] < value)
+                    {
+                        low = guard + 1;
+                    }
+                    else
+                    {
+                        high = guard;
+                    }
+                }
+            }
+            /* a poor guess (skewed keys) is followed by a binary step so the range at least halves */
+            if(high - low > before / 2)
+            {
+                const std::size_t middle = low + (high - low) / 2;
+                if(data[middle] < value)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+        }
+        return static_cast<std::size_t>(Lower_Bound<false>(data + low, data + high, value) - data);
+    }
+} /* namespace detail */
+
+/**
+ * @brief Lower bound by interpolation, with guard probes and binary fallback steps.
+ *
+ * @param sorted: arithmetic keys in ascending order (no NaN)
+ * @param value: key to look for
+ *
+ * Example usage:
+ * @code
+ * std::size_t position = Interpolation_Lower_Bound(std::span<const std::int64_t>(timestamps), now);
+ * @endcode
+ *
+ * @return std::size_t: same position as std::lower_bound
+ */
+template<class T>
+std::size_t Interpolation_Lower_Bound(std::span<const T> sorted, const T value) noexcept
+{
+    static_assert(std::is_arithmetic_v<T>, "interpolation needs arithmetic keys");
+    std::size_t steps = 0;
+    return detail::Interpolation_Lower_Bound_Counted(sorted.data(), sorted.size(), value, steps);
+}
+
+/**
+ * @brief Lower bound by galloping away from `hint`.
+ *
+ * @param sorted: keys in ascending order under `comp`
+ * @param value: key to look for
+ * @param hint: position expected near the answer, e.g. the previous result; clamped to the range
+ * @param comp: strict weak ordering `sorted` is sorted by
+ *
+ * Example usage:
+ * @code
+ * std::size_t position = 0;
+ * for(std::int64_t key : ascendingKeys)
+ * {
+ *     position = Exponential_Lower_Bound(std::span<const std::int64_t>(table), key, position);
+ * }
+ * @endcode
+ *
+ * @return std::size_t: same position as std::lower_bound
+ */
+template<class T, class Compare = std::less<>>
+std::size_t Exponential_Lower_Bound(std::span<const T> sorted, const T& value, std::size_t hint, Compare comp = {})
+{
+    const std::size_t size = sorted.size();
+    if(size == 0)
+    {
+        return 0;
+    }
+    hint = std::min(hint, size - 1);
+    std::size_t low = 0;
+    std::size_t high = size;
+    if(comp(sorted[hint], value))
+    {
+        /* answer in (hint, size] */
+        low = hint + 1;
+        for(std::size_t step = 1;; step *= 2)
+        {
+            const std::size_t probe = hint + step;
+            if(probe >= size)
+            {
+                break;
+            }
+            if(!comp(sorted[probe], value))
+            {
+                high = probe;
+                break;
+            }
+            low = probe + 1;
+        }
+    }
+    else
+    {
+        /* answer in [0, hint] */
+        high = hint;
+        for(std::size_t step = 1; step <= hint; step *= 2)
+        {
+            const std::size_t probe = hint - step;
+            if(comp(sorted[probe], value))
+            {
+                low = probe + 1;
+                break;
+            }
+            high = probe;
+        }
+    }
+    return static_cast<std::size_t>(Lower_Bound<false>(sorted.begin() + static_cast<std::ptrdiff_t>(low),
+                                                       sorted.begin() + static_cast<std::ptrdiff_t>(high), value, comp) - sorted.begin());
+}
+
+/**
+ * @brief Lower bound search that picks interpolation or binary search per array.
+ *
+ * The constructor times both searches on kTimingRounds rounds of `samples` keys spread over the
+ * array and keeps the one whose best round was faster. Which one wins depends on the key
+ * distribution and on where the array sits in the memory hierarchy, so it is measured rather
+ * than predicted: on uniform keys interpolation's few steps lose to the cheap cached halvings of
+ * a small array and win once the halvings miss. The array must stay alive and unchanged while
+ * the search is used.
+ *
+ * Example usage:
+ * @code
+ * const AdaptiveSearch<std::int64_t> search(std::span<const std::int64_t>(table));
+ * std::size_t position = search.LowerBound(key);
+ * std::size_t next = search.LowerBound(nextKey, position); // gallops from the previous result
+ * @endcode
+ */
+template<class T>
+class AdaptiveSearch
+{
+public:
+    static constexpr std::size_t kDefaultSamples = 1024;
+    static constexpr unsigned kTimingRounds = 3;
+
+    explicit AdaptiveSearch(std::span<const T> sorted, const std::size_t samples = kDefaultSamples)
+        : m_data(sorted)
+    {
+        static_assert(std::is_arithmetic_v<T>, "interpolation needs arithmetic keys");
+        if(sorted.size() <= kInterpolationFinish || samples == 0)
+        {
+            return;
+        }
+        /* every round gets its own keys: replayed keys would train the branch predictor on
+           interpolation's branches, which the branchless binary search has none of */
+        const std::size_t queryCount = samples * kTimingRounds;
+        std::vector<T> queries(queryCount);
+        for(std::size_t query = 0; query < queryCount; ++query)
+        {
+            queries[query] = sorted[(2 * query + 1) * sorted.size() / (2 * queryCount)];
+        }
+        std::shuffle(queries.begin(), queries.end(), std::minstd_rand(static_cast<std::uint_fast32_t>(samples)));
+
+        using Clock = std::chrono::steady_clock;
+        Clock::duration binaryTime = Clock::duration::max();
+        Clock::duration interpolationTime = Clock::duration::max();
+        std::size_t checksum = 0;
+        for(unsigned round = 0; round < kTimingRounds; ++round)
+        {
+            const std::span<const T> roundQueries(queries.data() + round * samples, samples);
+            const Clock::time_point start = Clock::now();
+            for(const T query : roundQueries)
+            {
+                checksum += static_cast<std::size_t>(Lower_Bound(sorted.begin(), sorted.end(), query) - sorted.begin());
+            }
+            const Clock::time_point middle = Clock::now();
+            for(const T query : roundQueries)
+            {
+                checksum += Interpolation_Lower_Bound(sorted, query);
+            }
+            const Clock::time_point end = Clock::now();
+            binaryTime = std::min(binaryTime, middle - start);
+            interpolationTime = std::min(interpolationTime, end - middle);
+        }
+        /* the volatile store keeps the timed loops from being optimized away */
+        volatile std::size_t sink = checksum;
+        static_cast<void>(sink);
+
+        std::size_t steps = 0;
+        for(const T query : queries)
+        {
+            detail::Interpolation_Lower_Bound_Counted(sorted.data(), sorted.size(), query, steps);
+        }
+        m_interpolationSteps = static_cast<double>(steps) / static_cast<double>(queryCount);
+        if(interpolationTime < binaryTime)
+        {
+            m_strategy = ESearchStrategy::Interpolation;
+        }
+    }
+
+    /**
+     * @return std::size_t: same position as std::lower_bound
+     */
+    std::size_t LowerBound(const T value) const noexcept
+    {
+        if(m_strategy == ESearchStrategy::Interpolation)
+        {
+            return Interpolation_Lower_Bound(m_data, value);
+        }
+        return static_cast<std::size_t>(Lower_Bound(m_data.begin(), m_data.end(), value) - m_data.begin());
+    }
+
+    /**
+     * @brief Lookup near a known position, gallops from `hint`.
+     */
+    std::size_t LowerBound(const T value, const std::size_t hint) const noexcept
+    {
+        return Exponential_Lower_Bound(m_data, value, hint);
+    }
+
+    ESearchStrategy Strategy() const noexcept { return m_strategy; }
+
+    /* Mean interpolation steps per sampled lookup, 0 when the array was not sampled */
+    double InterpolationSteps() const noexcept { return m_interpolationSteps; }
+
+private:
+    std::span<const T> m_data;
+    ESearchStrategy m_strategy = ESearchStrategy::Binary;
+    double m_interpolationSteps = 0.0;
+};
@@ -0,0 +1,285 @@
+#pragma once
+
+/*
+ * learned_index.h is a PGM style learned index over a sorted integer array.
+ *
+ * Instead of comparing its way down a tree, the index models the key -> position function of the
+ * data with piecewise linear segments and only searches the few keys around the prediction:
+ *
+ *  - level 0 covers the data: every segment predicts the position of a key to within Epsilon
+ *  - every further level covers the first keys of the level below with EpsilonInternal, until a
+ *    level is small enough (kLearnedRootSegments) to be searched directly; up to hundreds of
+ *    millions of keys that is two levels plus the root
+ *
+ * Segments are fitted in one streaming pass with the greedy shrinking cone: a segment is extended
+ * while some slope keeps every point within +-epsilon, the slope interval narrows with every point.
+ * This is simpler than the optimal convex hull fit of the PGM-index and gives somewhat more
+ * segments for the same error bound.
+ *
+ * Duplicates and absent keys are handled by also fitting (k + 1, first position after k) for keys
+ * that repeat, so the prediction brackets the lower bound of every query, not only of stored keys.
+ * The index keeps a pointer to the data and does not copy it.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "searching/binary_search.h"
+
+/*
+ * A level with at most this many segments is the root and is searched with a plain lower bound
+ */
+constexpr std::size_t kLearnedRootSegments = 32;
+
+namespace detail
+{
+    struct SegmentModel
+    {
+        std::size_t firstPosition;
+        double slope;
+    };
+
+    /*
+     * Segments of one level. The first keys are kept apart so the window searches read only keys;
+     * the model of a segment and the first position of the next one usually share a cache line.
+     */
+    template<class K>
+    struct LearnedLevel
+    {
+        std::vector<K> firstKeys;
+        std::vector<SegmentModel> models; /* one more than firstKeys: the last entry only ends the level */
+
+        std::size_t Count() const noexcept { return firstKeys.size(); }
+
+        std::size_t MemoryBytes() const noexcept
+        {
+            return firstKeys.size() * sizeof(K) + models.size() * sizeof(SegmentModel);
+        }
+
+        /* Position predicted by `segment` for `key`, clamped to the positions the segment covers */
+        std::size_t Predict(const std::size_t segment, const K key) const noexcept
+        {
+            const SegmentModel& model = models[segment];
+            if(key <= firstKeys[segment])
+            {
+                return model.firstPosition;
+            }
+            using U = std::make_unsigned_t<K>;
+            const double offset = model.slope * static_cast<double>(static_cast<U>(key) - static_cast<U>(firstKeys[segment]));
+            /* clamped before the cast: a key far into a gap can predict past 2^64 */
+            const std::size_t span = models[segment + 1].firstPosition - model.firstPosition;
+            if(!(offset < static_cast<double>(span)))
+            {
+                return model.firstPosition + span;
+            }
+            return model.firstPosition + (offset > 0.0 ? static_cast<std::size_t>(offset) : 0);
+        }
+    };
+
+    /*
+     * Prefetch every cache line of a window before it is binary searched, so its misses overlap
+     * instead of costing one round trip per halving step
+     */
+    template<class T>
+    inline void Prefetch_Window(const T* first, const T* last) noexcept
+    {
+        const char* const end = reinterpret_cast<const char*>(last);
+        for(const char* line = reinterpret_cast<const char*>(first); line < end; line += 64)
+        {
+            __builtin_prefetch(line);
+        }
+    }
+
+    /**
+     * @brief Streaming greedy fit of epsilon bounded segments.
+     *
+     * Points must arrive with strictly increasing keys and non decreasing positions.
+     */
+    template<class K>
+    class SegmentFitter
+    {
+    public:
+        SegmentFitter(const double epsilon, LearnedLevel<K>& level)
+            : m_epsilon(epsilon)
+            , m_level(level)
+        {
+        }
+
+        /* closes the last segment; `endPosition` is one past the last position the level predicts */
+        void Finish(const std::size_t endPosition)
+        {
+            if(m_bOpen)
+            {
+                Close();
+                m_bOpen = false;
+            }
+            m_level.models.push_back({endPosition, 0.0});
+        }
+
+        void Add(const K key, const std::size_t position)
+        {
+            if(m_bOpen)
+            {
+                using U = std::make_unsigned_t<K>;
+                const double dx = static_cast<double>(static_cast<U>(key) - static_cast<U>(m_firstKey));
+                const double dy = static_cast<double>(position - m_firstPosition);
+                if(dy <= m_slopeHigh * dx + m_epsilon && dy >= m_slopeLow * dx - m_epsilon)
+                {
+                    m_slopeHigh = std::min(m_slopeHigh, (dy + m_epsilon) / dx);
+                    m_slopeLow = std::max(m_slopeLow, (dy - m_epsilon) / dx);
+                    return;
+                }
+                Close();
+            }
+            m_bOpen = true;
+            m_firstKey = key;
+            m_firstPosition = position;
+            m_slopeLow = 0.0;
+            m_slopeHigh = std::numeric_limits<double>::infinity();
+        }
+
+    private:
+        void Close()
+        {
+            m_level.firstKeys.push_back(m_firstKey);
+            /* a single point segment keeps slope 0; otherwise the middle of the feasible interval */
+            m_level.models.push_back({m_firstPosition, std::isinf(m_slopeHigh) ? m_slopeLow : (m_slopeLow + m_slopeHigh) / 2});
+        }
+
+        double m_epsilon;
+        LearnedLevel<K>& m_level;
+        bool m_bOpen = false;
+        K m_firstKey{};
+        std::size_t m_firstPosition = 0;
+        double m_slopeLow = 0.0;
+        double m_slopeHigh = 0.0;
+    };
+} /* namespace detail */
+
+/**
+ * @brief Learned lower bound index over sorted integer keys.
+ *
+ * @tparam K: integer key type
+ * @tparam Epsilon: maximum prediction error of the data level, in positions
+ * @tparam EpsilonInternal: maximum prediction error of the levels above it
+ *
+ * The data must stay alive and unchanged while the index is used.
+ *
+ * Example usage:
+ * @code
+ * LearnedIndex<std::int64_t> index(std::span<const std::int64_t>(timestamps));
+ * std::size_t position = index.LowerBound(from); // same as std::lower_bound(...) - begin
+ * @endcode
+ */
+template<std::integral K, std::size_t Epsilon = 64, std::size_t EpsilonInternal = 8>
+class LearnedIndex
+{
+public:
+    explicit LearnedIndex(std::span<const K> sorted)
+        : m_data(sorted)
+    {
+        m_levels.emplace_back();
+        detail::LearnedLevel<K>& dataLevel = m_levels.back();
+        detail::SegmentFitter<K> fitter(static_cast<double>(Epsilon), dataLevel);
+        for(std::size_t first = 0; first < sorted.size();)
+        {
+            const K key = sorted[first];
+            std::size_t end = first + 1;
+            while(end < sorted.size() && sorted[end] == key)
+            {
+                ++end;
+            }
+            fitter.Add(key, first);
+            /* a run of duplicates is a jump: pin the lower bound of the keys right after it */
+            if(end - first > 1 && end < sorted.size() && key < std::numeric_limits<K>::max() && key + 1 < sorted[end])
+            {
+                fitter.Add(static_cast<K>(key + 1), end);
+            }
+            first = end;
+        }
+        fitter.Finish(sorted.size());
+
+        while(m_levels.back().Count() > kLearnedRootSegments)
+        {
+            detail::LearnedLevel<K> upper;
+            const detail::LearnedLevel<K>& lower = m_levels.back();
+            detail::SegmentFitter<K> upperFitter(static_cast<double>(EpsilonInternal), upper);
+            for(std::size_t segment = 0; segment < lower.Count(); ++segment)
+            {
+                upperFitter.Add(lower.firstKeys[segment], segment);
+            }
+            upperFitter.Finish(lower.Count());
+            m_levels.push_back(std::move(upper));
+        }
+    }
+
+    /**
+     * @brief Position of the first key that is not less than `key`.
+     *
+     * @return std::size_t: index into the data, Size() when every key is less than `key`
+     */
+    std::size_t LowerBound(const K key) const noexcept
+    {
+        if(m_data.empty())
+        {
+            return 0;
+        }
+        const detail::LearnedLevel<K>& root = m_levels.back();
+        std::size_t segment = Segment_Of(root.firstKeys, 0, root.Count(), key);
+        for(std::size_t level = m_levels.size() - 1; level > 0; --level)
+        {
+            const std::size_t predicted = m_levels[level].Predict(segment, key);
+            const detail::LearnedLevel<K>& lower = m_levels[level - 1];
+            const std::size_t begin = predicted > EpsilonInternal + 2 ? predicted - EpsilonInternal - 2 : 0;
+            const std::size_t end = std::min(predicted + EpsilonInternal + 3, lower.Count());
+            segment = Segment_Of(lower.firstKeys, begin, end, key);
+        }
+        const std::size_t predicted = m_levels[0].Predict(segment, key);
+        const std::size_t begin = predicted > Epsilon + 2 ? predicted - Epsilon - 2 : 0;
+        const std::size_t end = std::min(predicted + Epsilon + 3, m_data.size());
+        detail::Prefetch_Window(m_data.data() + begin, m_data.data() + end);
+        return static_cast<std::size_t>(Lower_Bound<false>(m_data.begin() + static_cast<std::ptrdiff_t>(begin),
+                                                           m_data.begin() + static_cast<std::ptrdiff_t>(end), key) - m_data.begin());
+    }
+
+    bool Contains(const K key) const noexcept
+    {
+        const std::size_t position = LowerBound(key);
+        return position < m_data.size() && m_data[position] == key;
+    }
+
+    std::size_t Size() const noexcept { return m_data.size(); }
+    std::size_t Levels() const noexcept { return m_levels.size(); }
+    std::size_t Segments() const noexcept { return m_levels.front().Count(); }
+
+    /* Bytes of the model alone, the data it indexes is not counted */
+    std::size_t MemoryBytes() const noexcept
+    {
+        std::size_t bytes = 0;
+        for(const detail::LearnedLevel<K>& level : m_levels)
+        {
+            bytes += level.MemoryBytes();
+        }
+        return bytes;
+    }
+
+private:
+    /* Last segment in [begin, end) whose first key is <= key, or begin when there is none */
+    static std::size_t Segment_Of(const std::vector<K>& firstKeys, const std::size_t begin, const std::size_t end, const K key) noexcept
+    {
+        detail::Prefetch_Window(firstKeys.data() + begin, firstKeys.data() + end);
+        const auto upper = Upper_Bound<false>(firstKeys.begin() + static_cast<std::ptrdiff_t>(begin),
+                                              firstKeys.begin() + static_cast<std::ptrdiff_t>(end), key);
+        const std::size_t position = static_cast<std::size_t>(upper - firstKeys.begin());
+        return position > begin ? position - 1 : begin;
+    }
+
+    std::span<const K> m_data;
+    std::vector<detail::LearnedLevel<K>> m_levels; /* [0] models the data, back() is the root */
+};
@@ -0,0 +1,571 @@
+#pragma once
+
+/*
+ * linear_search.h vectorizes the element by element scan of C Program/Linear_Search.c.
+ *
+ *  - Find_First / Count_Equal / Count_Less / Min_Index over int32, int64 and float use AVX2 or
+ *    AVX-512 compares (8 / 16 lanes at a time for 32 bit, 4 / 8 for 64 bit) chosen at run time,
+ *    every other arithmetic type and CPUs without the extensions use the scalar loop.
+ *  - Hybrid_Lower_Bound halves a sorted range branchlessly until it is a few cache lines long and
+ *    then counts the keys below the query with one unrolled vector pass, replacing the last
+ *    dependent probes of the binary search with independent loads.
+ *
+ * Float compares are ordered: NaNs never compare equal or less and are skipped by Min_Index.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "common/cpu_features.h"
+
+#if ALGORITHMS_X86
+#include <immintrin.h>
+#endif /* ALGORITHMS_X86 */
+
+/*
+ * Keys Hybrid_Lower_Bound scans after it stops halving, measured with bench_linear_search
+ */
+constexpr std::size_t kHybridLinearWindow = 32;
+
+namespace detail
+{
+    /*
+     * Predicate a counting kernel tests every element against the query with
+     */
+    enum class ELaneCompare : int
+    {
+        Equal,
+        Less,
+        AutoCount /* Should be last! Number of compares */
+    };
+
+    template<ELaneCompare Compare, class T>
+    bool Lane_Compare(const T element, const T value) noexcept
+    {
+        if constexpr(Compare == ELaneCompare::Equal)
+        {
+            return element == value;
+        }
+        else
+        {
+            return element < value;
+        }
+    }
+
+    template<class T>
+    std::size_t Find_First_Scalar(const T* data, const std::size_t count, const T value) noexcept
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            if(data[i] == value)
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    template<ELaneCompare Compare, class T>
+    std::size_t Count_Scalar(const T* data, const std::size_t count, const T value) noexcept
+    {
+        std::size_t matches = 0;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            matches += Lane_Compare<Compare>(data[i], value) ? 1 : 0;
+        }
+        return matches;
+    }
+
+    /* Smallest non NaN element; the identity (max / +inf) when there is none */
+    template<class T>
+    T Block_Min_Scalar(const T* data, const std::size_t count) noexcept
+    {
+        T minimum = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            minimum = data[i] < minimum ? data[i] : minimum;
+        }
+        return minimum;
+    }
+
+#if ALGORITHMS_X86
+    /*
+     * Per type AVX2 operations, masks have bit i set for lane i
+     */
+    template<class T>
+    struct Avx2Lanes;
+
+    template<>
+    struct Avx2Lanes<std::int32_t>
+    {
+        using Vector = __m256i;
+        static constexpr std::size_t kLanes = 8;
+
+        __attribute__((target("avx2"))) static Vector Load(const std::int32_t* data) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+        __attribute__((target("avx2"))) static Vector Splat(const std::int32_t value) noexcept { return _mm256_set1_epi32(value); }
+        __attribute__((target("avx2"))) static unsigned Equal(const Vector left, const Vector right) noexcept
+        {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(left, right))));
+        }
+        __attribute__((target("avx2"))) static unsigned Less(const Vector left, const Vector right) noexcept
+        {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(right, left))));
+        }
+        __attribute__((target("avx2"))) static Vector Min(const Vector left, const Vector right) noexcept { return _mm256_min_epi32(left, right); }
+    };
+
+    template<>
+    struct Avx2Lanes<std::int64_t>
+    {
+        using Vector = __m256i;
+        static constexpr std::size_t kLanes = 4;
+
+        __attribute__((target("avx2"))) static Vector Load(const std::int64_t* data) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+        __attribute__((target("avx2"))) static Vector Splat(const std::int64_t value) noexcept { return _mm256_set1_epi64x(value); }
+        __attribute__((target("avx2"))) static unsigned Equal(const Vector left, const Vector right) noexcept
+        {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(left, right))));
+        }
+        __attribute__((target("avx2"))) static unsigned Less(const Vector left, const Vector right) noexcept
+        {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(right, left))));
+        }
+        /* AVX2 has no 64 bit min, select through the compare */
+        __attribute__((target("avx2"))) static Vector Min(const Vector left, const Vector right) noexcept
+        {
+            return _mm256_blendv_epi8(left, right, _mm256_cmpgt_epi64(left, right));
+        }
+    };
+
+    template<>
+    struct Avx2Lanes<float>
+    {
+        using Vector = __m256;
+        static constexpr std::size_t kLanes = 8;
+
+        __attribute__((target("avx2"))) static Vector Load(const float* data) noexcept { return _mm256_loadu_ps(data); }
+        __attribute__((target("avx2"))) static Vector Splat(const float value) noexcept { return _mm256_set1_ps(value); }
+        __attribute__((target("avx2"))) static unsigned Equal(const Vector left, const Vector right) noexcept
+        {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_EQ_OQ)));
+        }
+        __attribute__((target("avx2"))) static unsigned Less(const Vector left, const Vector right) noexcept
+        {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(left, right, _CMP_LT_OQ)));
+        }
+        /* min_ps returns the second operand when the first is NaN, so NaN elements are skipped */
+        __attribute__((target("avx2"))) static Vector Min(const Vector element, const Vector minimum) noexcept { return _mm256_min_ps(element, minimum); }
+    };
+
+    template<class T>
+    struct Avx512Lanes;
+
+    template<>
+    struct Avx512Lanes<std::int32_t>
+    {
+        using Vector = __m512i;
+        static constexpr std::size_t kLanes = 16;
+
+        __attribute__((target("avx512f"))) static Vector Load(const std::int32_t* data) noexcept { return _mm512_loadu_si512(data); }
+        __attribute__((target("avx512f"))) static Vector Splat(const std::int32_t value) noexcept { return _mm512_set1_epi32(value); }
+        __attribute__((target("avx512f"))) static unsigned Equal(const Vector left, const Vector right) noexcept { return _mm512_cmpeq_epi32_mask(left, right); }
+        __attribute__((target("avx512f"))) static unsigned Less(const Vector left, const Vector right) noexcept { return _mm512_cmplt_epi32_mask(left, right); }
+        __attribute__((target("avx512f"))) static Vector Min(const Vector left, const Vector right) noexcept 
+        {
+            /* the masked form, the plain one trips -Wmaybe-uninitialized inside GCC 12's own header */
+            return _mm512_mask_min_epi32(left, 0xFFFF, left, right);
+        }
+    };
+
+    template<>
+    struct Avx512Lanes<std::int64_t>
+    {
+        using Vector = __m512i;
+        static constexpr std::size_t kLanes = 8;
+
+        __attribute__((target("avx512f"))) static Vector Load(const std::int64_t* data) noexcept { return _mm512_loadu_si512(data); }
+        __attribute__((target("avx512f"))) static Vector Splat(const std::int64_t value) noexcept { return _mm512_set1_epi64(value); }
+        __attribute__((target("avx512f"))) static unsigned Equal(const Vector left, const Vector right) noexcept { return _mm512_cmpeq_epi64_mask(left, right); }
+        __attribute__((target("avx512f"))) static unsigned Less(const Vector left, const Vector right) noexcept { return _mm512_cmplt_epi64_mask(left, right); }
+        __attribute__((target("avx512f"))) static Vector Min(const Vector left, const Vector right) noexcept { return _mm512_mask_min_epi64(left, 0xFF, left, right); }
+    };
+
+    template<>
+    struct Avx512Lanes<float>
+    {
+        using Vector = __m512;
+        static constexpr std::size_t kLanes = 16;
+
+        __attribute__((target("avx512f"))) static Vector Load(const float* data) noexcept { return _mm512_loadu_ps(data); }
+        __attribute__((target("avx512f"))) static Vector Splat(const float value) noexcept { return _mm512_set1_ps(value); }
+        __attribute__((target("avx512f"))) static unsigned Equal(const Vector left, const Vector right) noexcept { return _mm512_cmp_ps_mask(left, right, _CMP_EQ_OQ); }
+        __attribute__((target("avx512f"))) static unsigned Less(const Vector left, const Vector right) noexcept { return _mm512_cmp_ps_mask(left, right, _CMP_LT_OQ); }
+        __attribute__((target("avx512f"))) static Vector Min(const Vector element, const Vector minimum) noexcept { return _mm512_mask_min_ps(element, 0xFFFF, element, minimum); }
+    };
+
+    /* Four vectors per step, the lanes are only inspected once a step has a match */
+    template<class T>
+    __attribute__((target("avx2,bmi,popcnt")))
+    std::size_t Find_First_Avx2(const T* data, const std::size_t count, const T value) noexcept
+    {
+        using Lanes = Avx2Lanes<T>;
+        constexpr std::size_t kStep = 4 * Lanes::kLanes;
+        const typename Lanes::Vector splat = Lanes::Splat(value);
+        std::size_t i = 0;
+        for(; i + kStep <= count; i += kStep)
+        {
+            const std::uint64_t mask = std::uint64_t{Lanes::Equal(Lanes::Load(data + i), splat)} |
+                                       std::uint64_t{Lanes::Equal(Lanes::Load(data + i + Lanes::kLanes), splat)} << Lanes::kLanes |
+                                       std::uint64_t{Lanes::Equal(Lanes::Load(data + i + 2 * Lanes::kLanes), splat)} << 2 * Lanes::kLanes |
+                                       std::uint64_t{Lanes::Equal(Lanes::Load(data + i + 3 * Lanes::kLanes), splat)} << 3 * Lanes::kLanes;
+            if(mask != 0)
+            {
+                return i + static_cast<std::size_t>(std::countr_zero(mask));
+            }
+        }
+        return i + Find_First_Scalar(data + i, count - i, value);
+    }
+
+    template<ELaneCompare Compare, class T>
+    __attribute__((target("avx2,popcnt")))
+    std::size_t Count_Avx2(const T* data, const std::size_t count, const T value) noexcept
+    {
+        using Lanes = Avx2Lanes<T>;
+        const typename Lanes::Vector splat = Lanes::Splat(value);
+        std::size_t matches = 0;
+        std::size_t i = 0;
+        for(; i + Lanes::kLanes <= count; i += Lanes::kLanes)
+        {
+            const typename Lanes::Vector vector = Lanes::Load(data + i);
+            const unsigned mask = Compare == ELaneCompare::Equal ? Lanes::Equal(vector, splat) : Lanes::Less(vector, splat);
+            matches += static_cast<std::size_t>(std::popcount(mask));
+        }
+        return matches + Count_Scalar<Compare>(data + i, count - i, value);
+    }
+
+    template<class T>
+    __attribute__((target("avx2")))
+    T Block_Min_Avx2(const T* data, const std::size_t count) noexcept
+    {
+        using Lanes = Avx2Lanes<T>;
+        const T identity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        typename Lanes::Vector minimum = Lanes::Splat(identity);
+        std::size_t i = 0;
+        for(; i + Lanes::kLanes <= count; i += Lanes::kLanes)
+        {
+            minimum = Lanes::Min(Lanes::Load(data + i), minimum);
+        }
+        alignas(32) T lanes[Lanes::kLanes];
+        std::memcpy(lanes, &minimum, sizeof(lanes));
+        return std::min(Block_Min_Scalar(lanes, Lanes::kLanes), Block_Min_Scalar(data + i, count - i));
+    }
+
+    template<class T>
+    __attribute__((target("avx512f,bmi,popcnt")))
+    std::size_t Find_First_Avx512(const T* data, const std::size_t count, const T value) noexcept
+    {
+        using Lanes = Avx512Lanes<T>;
+        constexpr std::size_t kStep = 2 * Lanes::kLanes;
+        const typename Lanes::Vector splat = Lanes::Splat(value);
+        std::size_t i = 0;
+        for(; i + kStep <= count; i += kStep)
+        {
+            const std::uint64_t mask = std::uint64_t{Lanes::Equal(Lanes::Load(data + i), splat)} |
+                                       std::uint64_t{Lanes::Equal(Lanes::Load(data + i + Lanes::kLanes), splat)} << Lanes::kLanes;
+            if(mask != 0)
+            {
+                return i + static_cast<std::size_t>(std::countr_zero(mask));
+            }
+        }
+        return i + Find_First_Scalar(data + i, count - i, value);
+    }
+
+    template<ELaneCompare Compare, class T>
+    __attribute__((target("avx512f,popcnt")))
+    std::size_t Count_Avx512(const T* data, const std::size_t count, const T value) noexcept
+    {
+        using Lanes = Avx512Lanes<T>;
+        const typename Lanes::Vector splat = Lanes::Splat(value);
+        std::size_t matches = 0;
+        std::size_t i = 0;
+        for(; i + Lanes::kLanes <= count; i += Lanes::kLanes)
+        {
+            const typename Lanes::Vector vector = Lanes::Load(data + i);
+            const unsigned mask = Compare == ELaneCompare::Equal ? Lanes::Equal(vector, splat) : Lanes::Less(vector, splat);
+            matches += static_cast<std::size_t>(std::popcount(mask));
+        }
+        return matches + Count_Scalar<Compare>(data + i, count - i, value);
+    }
+
+    template<class T>
+    __attribute__((target("avx512f")))
+    T Block_Min_Avx512(const T* data, const std::size_t count) noexcept
+    {
+        using Lanes = Avx512Lanes<T>;
+        const T identity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        typename Lanes::Vector minimum = Lanes::Splat(identity);
+        std::size_t i = 0;
+        for(; i + Lanes::kLanes <= count; i += Lanes::kLanes)
+        {
+            minimum = Lanes::Min(Lanes::Load(data + i), minimum);
+        }
+        alignas(64) T lanes[Lanes::kLanes];
+        std::memcpy(lanes, &minimum, sizeof(lanes));
+        return std::min(Block_Min_Scalar(lanes, Lanes::kLanes), Block_Min_Scalar(data + i, count - i));
+    }
+#endif /* ALGORITHMS_X86 */
+
+    /*
+     * Hybrid lower bound: branchless halving down to Window keys, then one scan of exactly Window
+     * keys starting at min(base, size - Window). Arrays of at most Window keys are scanned whole.
+     */
+    template<class T>
+    std::size_t Halve_To_Window(const T* data, std::size_t size, const T value, const std::size_t window) noexcept
+    {
+        std::size_t base = 0;
+        std::size_t length = size;
+        /* the lower bound stays inside [base, base + length] */
+        while(length > window)
+        {
+            const std::size_t half = length / 2;
+            base += half * static_cast<std::size_t>(data[base + half - 1] < value);
+            length -= half;
+        }
+        return std::min(base, size - window);
+    }
+
+    template<std::size_t Window, class T>
+    std::size_t Hybrid_Lower_Bound_Scalar(const T* data, const std::size_t size, const T value) noexcept
+    {
+        if(size <= Window)
+        {
+            return Count_Scalar<ELaneCompare::Less>(data, size, value);
+        }
+        const std::size_t start = Halve_To_Window(data, size, value, Window);
+        return start + Count_Scalar<ELaneCompare::Less>(data + start, Window, value);
+    }
+
+#if ALGORITHMS_X86
+    template<std::size_t Window, class T>
+    __attribute__((target("avx2,popcnt")))
+    std::size_t Hybrid_Lower_Bound_Avx2(const T* data, const std::size_t size, const T value) noexcept
+    {
+        using Lanes = Avx2Lanes<T>;
+        if(size <= Window)
+        {
+            return Count_Avx2<ELaneCompare::Less>(data, size, value);
+        }
+        const std::size_t start = Halve_To_Window(data, size, value, Window);
+        const typename Lanes::Vector splat = Lanes::Splat(value);
+        unsigned less = 0;
+#pragma GCC unroll 16
+        for(std::size_t i = 0; i < Window; i += Lanes::kLanes)
+        {
+            less += static_cast<unsigned>(std::popcount(Lanes::Less(Lanes::Load(data + start + i), splat)));
+        }
+        return start + less;
+    }
+
+    template<std::size_t Window, class T>
+    __attribute__((target("avx512f,popcnt")))
+    std::size_t Hybrid_Lower_Bound_Avx512(const T* data, const std::size_t size, const T value) noexcept
+    {
+        using Lanes = Avx512Lanes<T>;
+        if(size <= Window)
+        {
+            return Count_Avx512<ELaneCompare::Less>(data, size, value);
+        }
+        const std::size_t start = Halve_To_Window(data, size, value, Window);
+        const typename Lanes::Vector splat = Lanes::Splat(value);
+        unsigned less = 0;
+#pragma GCC unroll 16
+        for(std::size_t i = 0; i < Window; i += Lanes::kLanes)
+        {
+            less += static_cast<unsigned>(std::popcount(Lanes::Less(Lanes::Load(data + start + i), splat)));
+        }
+        return start + less;
+    }
+#endif /* ALGORITHMS_X86 */
+
+    template<class T>
+    constexpr bool kVectorScanType = std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t> || std::is_same_v<T, float>;
+
+    template<class T>
+    std::size_t Find_First(const T* data, const std::size_t count, const T value, const ESimdLevel level) noexcept
+    {
+#if ALGORITHMS_X86
+        if constexpr(kVectorScanType<T>)
+        {
+            if(level == ESimdLevel::Avx512)
+            {
+                return Find_First_Avx512(data, count, value);
+            }
+            if(level == ESimdLevel::Avx2)
+            {
+                return Find_First_Avx2(data, count, value);
+            }
+        }
+#endif /* ALGORITHMS_X86 */
+        (void)level;
+        return Find_First_Scalar(data, count, value);
+    }
+
+    template<ELaneCompare Compare, class T>
+    std::size_t Count(const T* data, const std::size_t count, const T value, const ESimdLevel level) noexcept
+    {
+#if ALGORITHMS_X86
+        if constexpr(kVectorScanType<T>)
+        {
+            if(level == ESimdLevel::Avx512)
+            {
+                return Count_Avx512<Compare>(data, count, value);
+            }
+            if(level == ESimdLevel::Avx2)
+            {
+                return Count_Avx2<Compare>(data, count, value);
+            }
+        }
+#endif /* ALGORITHMS_X86 */
+        (void)level;
+        return Count_Scalar<Compare>(data, count, value);
+    }
+
+    template<class T>
+    T Block_Min(const T* data, const std::size_t count, const ESimdLevel level) noexcept
+    {
+#if ALGORITHMS_X86
+        if constexpr(kVectorScanType<T>)
+        {
+            if(level == ESimdLevel::Avx512)
+            {
+                return Block_Min_Avx512(data, count);
+            }
+            if(level == ESimdLevel::Avx2)
+            {
+                return Block_Min_Avx2(data, count);
+            }
+        }
+#endif /* ALGORITHMS_X86 */
+        (void)level;
+        return Block_Min_Scalar(data, count);
+    }
+} /* namespace detail */
+
+/**
+ * @brief Index of the first element equal to `value`.
+ *
+ * @param data: elements to scan, any order
+ * @param value: element to look for
+ * @param level: instruction set to use, the default is the best one the CPU supports
+ *
+ * Example usage:
+ * @code
+ * std::size_t index = Find_First(std::span<const std::int32_t>(arr), 10);
+ * bool bPresent = index != arr.size();
+ * @endcode
+ *
+ * @return std::size_t: position of the first match, data.size() when there is none
+ */
+template<class T>
+std::size_t Find_First(std::span<const T> data, const T value, const ESimdLevel level = Detect_Simd_Level()) noexcept
+{
+    return detail::Find_First(data.data(), data.size(), value, level);
+}
+
+/**
+ * @brief Number of elements equal to `value`.
+ */
+template<class T>
+std::size_t Count_Equal(std::span<const T> data, const T value, const ESimdLevel level = Detect_Simd_Level()) noexcept
+{
+    return detail::Count<detail::ELaneCompare::Equal>(data.data(), data.size(), value, level);
+}
+
+/**
+ * @brief Number of elements less than `value`; on sorted data this is the lower bound position.
+ */
+template<class T>
+std::size_t Count_Less(std::span<const T> data, const T value, const ESimdLevel level = Detect_Simd_Level()) noexcept
+{
+    return detail::Count<detail::ELaneCompare::Less>(data.data(), data.size(), value, level);
+}
+
+/**
+ * @brief Index of the first smallest element.
+ *
+ * The data is reduced in L1 sized blocks with vector minimums, only the block holding the
+ * minimum is scanned a second time to find its position.
+ *
+ * @return std::size_t: position of the minimum, data.size() when data is empty (or only NaNs)
+ */
+template<class T>
+std::size_t Min_Index(std::span<const T> data, const ESimdLevel level = Detect_Simd_Level()) noexcept
+{
+    constexpr std::size_t kBlock = 4096 / sizeof(T);
+    const T identity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    T best = identity;
+    std::size_t bestBlock = data.size();
+    for(std::size_t block = 0; block < data.size(); block += kBlock)
+    {
+        const T blockMin = detail::Block_Min(data.data() + block, std::min(kBlock, data.size() - block), level);
+        if(blockMin < best)
+        {
+            best = blockMin;
+            bestBlock = block;
+        }
+    }
+    if(bestBlock == data.size())
+    {
+        /* nothing below the identity: the minimum is the first max / +inf element, if any */
+        return detail::Find_First(data.data(), data.size(), identity, level);
+    }
+    return bestBlock + detail::Find_First(data.data() + bestBlock, std::min(kBlock, data.size() - bestBlock), best, level);
+}
+
+/**
+ * @brief std::lower_bound that finishes with one fixed size vector scan instead of halving.
+ *
+ * The range is halved branchlessly until at most `Window` keys remain. The window is then
+ * widened to exactly `Window` keys (sliding it left at the end of the array); every key in front of
+ * the lower bound is less than `value` and every key after it is not, so the lower bound is the
+ * window start plus the number of window keys below `value`. With a compile time window the scan
+ * is fully unrolled and has no tail.
+ *
+ * @tparam Window: keys scanned at the end, a multiple of 16
+ * @param sorted: keys in ascending order
+ * @param value: key to look for
+ * @param level: instruction set of the scan
+ *
+ * Example usage:
+ * @code
+ * std::size_t position = Hybrid_Lower_Bound(std::span<const std::int32_t>(bucket), key);
+ * @endcode
+ *
+ * @return std::size_t: position of the first key not less than `value`
+ */
+template<std::size_t Window = kHybridLinearWindow, class T>
+std::size_t Hybrid_Lower_Bound(std::span<const T> sorted, const T value, const ESimdLevel level = Detect_Simd_Level()) noexcept
+{
+    static_assert(Window > 0 && Window % 16 == 0, "the window must be whole vectors at every SIMD level");
+#if ALGORITHMS_X86
+    if constexpr(detail::kVectorScanType<T>)
+    {
+        if(level == ESimdLevel::Avx512)
+        {
+            return detail::Hybrid_Lower_Bound_Avx512<Window>(sorted.data(), sorted.size(), value);
+        }
+        if(level == ESimdLevel::Avx2)
+        {
+            return detail::Hybrid_Lower_Bound_Avx2<Window>(sorted.data(), sorted.size(), value);
+        }
+    }
+#endif /* ALGORITHMS_X86 */
+    (void)level;
+    return detail::Hybrid_Lower_Bound_Scalar<Window>(sorted.data(), sorted.size(), value);
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+/*
+ * classic_sorts.h gathers the standalone sort programs of this repository behind one interface
+ * so they can be linked into a single binary and compared:
+ *
+ *  bubble_sort.cpp       -> Bubble_Sort
+ *  InsertionSort.c       -> Insertion_Sort
+ *  quick-sort.cpp        -> Quick_Sort_Lomuto   (last element pivot)
+ *  C Program/Quicksort.c -> Quick_Sort_Hoare    (first element pivot, two scanning indices)
+ *  mergesort.cpp         -> Merge_Sort
+ *  heap.cpp              -> Heap_Sort
+ *
+ * The algorithms are kept as written, with three fixes that are required to run them on large inputs:
+ *  - Merge_Sort allocates one scratch buffer up front instead of two VLAs per merge (stack overflow).
+ *  - Both quick sorts recurse into the smaller side and loop on the larger one. Their time complexity
+ *    is unchanged (still quadratic on presorted input) but the stack depth is bounded by log2(n).
+ *  - Insertion_Sort stops at n - 1 instead of reading one element past the end.
+ *
+ * Every sort is templated on a probe that counts comparisons, swaps and moves. NoSortProbe compiles
+ * to nothing, so the timed runs measure the plain algorithm.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Operation counts reported by a counting sort run.
+ */
+struct SortStats
+{
+    std::uint64_t comparisons = 0;
+    std::uint64_t swaps = 0;
+    std::uint64_t moves = 0; /* single element writes that are not part of a swap (shifts, merges) */
+};
+
+/**
+ * @brief Probe that performs the operations without counting anything.
+ */
+struct NoSortProbe
+{
+    template<class T>
+    static bool Less(const T& left, const T& right) noexcept
+    {
+        return left < right;
+    }
+
+    template<class T>
+    static void Swap(T& left, T& right) noexcept
+    {
+        std::swap(left, right);
+    }
+
+    template<class T>
+    static void Move(T& target, const T& source) noexcept
+    {
+        target = source;
+    }
+};
+
+/**
+ * @brief Probe that counts every comparison, swap and move into a SortStats.
+ */
+struct CountingSortProbe
+{
+    SortStats* stats;
+
+    template<class T>
+    bool Less(const T& left, const T& right) const noexcept
+    {
+        ++stats->comparisons;
+        return left < right;
+    }
+
+    template<class T>
+    void Swap(T& left, T& right) const noexcept
+    {
+        ++stats->swaps;
+        std::swap(left, right);
+    }
+
+    template<class T>
+    void Move(T& target, const T& source) const noexcept
+    {
+        ++stats->moves;
+        target = source;
+    }
+};
+
+/**
+ * @brief bubble_sort.cpp: n - 1 passes, each bubbling the largest remaining element to the end.
+ */
+template<class T, class Probe = NoSortProbe>
+void Bubble_Sort(std::span<T> data, Probe probe = {})
+{
+    const std::size_t size = data.size();
+    for(std::size_t i = 0; i + 1 < size; ++i)
+    {
+        for(std::size_t j = 0; j + i + 1 < size; ++j)
+        {
+            if(probe.Less(data[j + 1], data[j]))
+            {
+                probe.Swap(data[j], data[j + 1]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief InsertionSort.c: swap each element down until its predecessor is not greater.
+ */
+template<class T, class Probe = NoSortProbe>
+void Insertion_Sort(std::span<T> data, Probe probe = {})
+{
+    for(std::size_t i = 1; i < data.size(); ++i)
+    {
+        for(std::size_t j = i; j > 0 && probe.Less(data[j], data[j - 1]); --j)
+        {
+            probe.Swap(data[j], data[j - 1]);
+        }
+    }
+}
+
+namespace detail
+{
+    /* quick-sort.cpp partition: last element pivot, everything smaller moved to the front */
+    template<class T, class Probe>
+    std::size_t Lomuto_Partition(std::span<T> data, std::size_t low, std::size_t high, Probe& probe)
+    {
+        const T pivot = data[high];
+        std::size_t store = low;
+        for(std::size_t j = low; j < high; ++j)
+        {
+            if(probe.Less(data[j], pivot))
+            {
+                probe.Swap(data[store], data[j]);
+                ++store;
+            }
+        }
+        probe.Swap(data[store], data[high]);
+        return store;
+    }
+
+    /* C Program/Quicksort.c partition: first element pivot, i scans right, j scans left */
+    template<class T, class Probe>
+    std::size_t Hoare_Partition(std::span<T> data, std::size_t first, std::size_t last, Probe& probe)
+    {
+        const std::size_t pivot = first;
+        std::size_t i = first;
+        std::size_t j = last;
+        while(i < j)
+        {
+            while(!probe.Less(data[pivot], data[i]) && i < last)
+            {
+                ++i;
+            }
+            while(probe.Less(data[pivot], data[j]))
+            {
+                --j;
+            }
+            if(i < j)
+            {
+                probe.Swap(data[i], data[j]);
+            }
+        }
+        probe.Swap(data[pivot], data[j]);
+        return j;
+    }
+
+    /* Shared driver: recurse into the smaller side, iterate on the larger one */
+    template<class T, class Probe, class Partition>
+    void Quick_Sort_Range(std::span<T> data, std::size_t low, std::size_t high, Probe& probe, Partition partition)
+    {
+        while(low < high)
+        {
+            const std::size_t pivot = partition(data, low, high, probe);
+            if(pivot - low < high - pivot)
+            {
+                if(pivot > low)
+                {
+                    Quick_Sort_Range(data, low, pivot - 1, probe, partition);
+                }
+                low = pivot + 1;
+            }
+            else
+            {
+                Quick_Sort_Range(data, pivot + 1, high, probe, partition);
+                if(pivot == low)
+                {
+                    return;
+                }
+                high = pivot - 1;
+            }
+        }
+    }
+
+    /* mergesort.cpp merge of data[left..mid] and data[mid+1..right] through the scratch buffer */
+    template<class T, class Probe>
+    void Merge(std::span<T> data, std::span<T> scratch, std::size_t left, std::size_t mid, std::size_t right, Probe& probe)
+    {
+        for(std::size_t k = left; k <= right; ++k)
+        {
+            probe.Move(scratch[k], data[k]);
+        }
+        std::size_t i = left;
+        std::size_t j = mid + 1;
+        std::size_t k = left;
+        while(i <= mid && j <= right)
+        {
+            if(!probe.Less(scratch[j], scratch[i]))
+            {
+                probe.Move(data[k++], scratch[i++]);
+            }
+            else
+            {
+                probe.Move(data[k++], scratch[j++]);
+            }
+        }
+        while(i <= mid)
+        {
+            probe.Move(data[k++], scratch[i++]);
+        }
+        while(j <= right)
+        {
+            probe.Move(data[k++], scratch[j++]);
+        }
+    }
+
+    template<class T, class Probe>
+    void Merge_Sort_Range(std::span<T> data, std::span<T> scratch, std::size_t left, std::size_t right, Probe& probe)
+    {
+        if(left < right)
+        {
+            const std::size_t mid = left + (right - left) / 2;
+            Merge_Sort_Range(data, scratch, left, mid, probe);
+            Merge_Sort_Range(data, scratch, mid + 1, right, probe);
+            Merge(data, scratch, left, mid, right, probe);
+        }
+    }
+
+    /* heap.cpp heapify: sift the root of the subtree at `root` down a max heap of `size` elements */
+    template<class T, class Probe>
+    void Heapify(std::span<T> data, std::size_t size, std::size_t root, Probe& probe)
+    {
+        std::size_t largest = root;
+        const std::size_t left = 2 * root + 1;
+        const std::size_t right = 2 * root + 2;
+        if(left < size && probe.Less(data[largest], data[left]))
+        {
+            largest = left;
+        }
+        if(right < size && probe.Less(data[largest], data[right]))
+        {
+            largest = right;
+        }
+        if(largest != root)
+        {
+            probe.Swap(data[root], data[largest]);
+            Heapify(data, size, largest, probe);
+        }
+    }
+} /* namespace detail */
+
+/**
+ * @brief quick-sort.cpp: quick sort with a Lomuto partition around the last element.
+ */
+template<class T, class Probe = NoSortProbe>
+void Quick_Sort_Lomuto(std::span<T> data, Probe probe = {})
+{
+    if(data.size() > 1)
+    {
+        detail::Quick_Sort_Range(data, 0, data.size() - 1, probe, [](std::span<T> range, std::size_t low, std::size_t high, Probe& partitionProbe)
+        {
+            return detail::Lomuto_Partition(range, low, high, partitionProbe);
+        });
+    }
+}
+
+/**
+ * @brief C Program/Quicksort.c: quick sort around the first element with two scanning indices.
+ */
+template<class T, class Probe = NoSortProbe>
+void Quick_Sort_Hoare(std::span<T> data, Probe probe = {})
+{
+    if(data.size() > 1)
+    {
+        detail::Quick_Sort_Range(data, 0, data.size() - 1, probe, [](std::span<T> range, std::size_t first, std::size_t last, Probe& partitionProbe)
+        {
+            return detail::Hoare_Partition(range, first, last, partitionProbe);
+        });
+    }
+}
+
+/**
+ * @brief mergesort.cpp: top-down merge sort, one scratch buffer for the whole run.
+ */
+template<class T, class Probe = NoSortProbe>
+void Merge_Sort(std::span<T> data, Probe probe = {})
+{
+    if(data.size() > 1)
+    {
+        std::vector<T> scratch(data.size());
+        detail::Merge_Sort_Range(data, std::span<T>(scratch), 0, data.size() - 1, probe);
+    }
+}
+
+/**
+ * @brief heap.cpp: build a max heap, then repeatedly move the root behind the shrinking heap.
+ */
+template<class T, class Probe = NoSortProbe>
+void Heap_Sort(std::span<T> data, Probe probe = {})
+{
+    const std::size_t size = data.size();
+    for(std::size_t i = size / 2; i-- > 0;)
+    {
+        detail::Heapify(data, size, i, probe);
+    }
+    for(std::size_t i = size; i-- > 1;)
+    {
+        probe.Swap(data[0], data[i]);
+        detail::Heapify(data, i, 0, probe);
+    }
+}
+
+/**
+ * @brief Worst case behaviour of a sort, used by harnesses to skip hopeless runs.
+ */
+enum class ESortComplexity : int
+{
+    Linearithmic,           /* n log n on every input */
+    QuadraticOnPresorted,   /* n log n on random input, n^2 on sorted, reversed or few unique keys */
+    Quadratic,              /* n^2 on every input */
+    AutoCount
+};
+
+/**
+ * @brief One entry of the sort registry: a timed variant and a counting variant of the same algorithm.
+ */
+struct SortEntry
+{
+    std::string_view name;
+    std::string_view origin;
+    ESortComplexity complexity;
+    void (*sort)(std::span<int> data);
+    void (*countingSort)(std::span<int> data, SortStats& stats);
+};
+
+/**
+ * @brief Every int sort of the repository behind a common interface.
+ *
+ * Example usage:
+ * @code
+ * for(const SortEntry& entry : Classic_Sorts())
+ * {
+ *     std::vector<int> data = input;
+ *     entry.sort(std::span(data));
+ * }
+ * @endcode
+ */
+inline std::span<const SortEntry> Classic_Sorts() noexcept
+{
+#define CLASSIC_SORT_ENTRY(function, origin, complexity)                                    \
+    SortEntry{#function, origin, complexity,                                                \
+              [](std::span<int> data) { function<int>(data); },                             \
+              [](std::span<int> data, SortStats& stats) { function<int>(data, CountingSortProbe{&stats}); }}
+
+    static const SortEntry entries[] = {
+        CLASSIC_SORT_ENTRY(Bubble_Sort, "bubble_sort.cpp", ESortComplexity::Quadratic),
+        CLASSIC_SORT_ENTRY(Insertion_Sort, "InsertionSort.c", ESortComplexity::Quadratic),
+        CLASSIC_SORT_ENTRY(Quick_Sort_Lomuto, "quick-sort.cpp", ESortComplexity::QuadraticOnPresorted),
+        CLASSIC_SORT_ENTRY(Quick_Sort_Hoare, "C Program/Quicksort.c", ESortComplexity::QuadraticOnPresorted),
+        CLASSIC_SORT_ENTRY(Merge_Sort, "mergesort.cpp", ESortComplexity::Linearithmic),
+        CLASSIC_SORT_ENTRY(Heap_Sort, "heap.cpp", ESortComplexity::Linearithmic),
+    };
+
+#undef CLASSIC_SORT_ENTRY
+    return entries;
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+/*
+ * inversion_count.h counts inversions (pairs i < j with data[i] > data[j]) on large arrays.
+ *
+ * Two strategies are provided:
+ *  - merge based: every thread sorts and counts one chunk, then the chunks are merged
+ *    level by level. Each merge is itself split along merge-path diagonals so all threads
+ *    stay busy until the very last level. Counts are kept per task and reduced at the end.
+ *  - Fenwick based: for integer keys from a small domain (e.g. bucketed telemetry) every
+ *    thread runs a Fenwick tree over its chunk, and the cross-chunk pairs are recovered
+ *    from the per-chunk histograms in O(threads * domain) without touching the data again.
+ *
+ * All counts are std::uint64_t, n * (n - 1) / 2 fits for any n below 6e9.
+ */
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "common/parallel.h"
+
+namespace detail
+{
+    /* Runs shorter than this are insertion sorted before merging starts */
+    inline constexpr std::size_t kInversionInsertionRun = 32;
+
+    /**
+     * @brief Insertion sort [first, last) and return the number of element shifts (= inversions).
+     */
+    template<class T, class Compare>
+    std::uint64_t Insertion_Sort_Count(T* first, T* last, Compare& comp)
+    {
+        std::uint64_t count = 0;
+        for(T* current = first + (first != last); current < last; ++current)
+        {
+            T value = std::move(*current);
+            T* hole = current;
+            while(hole != first && comp(value, *(hole - 1)))
+            {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            }
+            count += static_cast<std::uint64_t>(current - hole);
+            *hole = std::move(value);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Stable merge of a[aBegin, aEnd) and b[bBegin, bEnd) into out.
+     *
+     * Every time an element of b is emitted ahead of the remaining elements of the full
+     * left run, all of them form an inversion with it. `aRunEnd` is the end of the whole
+     * left run, which lets a merge-path segment count pairs it does not itself merge.
+     *
+     * @return std::uint64_t: number of cross inversions discovered by this segment
+     */
+    template<class T, class Compare>
+    std::uint64_t Merge_Count(const T* a, const T* aEnd, const T* aRunEnd,
+                              const T* b, const T* bEnd, T* out, Compare& comp)
+    {
+        std::uint64_t count = 0;
+        while(a != aEnd && b != bEnd)
+        {
+            if(comp(*b, *a))
+            {
+                count += static_cast<std::uint64_t>(aRunEnd - a);
+                *out++ = *b++;
+            }
+            else
+            {
+                *out++ = *a++;
+            }
+        }
+        /* b elements left over still precede the part of the left run owned by later segments */
+        count += static_cast<std::uint64_t>(bEnd - b) * static_cast<std::uint64_t>(aRunEnd - a);
+        out = std::copy(a, aEnd, out);
+        std::copy(b, bEnd, out);
+        return count;
+    }
+
+    /**
+     * @brief Number of elements of `a` among the first `diagonal` outputs of a stable merge of a and b.
+     */
+    template<class T, class Compare>
+    std::size_t Merge_Path_Split(const T* a, std::size_t aSize, const T* b, std::size_t bSize,
+                                 std::size_t diagonal, Compare& comp)
+    {
+        std::size_t low = diagonal > bSize ? diagonal - bSize : 0;
+        std::size_t high = std::min(diagonal, aSize);
+        while(low < high)
+        {
+            const std::size_t mid = low + (high - low) / 2;
+            if(comp(b[diagonal - mid - 1], a[mid]))
+            {
+                high = mid;
+            }
+            else
+            {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * @brief Serial bottom-up merge sort of data[0, size) that returns its inversion count.
+     *
+     * No recursion and a single caller-provided scratch buffer of the same size, so the
+     * stack use is constant regardless of the input length. The sorted result is left in `data`.
+     */
+    template<class T, class Compare>
+    std::uint64_t Sort_Count_Serial(T* data, T* scratch, std::size_t size, Compare& comp)
+    {
+        std::uint64_t count = 0;
+        for(std::size_t begin = 0; begin < size; begin += kInversionInsertionRun)
+        {
+            count += Insertion_Sort_Count(data + begin, data + std::min(size, begin + kInversionInsertionRun), comp);
+        }
+
+        T* source = data;
+        T* target = scratch;
+        for(std::size_t width = kInversionInsertionRun; width < size; width *= 2)
+        {
+            for(std::size_t begin = 0; begin < size; begin += 2 * width)
+            {
+                const std::size_t mid = std::min(size, begin + width);
+                const std::size_t end = std::min(size, begin + 2 * width);
+                count += Merge_Count(source + begin, source + mid, source + mid,
+                                     source + mid, source + end, target + begin, comp);
+            }
+            std::swap(source, target);
+        }
+        if(source != data)
+        {
+            std::copy(source, source + size, data);
+        }
+        return count;
+    }
+} /* namespace detail */
+
+/**
+ * @brief Count inversions of `data` and leave it sorted.
+ *
+ * Each of the `threads` chunks is sorted with a bottom-up merge sort, then the sorted runs
+ * are merged pairwise. Every pairwise merge is cut into merge-path segments proportional to
+ * its length so that late levels, which only have a few huge runs, still use all threads.
+ *
+ * @param data: elements to count, sorted on return
+ * @param threads: number of worker threads (1 runs fully serial)
+ * @param comp: strict weak ordering, an inversion is a pair i < j with comp(data[j], data[i])
+ *
+ * Example usage:
+ * @code
+ * std::vector<int> samples = Load_Telemetry();
+ * std::uint64_t inversions = Count_Inversions_In_Place(std::span(samples));
+ * @endcode
+ *
+ * @return std::uint64_t: number of inversions
+ */
+template<class T, class Compare = std::less<>>
+std::uint64_t Count_Inversions_In_Place(std::span<T> data, unsigned threads = Default_Thread_Count(), Compare comp = {})
+{
+    const std::size_t size = data.size();
+    if(size < 2)
+    {
+        return 0;
+    }
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, size / detail::kInversionInsertionRun + 1));
+
+    std::vector<T> scratchStorage(size);
+    T* source = data.data();
+    T* target = scratchStorage.data();
+
+    /* Phase 1: every thread sorts its own chunk, run boundaries match Parallel_For_Chunks */
+    std::vector<std::uint64_t> taskCounts(threads, 0);
+    Parallel_For_Chunks(size, threads, [&](unsigned chunk, std::size_t begin, std::size_t end)
+    {
+        taskCounts[chunk] = detail::Sort_Count_Serial(source + begin, target + begin, end - begin, comp);
+    });
+    std::uint64_t total = 0;
+    for(std::uint64_t count : taskCounts)
+    {
+        total += count;
+    }
+
+    std::vector<std::size_t> runs(threads + 1);
+    for(unsigned chunk = 0; chunk <= threads; ++chunk)
+    {
+        runs[chunk] = size * chunk / threads;
+    }
+
+    /* Phase 2: merge runs pairwise, each merge split into merge-path segments */
+    struct MergeTask
+    {
+        std::size_t begin;
+        std::size_t mid;
+        std::size_t end;
+        std::size_t diagonalBegin;
+        std::size_t diagonalEnd;
+    };
+    std::vector<MergeTask> tasks;
+    while(runs.size() > 2)
+    {
+        tasks.clear();
+        std::vector<std::size_t> mergedRuns;
+        for(std::size_t run = 0; run + 1 < runs.size(); run += 2)
+        {
+            const std::size_t begin = runs[run];
+            const std::size_t mid = runs[run + 1];
+            const std::size_t end = run + 2 < runs.size() ? runs[run + 2] : mid;
+            const std::size_t length = end - begin;
+            const std::size_t segments = std::max<std::size_t>(1, (length * threads + size - 1) / size);
+            for(std::size_t segment = 0; segment < segments; ++segment)
+            {
+                tasks.push_back({begin, mid, end, length * segment / segments, length * (segment + 1) / segments});
+            }
+            mergedRuns.push_back(begin);
+        }
+        mergedRuns.push_back(size);
+
+        taskCounts.assign(tasks.size(), 0);
+        Parallel_For_Chunks(tasks.size(), threads, [&](unsigned, std::size_t first, std::size_t last)
+        {
+            for(std::size_t index = first; index < last; ++index)
+            {
+                const MergeTask& task = tasks[index];
+                const T* a = source + task.begin;
+                const T* b = source + task.mid;
+                const std::size_t aSize = task.mid - task.begin;
+                const std::size_t bSize = task.end - task.mid;
+                const std::size_t aFrom = detail::Merge_Path_Split(a, aSize, b, bSize, task.diagonalBegin, comp);
+                const std::size_t aTo = detail::Merge_Path_Split(a, aSize, b, bSize, task.diagonalEnd, comp);
+                taskCounts[index] = detail::Merge_Count(a + aFrom, a + aTo, a + aSize,
+                                                        b + (task.diagonalBegin - aFrom), b + (task.diagonalEnd - aTo),
+                                                        target + task.begin + task.diagonalBegin, comp);
+            }
+        });
+        for(std::uint64_t count : taskCounts)
+        {
+            total += count;
+        }
+        std::swap(source, target);
+        runs = std::move(mergedRuns);
+    }
+
+    if(source != data.data())
+    {
+        Parallel_For_Chunks(size, threads, [&](unsigned, std::size_t begin, std::size_t end)
+        {
+            std::copy(source + begin, source + end, data.data() + begin);
+        });
+    }
+    return total;
+}
+
+/**
+ * @brief Count inversions of `data` without modifying it (works on a private copy).
+ *
+ * @param data: elements to count
+ * @param threads: number of worker threads
+ * @param comp: strict weak ordering
+ *
+ * @return std::uint64_t: number of inversions
+ */
+template<class T, class Compare = std::less<>>
+std::uint64_t Count_Inversions(std::span<const T> data, unsigned threads = Default_Thread_Count(), Compare comp = {})
+{
+    std::vector<T> copy(data.begin(), data.end());
+    return Count_Inversions_In_Place(std::span<T>(copy), threads, comp);
+}
+
+namespace detail
+{
+    /**
+     * @brief Turn a Fenwick tree (1-based, size domain + 1) back into plain per-key counts in place.
+     *
+     * Undoes the linear-time Fenwick build by walking indices from the top down.
+     */
+    inline void Fenwick_To_Counts(std::vector<std::uint64_t>& tree)
+    {
+        const std::size_t domain = tree.size() - 1;
+        for(std::size_t index = domain; index >= 1; --index)
+        {
+            const std::size_t parent = index + (index & (~index + 1));
+            if(parent <= domain)
+            {
+                tree[parent] -= tree[index];
+            }
+        }
+    }
+} /* namespace detail */
+
+/**
+ * @brief Count inversions of integer keys drawn from a small domain with Fenwick trees.
+ *
+ * Runs in O(n log(domain) / threads + threads * domain) and never moves the data, which
+ * beats the merge based counter when the keys are bucketed (domain of a few thousand).
+ * Each thread gets a tree of `max - min + 1` counters, so when the observed domain is
+ * larger than `maxDomain` this falls back to Count_Inversions().
+ *
+ * @param data: integer keys
+ * @param threads: number of worker threads
+ * @param maxDomain: largest key domain for which per-thread trees are allocated
+ *
+ * @return std::uint64_t: number of inversions
+ */
+template<std::integral T>
+std::uint64_t Count_Inversions_Fenwick(std::span<const T> data, unsigned threads = Default_Thread_Count(),
+                                       std::size_t maxDomain = std::size_t{1} << 16)
+{
+    if(data.size() < 2)
+    {
+        return 0;
+    }
+    const auto [minIt, maxIt] = std::minmax_element(data.begin(), data.end());
+    const std::uint64_t spread = static_cast<std::uint64_t>(*maxIt) - static_cast<std::uint64_t>(*minIt);
+    if(spread >= maxDomain)
+    {
+        return Count_Inversions(data, threads);
+    }
+    const std::size_t domain = static_cast<std::size_t>(spread) + 1;
+    const std::uint64_t minKey = static_cast<std::uint64_t>(*minIt);
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, data.size()));
+
+    std::vector<std::vector<std::uint64_t>> histograms(threads);
+    std::vector<std::uint64_t> localCounts(threads, 0);
+    Parallel_For_Chunks(data.size(), threads, [&](unsigned chunk, std::size_t begin, std::size_t end)
+    {
+        std::vector<std::uint64_t> tree(domain + 1, 0);
+        std::uint64_t count = 0;
+        for(std::size_t index = begin; index < end; ++index)
+        {
+            const std::size_t key = static_cast<std::size_t>(static_cast<std::uint64_t>(data[index]) - minKey) + 1;
+            std::uint64_t notGreater = 0;
+            for(std::size_t node = key; node > 0; node &= node - 1)
+            {
+                notGreater += tree[node];
+            }
+            count += (index - begin) - notGreater;
+            for(std::size_t node = key; node <= domain; node += node & (~node + 1))
+            {
+                ++tree[node];
+            }
+        }
+        detail::Fenwick_To_Counts(tree);
+        histograms[chunk] = std::move(tree);
+        localCounts[chunk] = count;
+    });
+
+    std::uint64_t total = 0;
+    for(std::uint64_t count : localCounts)
+    {
+        total += count;
+    }
+
+    /* Cross chunk pairs: every key of chunk c against all strictly greater keys of earlier chunks */
+    std::vector<std::uint64_t> earlier(domain + 1, 0);
+    std::uint64_t earlierTotal = 0;
+    for(unsigned chunk = 0; chunk < threads; ++chunk)
+    {
+        const std::vector<std::uint64_t>& histogram = histograms[chunk];
+        if(chunk > 0)
+        {
+            std::uint64_t notGreater = 0;
+            for(std::size_t key = 1; key <= domain; ++key)
+            {
+                notGreater += earlier[key];
+                total += histogram[key] * (earlierTotal - notGreater);
+            }
+        }
+        for(std::size_t key = 1; key <= domain; ++key)
+        {
+            earlier[key] += histogram[key];
+            earlierTotal += histogram[key];
+        }
+    }
+    return total;
+}
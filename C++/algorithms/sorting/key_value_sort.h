@@ -0,0 +1,311 @@
+#pragma once
+
+/*
+ * key_value_sort.h sorts records by key instead of bare int arrays.
+ *
+ *  - Arg_Sort: the permutation that sorts a key array (stable), the keys are left untouched.
+ *  - Sort_Key_Value: sorts parallel key / value arrays (struct-of-arrays) together without ever
+ *    building std::pair<K, V>. Arithmetic keys use an LSD radix sort that scatters keys and values
+ *    into separate buffers, passes where every key shares the same digit are skipped.
+ *  - Sort_By_Key: sorts large structs by moving only (key, index) pairs and then applying the
+ *    resulting permutation in place with one cycle-following pass, so every record is moved once.
+ *
+ * Arithmetic keys (integers and floating point) are radix sorted through an order preserving
+ * unsigned transform, other key types fall back to std::stable_sort on indices. Indices are 32 bit,
+ * inputs are limited to 2^32 - 1 elements.
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail
+{
+    /**
+     * @brief Map an arithmetic key to an unsigned integer with the same ordering.
+     *
+     * Signed integers get their sign bit flipped. Floats flip every bit when negative and only the
+     * sign bit otherwise, which orders them like operator< (-0.0 sorts before +0.0, positive NaNs last).
+     */
+    template<class K>
+    auto To_Radix_Key(const K key) noexcept
+    {
+        static_assert(std::is_arithmetic_v<K>, "radix keys must be arithmetic");
+        if constexpr(std::is_floating_point_v<K>)
+        {
+            using Bits = std::conditional_t<sizeof(K) == 4, std::uint32_t, std::uint64_t>;
+            const Bits bits = std::bit_cast<Bits>(key);
+            const Bits signBit = Bits{1} << (sizeof(Bits) * 8 - 1);
+            return (bits & signBit) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | signBit);
+        }
+        else
+        {
+            using Bits = std::make_unsigned_t<std::conditional_t<std::is_same_v<K, bool>, unsigned char, K>>;
+            Bits bits = static_cast<Bits>(key);
+            if constexpr(std::is_signed_v<K>)
+            {
+                bits ^= Bits{1} << (sizeof(Bits) * 8 - 1);
+            }
+            return bits;
+        }
+    }
+
+    /**
+     * @brief Inverse of To_Radix_Key.
+     */
+    template<class K, class U>
+    K From_Radix_Key(U bits) noexcept
+    {
+        if constexpr(std::is_floating_point_v<K>)
+        {
+            const U signBit = U{1} << (sizeof(U) * 8 - 1);
+            return std::bit_cast<K>((bits & signBit) ? static_cast<U>(bits ^ signBit) : static_cast<U>(~bits));
+        }
+        else
+        {
+            if constexpr(std::is_signed_v<K>)
+            {
+                bits ^= U{1} << (sizeof(U) * 8 - 1);
+            }
+            return static_cast<K>(bits);
+        }
+    }
+
+    /**
+     * @brief Stable LSD radix sort of unsigned `keys` carrying `values` along (struct-of-arrays).
+     *
+     * One pass over the keys builds the histograms of every 8 bit digit, then one scatter per
+     * digit that actually varies. Scratch buffers are allocated once for keys and values.
+     */
+    template<class U, class V>
+    void Radix_Sort_Soa(std::span<U> keys, std::span<V> values)
+    {
+        static_assert(std::is_unsigned_v<U>, "radix sort keys must already be unsigned");
+        constexpr std::size_t kDigits = sizeof(U);
+        const std::size_t size = keys.size();
+        if(size < 2)
+        {
+            return;
+        }
+
+        std::vector<std::array<std::size_t, 256>> histograms(kDigits);
+        for(std::array<std::size_t, 256>& histogram : histograms)
+        {
+            histogram.fill(0);
+        }
+        for(const U key : keys)
+        {
+            for(std::size_t digit = 0; digit < kDigits; ++digit)
+            {
+                ++histograms[digit][(key >> (digit * 8)) & 0xFF];
+            }
+        }
+
+        std::vector<U> keyBuffer(size);
+        std::vector<V> valueBuffer(size);
+        U* keySource = keys.data();
+        V* valueSource = values.data();
+        U* keyTarget = keyBuffer.data();
+        V* valueTarget = valueBuffer.data();
+        for(std::size_t digit = 0; digit < kDigits; ++digit)
+        {
+            std::array<std::size_t, 256>& histogram = histograms[digit];
+            const std::size_t shift = digit * 8;
+            if(histogram[(keySource[0] >> shift) & 0xFF] == size)
+            {
+                continue; /* every key has the same digit, the pass would be the identity */
+            }
+            std::size_t offset = 0;
+            for(std::size_t& count : histogram)
+            {
+                offset += std::exchange(count, offset);
+            }
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                const std::size_t target = histogram[(keySource[i] >> shift) & 0xFF]++;
+                keyTarget[target] = keySource[i];
+                valueTarget[target] = std::move(valueSource[i]);
+            }
+            std::swap(keySource, keyTarget);
+            std::swap(valueSource, valueTarget);
+        }
+        if(keySource != keys.data())
+        {
+            std::copy(keySource, keySource + size, keys.data());
+            std::move(valueSource, valueSource + size, values.data());
+        }
+    }
+
+    template<class K>
+    using RadixKeyOf = decltype(To_Radix_Key(std::declval<K>()));
+
+    /* 0 .. size - 1 as uint32 indices, in order */
+    inline std::vector<std::uint32_t> Arg_Sort_Identity(const std::size_t size)
+    {
+        if(size > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::length_error("Arg_Sort: " + std::to_string(size) + " keys do not fit 32 bit indices");
+        }
+        std::vector<std::uint32_t> order(size);
+        std::iota(order.begin(), order.end(), std::uint32_t{0});
+        return order;
+    }
+} /* namespace detail */
+
+/**
+ * @brief Apply a gather permutation in place: afterwards data[i] holds what was at data[order[i]].
+ *
+ * Follows each cycle of the permutation once with a single temporary, so every element is moved
+ * exactly once (plus one move per cycle) and no second copy of `data` is needed. `order` is used
+ * as the visited marker and holds the identity on return.
+ *
+ * @param data: elements to reorder
+ * @param order: permutation of [0, data.size()), consumed
+ */
+template<class T, class Index>
+void Apply_Permutation(std::span<T> data, std::span<Index> order)
+{
+    for(std::size_t start = 0; start < data.size(); ++start)
+    {
+        if(static_cast<std::size_t>(order[start]) == start)
+        {
+            continue;
+        }
+        T carried = std::move(data[start]);
+        std::size_t current = start;
+        while(true)
+        {
+            const std::size_t next = static_cast<std::size_t>(order[current]);
+            order[current] = static_cast<Index>(current);
+            if(next == start)
+            {
+                data[current] = std::move(carried);
+                break;
+            }
+            data[current] = std::move(data[next]);
+            current = next;
+        }
+    }
+}
+
+/**
+ * @brief Stable permutation that sorts `keys`: keys[result[0]] <= keys[result[1]] <= ...
+ *
+ * Arithmetic keys are radix sorted together with their indices, O(n) passes over contiguous
+ * arrays instead of O(n log n) random accesses into `keys`.
+ *
+ * Example usage:
+ * @code
+ * std::vector<std::uint32_t> order = Arg_Sort(std::span<const double>(prices));
+ * const double cheapest = prices[order.front()];
+ * @endcode
+ *
+ * @return std::vector<std::uint32_t>: indices into keys in ascending key order; throws
+ *         std::length_error above 2^32 - 1 keys
+ */
+template<class K>
+std::vector<std::uint32_t> Arg_Sort(std::span<const K> keys)
+{
+    std::vector<std::uint32_t> order = detail::Arg_Sort_Identity(keys.size());
+    if constexpr(std::is_arithmetic_v<K>)
+    {
+        std::vector<detail::RadixKeyOf<K>> radixKeys(keys.size());
+        std::transform(keys.begin(), keys.end(), radixKeys.begin(), [](const K key) { return detail::To_Radix_Key(key); });
+        detail::Radix_Sort_Soa(std::span(radixKeys), std::span(order));
+    }
+    else
+    {
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right) { return keys[left] < keys[right]; });
+    }
+    return order;
+}
+
+/**
+ * @brief Stable permutation that sorts `keys` under a custom ordering.
+ */
+template<class K, class Compare>
+std::vector<std::uint32_t> Arg_Sort(std::span<const K> keys, Compare comp)
+{
+    std::vector<std::uint32_t> order = detail::Arg_Sort_Identity(keys.size());
+    std::stable_sort(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right) { return comp(keys[left], keys[right]); });
+    return order;
+}
+
+/**
+ * @brief Stably sort parallel key / value arrays by key, keeping the struct-of-arrays layout.
+ *
+ * @param keys: sort keys, sorted on return
+ * @param values: payload, values[i] stays attached to keys[i]; same length as keys, else
+ *                std::invalid_argument
+ *
+ * Example usage:
+ * @code
+ * Sort_Key_Value(std::span(timestamps), std::span(readings));
+ * @endcode
+ */
+template<class K, class V>
+void Sort_Key_Value(std::span<K> keys, std::span<V> values)
+{
+    if(keys.size() != values.size())
+    {
+        throw std::invalid_argument("Sort_Key_Value: " + std::to_string(keys.size()) + " keys but " + std::to_string(values.size()) + " values");
+    }
+    if constexpr(std::is_arithmetic_v<K>)
+    {
+        using U = detail::RadixKeyOf<K>;
+        if constexpr(std::is_same_v<K, U>)
+        {
+            detail::Radix_Sort_Soa(keys, values);
+        }
+        else
+        {
+            /* Sort the order preserving images, then map them back: no permutation pass needed */
+            std::vector<U> radixKeys(keys.size());
+            std::transform(keys.begin(), keys.end(), radixKeys.begin(), [](const K key) { return detail::To_Radix_Key(key); });
+            detail::Radix_Sort_Soa(std::span(radixKeys), values);
+            std::transform(radixKeys.begin(), radixKeys.end(), keys.begin(), [](const U bits) { return detail::From_Radix_Key<K>(bits); });
+        }
+    }
+    else
+    {
+        std::vector<std::uint32_t> order = Arg_Sort(std::span<const K>(keys));
+        std::vector<std::uint32_t> valueOrder = order;
+        Apply_Permutation(keys, std::span(order));
+        Apply_Permutation(values, std::span(valueOrder));
+    }
+}
+
+/**
+ * @brief Stably sort records by `keyOf(record)` while moving each record only once.
+ *
+ * Only compact (key, index) pairs take part in the sort; the records are then permuted in
+ * place by Apply_Permutation. Pays off when records are much larger than their key.
+ *
+ * @param records: records to sort
+ * @param keyOf: callable returning the sort key of a record
+ *
+ * Example usage:
+ * @code
+ * Sort_By_Key(std::span(packets), [](const Packet& packet) { return packet.timestamp; });
+ * @endcode
+ */
+template<class T, class KeyOf>
+void Sort_By_Key(std::span<T> records, KeyOf keyOf)
+{
+    using K = std::remove_cvref_t<std::invoke_result_t<KeyOf&, const T&>>;
+    std::vector<K> keys(records.size());
+    std::transform(records.begin(), records.end(), keys.begin(), [&](const T& record) { return keyOf(record); });
+    std::vector<std::uint32_t> order = Arg_Sort(std::span<const K>(keys));
+    Apply_Permutation(records, std::span(order));
+}
@@ -0,0 +1,476 @@
+#pragma once
+
+/*
+ * selection.h answers "which are the k smallest elements" without sorting everything.
+ *
+ *  - Intro_Select: nth_element style selection. Same partition step as quick-sort.cpp, made
+ *    three way so runs of equal keys end the search instead of degrading it, with median of
+ *    three pivots and a heap select fallback once the recursion budget is exhausted (O(n log n)
+ *    worst case instead of O(n^2)).
+ *  - StreamingTopK: bounded max-heap holding the k smallest values seen so far, for inputs that
+ *    do not fit in memory or never end.
+ *  - Top_K_Smallest: batch top-k for int32 / float arrays. A SIMD filter drops every element that
+ *    is not below the current k-th smallest candidate in bulk, survivors are collected in a buffer
+ *    that is shrunk back to k with Intro_Select whenever it fills up.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/cpu_features.h"
+
+#if ALGORITHMS_X86
+#include <immintrin.h>
+#endif /* ALGORITHMS_X86 */
+
+namespace detail
+{
+    /* Ranges at or below this size are finished with insertion sort */
+    inline constexpr std::size_t kSelectInsertionThreshold = 16;
+
+    template<class T, class Compare>
+    void Insertion_Sort_Range(T* first, T* last, Compare& comp)
+    {
+        for(T* current = first + (first != last); current < last; ++current)
+        {
+            T value = std::move(*current);
+            T* hole = current;
+            while(hole != first && comp(value, *(hole - 1)))
+            {
+                *hole = std::move(*(hole - 1));
+                --hole;
+            }
+            *hole = std::move(value);
+        }
+    }
+
+    template<class T, class Compare>
+    const T& Median_Of_Three(const T& a, const T& b, const T& c, Compare& comp)
+    {
+        if(comp(a, b))
+        {
+            return comp(b, c) ? b : (comp(a, c) ? c : a);
+        }
+        return comp(a, c) ? a : (comp(b, c) ? c : b);
+    }
+
+    /**
+     * @brief Three way partition of [first, last) around `pivot`.
+     *
+     * @return std::pair<T*, T*>: [first, less) < pivot, [less, greater) == pivot, [greater, last) > pivot
+     */
+    template<class T, class Compare>
+    std::pair<T*, T*> Partition_Three_Way(T* first, T* last, const T pivot, Compare& comp)
+    {
+        T* less = first;
+        T* current = first;
+        T* greater = last;
+        while(current < greater)
+        {
+            if(comp(*current, pivot))
+            {
+                std::swap(*less++, *current++);
+            }
+            else if(comp(pivot, *current))
+            {
+                std::swap(*current, *--greater);
+            }
+            else
+            {
+                ++current;
+            }
+        }
+        return {less, greater};
+    }
+
+    /**
+     * @brief Heap based selection used when quick select keeps picking bad pivots.
+     *
+     * Keeps the (nth - first + 1) smallest elements in a max heap over [first, nth] and
+     * finally pops the largest of them into *nth.
+     */
+    template<class T, class Compare>
+    void Heap_Select(T* first, T* nth, T* last, Compare& comp)
+    {
+        T* heapEnd = nth + 1;
+        std::make_heap(first, heapEnd, comp);
+        for(T* current = heapEnd; current < last; ++current)
+        {
+            if(comp(*current, *first))
+            {
+                std::pop_heap(first, heapEnd, comp);
+                std::swap(*(heapEnd - 1), *current);
+                std::push_heap(first, heapEnd, comp);
+            }
+        }
+        std::pop_heap(first, heapEnd, comp);
+    }
+} /* namespace detail */
+
+/**
+ * @brief Rearrange `data` so data[k] is the element a full sort would put there (like std::nth_element).
+ *
+ * Everything before position k compares not greater than data[k], everything after not less.
+ *
+ * @param data: elements to partially order
+ * @param k: zero based rank to select, must be below data.size()
+ * @param comp: strict weak ordering
+ *
+ * Example usage:
+ * @code
+ * Intro_Select(std::span(latencies), latencies.size() * 99 / 100);
+ * int p99 = latencies[latencies.size() * 99 / 100];
+ * @endcode
+ */
+template<class T, class Compare = std::less<>>
+void Intro_Select(std::span<T> data, std::size_t k, Compare comp = {})
+{
+    if(k >= data.size())
+    {
+        return;
+    }
+    T* first = data.data();
+    T* last = first + data.size();
+    T* nth = first + k;
+    std::size_t depthBudget = 2 * std::bit_width(data.size());
+    while(static_cast<std::size_t>(last - first) > detail::kSelectInsertionThreshold)
+    {
+        if(depthBudget-- == 0)
+        {
+            detail::Heap_Select(first, nth, last, comp);
+            return;
+        }
+        const T pivot = detail::Median_Of_Three(*first, first[(last - first) / 2], *(last - 1), comp);
+        const auto [less, greater] = detail::Partition_Three_Way(first, last, pivot, comp);
+        if(nth < less)
+        {
+            last = less;
+        }
+        else if(nth >= greater)
+        {
+            first = greater;
+        }
+        else
+        {
+            return; /* nth landed among the keys equal to the pivot */
+        }
+    }
+    detail::Insertion_Sort_Range(first, last, comp);
+}
+
+/**
+ * @brief Move the k smallest elements, sorted, to the front of `data` (like std::partial_sort).
+ *
+ * Intro_Select followed by a sort of the first k elements, so O(n + k log k) on average.
+ */
+template<class T, class Compare = std::less<>>
+void Partial_Sort_Smallest(std::span<T> data, std::size_t k, Compare comp = {})
+{
+    k = std::min(k, data.size());
+    if(k == 0)
+    {
+        return;
+    }
+    if(k < data.size())
+    {
+        Intro_Select(data, k - 1, comp);
+    }
+    std::sort(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(k), comp);
+}
+
+/**
+ * @brief Keeps the k smallest values of an unbounded stream in a bounded max-heap.
+ *
+ * Memory is O(k) regardless of how many values are pushed. Once k values are held, a push
+ * costs one comparison against Threshold() and, only for values that get in, O(log k).
+ *
+ * Example usage:
+ * @code
+ * StreamingTopK<double> fastest(100);
+ * while(Receive_Sample(sample))
+ * {
+ *     fastest.Push(sample.latency);
+ * }
+ * std::vector<double> best = fastest.SortedResult();
+ * @endcode
+ */
+template<class T, class Compare = std::less<>>
+class StreamingTopK
+{
+public:
+    explicit StreamingTopK(std::size_t k, Compare comp = {}) : m_capacity(k), m_comp(std::move(comp))
+    {
+        m_heap.reserve(k);
+    }
+
+    void Push(const T& value)
+    {
+        if(m_heap.size() < m_capacity)
+        {
+            m_heap.push_back(value);
+            std::push_heap(m_heap.begin(), m_heap.end(), m_comp);
+        }
+        else if(m_capacity > 0 && m_comp(value, m_heap.front()))
+        {
+            Replace_Top(value);
+        }
+    }
+
+    void PushRange(std::span<const T> values)
+    {
+        for(const T& value : values)
+        {
+            Push(value);
+        }
+    }
+
+    bool IsFull() const noexcept
+    {
+        return m_heap.size() == m_capacity;
+    }
+
+    std::size_t Size() const noexcept
+    {
+        return m_heap.size();
+    }
+
+    /**
+     * @brief Largest value currently kept, new values must compare below it to get in. Requires Size() > 0.
+     */
+    const T& Threshold() const noexcept
+    {
+        return m_heap.front();
+    }
+
+    /**
+     * @return std::vector<T>: the kept values in ascending order
+     */
+    std::vector<T> SortedResult() const
+    {
+        std::vector<T> result = m_heap;
+        std::sort_heap(result.begin(), result.end(), m_comp);
+        return result;
+    }
+
+    void Clear() noexcept
+    {
+        m_heap.clear();
+    }
+
+private:
+    /* Overwrite the root and sift it down: one pass instead of pop_heap + push_heap */
+    void Replace_Top(const T& value)
+    {
+        const std::size_t size = m_heap.size();
+        std::size_t hole = 0;
+        for(std::size_t child = 1; child < size; child = 2 * hole + 1)
+        {
+            if(child + 1 < size && m_comp(m_heap[child], m_heap[child + 1]))
+            {
+                ++child;
+            }
+            if(!m_comp(value, m_heap[child]))
+            {
+                break;
+            }
+            m_heap[hole] = std::move(m_heap[child]);
+            hole = child;
+        }
+        m_heap[hole] = value;
+    }
+
+    std::vector<T> m_heap;
+    std::size_t m_capacity;
+    Compare m_comp;
+};
+
+namespace detail
+{
+    /**
+     * @brief Append every element of data[0, count) that is strictly below `threshold` to `out`.
+     *
+     * @return std::size_t: number of elements written
+     */
+    template<class T>
+    std::size_t Filter_Less_Scalar(const T* data, std::size_t count, T threshold, T* out) noexcept
+    {
+        std::size_t written = 0;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            out[written] = data[i];
+            written += data[i] < threshold; /* branchless: always store, only advance on a hit */
+        }
+        return written;
+    }
+
+#if ALGORITHMS_X86
+    /* Bit i set when values[i] < threshold, for 8 lanes */
+    __attribute__((target("avx2")))
+    inline unsigned Less_Mask_Avx2(const std::int32_t* values, __m256i threshold) noexcept
+    {
+        const __m256i vector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(threshold, vector))));
+    }
+
+    __attribute__((target("avx2")))
+    inline unsigned Less_Mask_Avx2(const float* values, __m256 threshold) noexcept
+    {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(values), threshold, _CMP_LT_OQ)));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i Broadcast_Avx2(std::int32_t value) noexcept
+    {
+        return _mm256_set1_epi32(value);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256 Broadcast_Avx2(float value) noexcept
+    {
+        return _mm256_set1_ps(value);
+    }
+
+    /* AVX2: test 32 elements per step and only look at individual lanes when one of them passes */
+    template<class T>
+    __attribute__((target("avx2,bmi")))
+    std::size_t Filter_Less_Avx2(const T* data, std::size_t count, T threshold, T* out) noexcept
+    {
+        static_assert(sizeof(T) == 4, "AVX2 filter handles 32 bit lanes");
+        const auto limit = Broadcast_Avx2(threshold);
+        std::size_t written = 0;
+        std::size_t i = 0;
+        for(; i + 32 <= count; i += 32)
+        {
+            const std::uint32_t mask = Less_Mask_Avx2(data + i, limit) | Less_Mask_Avx2(data + i + 8, limit) << 8 |
+                                       Less_Mask_Avx2(data + i + 16, limit) << 16 | Less_Mask_Avx2(data + i + 24, limit) << 24;
+            for(std::uint32_t bits = mask; bits != 0; bits &= bits - 1)
+            {
+                out[written++] = data[i + static_cast<std::size_t>(std::countr_zero(bits))];
+            }
+        }
+        return written + Filter_Less_Scalar(data + i, count - i, threshold, out + written);
+    }
+
+    /* AVX-512: compare 16 lanes and compress the survivors straight into the output */
+    template<class T>
+    __attribute__((target("avx512f")))
+    std::size_t Filter_Less_Avx512(const T* data, std::size_t count, T threshold, T* out) noexcept
+    {
+        static_assert(sizeof(T) == 4, "AVX-512 filter handles 32 bit lanes");
+        std::size_t written = 0;
+        std::size_t i = 0;
+        for(; i + 16 <= count; i += 16)
+        {
+            if constexpr(std::is_floating_point_v<T>)
+            {
+                const __m512 vector = _mm512_loadu_ps(data + i);
+                const __mmask16 mask = _mm512_cmp_ps_mask(vector, _mm512_set1_ps(threshold), _CMP_LT_OQ);
+                _mm512_mask_compressstoreu_ps(out + written, mask, vector);
+                written += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+            }
+            else
+            {
+                const __m512i vector = _mm512_loadu_si512(data + i);
+                const __mmask16 mask = _mm512_cmplt_epi32_mask(vector, _mm512_set1_epi32(threshold));
+                _mm512_mask_compressstoreu_epi32(out + written, mask, vector);
+                written += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+            }
+        }
+        return written + Filter_Less_Scalar(data + i, count - i, threshold, out + written);
+    }
+#endif /* ALGORITHMS_X86 */
+
+    template<class T>
+    std::size_t Filter_Less(const T* data, std::size_t count, T threshold, T* out, ESimdLevel level) noexcept
+    {
+#if ALGORITHMS_X86
+        if constexpr(std::is_same_v<T, std::int32_t> || std::is_same_v<T, float>)
+        {
+            if(level == ESimdLevel::Avx512)
+            {
+                return Filter_Less_Avx512(data, count, threshold, out);
+            }
+            if(level == ESimdLevel::Avx2)
+            {
+                return Filter_Less_Avx2(data, count, threshold, out);
+            }
+        }
+#endif /* ALGORITHMS_X86 */
+        (void)level;
+        return Filter_Less_Scalar(data, count, threshold, out);
+    }
+} /* namespace detail */
+
+/**
+ * @brief The k smallest values of `data` in ascending order.
+ *
+ * Blocks of the input are filtered against the k-th smallest candidate found so far; for
+ * random data almost every block is rejected by a handful of vector compares once the
+ * threshold has settled. int32 and float use AVX2 / AVX-512 kernels, other arithmetic types use
+ * the scalar filter. NaNs are skipped, by the filter and before the first threshold, so the
+ * selection only ever compares ordered values.
+ *
+ * @param data: input values, not modified
+ * @param k: number of values to return
+ * @param level: SIMD level to use, defaults to the best one the CPU supports
+ *
+ * @return std::vector<T>: min(k, number of values that are not NaN) smallest values, ascending
+ */
+template<class T>
+std::vector<T> Top_K_Smallest(std::span<const T> data, std::size_t k, ESimdLevel level = Detect_Simd_Level())
+{
+    static_assert(std::is_arithmetic_v<T>, "Top_K_Smallest filters with operator< on arithmetic types");
+    constexpr std::size_t kBlock = 4096;
+    k = std::min(k, data.size());
+    if(k == 0)
+    {
+        return {};
+    }
+
+    /* Candidates grow to `capacity` before being cut back to k, amortising each cut over >= k pushes */
+    const std::size_t capacity = std::max<std::size_t>(2 * k, kBlock);
+    std::vector<T> candidates(capacity + kBlock);
+    std::size_t candidateCount = 0;
+    bool bHasThreshold = false;
+    T threshold{};
+
+    for(std::size_t begin = 0; begin < data.size(); begin += kBlock)
+    {
+        const std::size_t count = std::min(kBlock, data.size() - begin);
+        if(bHasThreshold)
+        {
+            candidateCount += detail::Filter_Less(data.data() + begin, count, threshold, candidates.data() + candidateCount, level);
+        }
+        else if constexpr(std::is_floating_point_v<T>)
+        {
+            const T* const end = std::copy_if(data.data() + begin, data.data() + begin + count, candidates.data() + candidateCount, [](T value) { return value == value; });
+            candidateCount = static_cast<std::size_t>(end - candidates.data());
+        }
+        else
+        {
+            std::copy_n(data.data() + begin, count, candidates.data() + candidateCount);
+            candidateCount += count;
+        }
+        if(candidateCount >= capacity)
+        {
+            Intro_Select(std::span<T>(candidates.data(), candidateCount), k - 1);
+            candidateCount = k;
+            threshold = candidates[k - 1];
+            bHasThreshold = true;
+        }
+    }
+
+    /* fewer than k values are left only when NaNs were skipped */
+    k = std::min(k, candidateCount);
+    std::span<T> kept(candidates.data(), candidateCount);
+    Partial_Sort_Smallest(kept, k);
+    return std::vector<T>(kept.begin(), kept.begin() + static_cast<std::ptrdiff_t>(k));
+}
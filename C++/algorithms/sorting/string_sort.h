@@ -0,0 +1,374 @@
+#pragma once
+
+/*
+ * string_sort.h sorts large sets of strings by reordering std::string_view handles,
+ * the character data itself is never copied or moved.
+ *
+ * String_Sort is a multikey quicksort over 8 byte "superchars": every key caches the next
+ * 8 bytes of its string (big endian, zero padded) so most partitioning steps compare two
+ * integers that already sit in the array being partitioned instead of dereferencing the
+ * strings. The cache is only refreshed for the equal partition when it moves 8 bytes deeper.
+ *
+ * String_Sort_Parallel sorts one chunk per thread and merges the sorted runs pairwise with an
+ * LCP-aware merge, so characters already known to be shared with the previous output are not
+ * compared again.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/parallel.h"
+
+namespace detail
+{
+    /* Ranges at or below this size are finished with insertion sort */
+    inline constexpr std::size_t kStringInsertionThreshold = 16;
+
+    struct StringSortItem
+    {
+        std::uint64_t cache;    /* bytes [depth, depth + 8) of text, big endian, zero padded */
+        std::string_view text;
+    };
+
+    /**
+     * @brief Load 8 bytes of `text` starting at `depth` as a big endian integer, zero padded past the end.
+     *
+     * Comparing two superchars as integers orders them like memcmp on the underlying bytes.
+     */
+    inline std::uint64_t Load_Superchar(std::string_view text, std::size_t depth) noexcept
+    {
+        std::uint64_t value = 0;
+        if(depth + sizeof(value) <= text.size())
+        {
+            std::memcpy(&value, text.data() + depth, sizeof(value));
+        }
+        else if(depth < text.size())
+        {
+            std::memcpy(&value, text.data() + depth, text.size() - depth);
+        }
+        if constexpr(std::endian::native == std::endian::little)
+        {
+            value = std::byteswap(value);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Strict order of two items whose first `depth` bytes are known to be equal.
+     */
+    inline bool String_Item_Less(const StringSortItem& left, const StringSortItem& right, std::size_t depth) noexcept
+    {
+        if(left.cache != right.cache)
+        {
+            return left.cache < right.cache;
+        }
+        const std::size_t from = std::min(depth, std::min(left.text.size(), right.text.size()));
+        return left.text.substr(from) < right.text.substr(from);
+    }
+
+    inline void String_Insertion_Sort(StringSortItem* first, StringSortItem* last, std::size_t depth) noexcept
+    {
+        for(StringSortItem* current = first + (first != last); current < last; ++current)
+        {
+            StringSortItem value = *current;
+            StringSortItem* hole = current;
+            while(hole != first && String_Item_Less(value, *(hole - 1), depth))
+            {
+                *hole = *(hole - 1);
+                --hole;
+            }
+            *hole = value;
+        }
+    }
+
+    inline std::uint64_t Median_Of_Three(std::uint64_t a, std::uint64_t b, std::uint64_t c) noexcept
+    {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+    /**
+     * @brief Multikey quicksort of items[0, size), every cache already loaded at depth 0.
+     *
+     * Uses an explicit task stack rather than recursion, so long shared prefixes cannot
+     * overflow the call stack.
+     */
+    inline void Multikey_Quicksort(StringSortItem* items, std::size_t size)
+    {
+        struct Task
+        {
+            std::size_t begin;
+            std::size_t end;
+            std::size_t depth;
+        };
+        std::vector<Task> tasks;
+        tasks.push_back({0, size, 0});
+        while(!tasks.empty())
+        {
+            const Task task = tasks.back();
+            tasks.pop_back();
+            StringSortItem* first = items + task.begin;
+            const std::size_t count = task.end - task.begin;
+            if(count <= kStringInsertionThreshold)
+            {
+                String_Insertion_Sort(first, first + count, task.depth);
+                continue;
+            }
+
+            /* Three way partition on the cached superchar */
+            const std::uint64_t pivot = Median_Of_Three(first[0].cache, first[count / 2].cache, first[count - 1].cache);
+            std::size_t less = 0;
+            std::size_t index = 0;
+            std::size_t greater = count;
+            while(index < greater)
+            {
+                const std::uint64_t cache = first[index].cache;
+                if(cache < pivot)
+                {
+                    std::swap(first[less++], first[index++]);
+                }
+                else if(cache > pivot)
+                {
+                    std::swap(first[index], first[--greater]);
+                }
+                else
+                {
+                    ++index;
+                }
+            }
+
+            /*
+             * Equal partition: strings ending inside this superchar are finished. Equal caches mean
+             * they only differ by trailing zero padding, so shorter sorts first, and all of them
+             * sort before the strings that continue past depth + 8.
+             */
+            const std::size_t nextDepth = task.depth + sizeof(std::uint64_t);
+            StringSortItem* equalBegin = first + less;
+            StringSortItem* equalEnd = first + greater;
+            StringSortItem* continuing = std::partition(equalBegin, equalEnd, [nextDepth](const StringSortItem& item)
+            {
+                return item.text.size() <= nextDepth;
+            });
+            std::sort(equalBegin, continuing, [](const StringSortItem& left, const StringSortItem& right)
+            {
+                return left.text.size() < right.text.size();
+            });
+            for(StringSortItem* item = continuing; item != equalEnd; ++item)
+            {
+                item->cache = Load_Superchar(item->text, nextDepth);
+            }
+
+            const std::size_t equalOffset = task.begin + static_cast<std::size_t>(continuing - first);
+            Task pending[3] = {{task.begin, task.begin + less, task.depth},
+                               {equalOffset, task.begin + greater, nextDepth},
+                               {task.begin + greater, task.end, task.depth}};
+            /* Largest first so it is popped last, keeping the task stack shallow */
+            std::sort(std::begin(pending), std::end(pending), [](const Task& left, const Task& right)
+            {
+                return left.end - left.begin > right.end - right.begin;
+            });
+            for(const Task& next : pending)
+            {
+                if(next.end - next.begin > 1)
+                {
+                    tasks.push_back(next);
+                }
+            }
+        }
+    }
+
+    inline std::size_t Common_Prefix(std::string_view left, std::string_view right, std::size_t from) noexcept
+    {
+        const std::size_t limit = std::min(left.size(), right.size());
+        while(from < limit && left[from] == right[from])
+        {
+            ++from;
+        }
+        return from;
+    }
+
+    /**
+     * @brief LCP-aware merge of two sorted runs.
+     *
+     * lcp[i] holds the longest common prefix of run[i - 1] and run[i] (lcp[0] is unused).
+     * Knowing the LCP of each head with the last emitted string decides most steps without
+     * looking at characters, and when it does not the comparison starts at that LCP.
+     */
+    inline void LCP_Merge(std::span<const std::string_view> a, std::span<const std::size_t> aLcp,
+                          std::span<const std::string_view> b, std::span<const std::size_t> bLcp,
+                          std::string_view* out, std::size_t* outLcp) noexcept
+    {
+        std::size_t i = 0;
+        std::size_t j = 0;
+        std::size_t aHead = 0; /* lcp(last output, a[i]) */
+        std::size_t bHead = 0; /* lcp(last output, b[j]) */
+        while(i < a.size() && j < b.size())
+        {
+            bool takeA = false;
+            if(aHead != bHead)
+            {
+                takeA = aHead > bHead;
+                if(takeA)
+                {
+                    *outLcp++ = aHead;
+                }
+                else
+                {
+                    *outLcp++ = bHead;
+                }
+            }
+            else
+            {
+                const std::size_t shared = Common_Prefix(a[i], b[j], aHead);
+                takeA = a[i].substr(shared) <= b[j].substr(shared);
+                *outLcp++ = aHead;
+                if(takeA)
+                {
+                    bHead = shared;
+                }
+                else
+                {
+                    aHead = shared;
+                }
+            }
+            if(takeA)
+            {
+                *out++ = a[i++];
+                aHead = i < a.size() ? aLcp[i] : 0;
+            }
+            else
+            {
+                *out++ = b[j++];
+                bHead = j < b.size() ? bLcp[j] : 0;
+            }
+        }
+        for(bool first = true; i < a.size(); ++i, first = false)
+        {
+            *outLcp++ = first ? aHead : aLcp[i];
+            *out++ = a[i];
+        }
+        for(bool first = true; j < b.size(); ++j, first = false)
+        {
+            *outLcp++ = first ? bHead : bLcp[j];
+            *out++ = b[j];
+        }
+    }
+} /* namespace detail */
+
+/**
+ * @brief Sort string handles lexicographically (byte wise, like std::string_view::operator<).
+ *
+ * @param strings: views to reorder, the viewed characters are untouched
+ *
+ * Example usage:
+ * @code
+ * std::vector<std::string_view> symbols(names.begin(), names.end());
+ * String_Sort(std::span(symbols));
+ * @endcode
+ */
+inline void String_Sort(std::span<std::string_view> strings)
+{
+    std::vector<detail::StringSortItem> items(strings.size());
+    for(std::size_t i = 0; i < strings.size(); ++i)
+    {
+        items[i] = {detail::Load_Superchar(strings[i], 0), strings[i]};
+    }
+    detail::Multikey_Quicksort(items.data(), items.size());
+    for(std::size_t i = 0; i < strings.size(); ++i)
+    {
+        strings[i] = items[i].text;
+    }
+}
+
+/**
+ * @brief Longest common prefix of every sorted string with its predecessor (lcp[0] = 0).
+ */
+inline std::vector<std::size_t> Compute_LCP(std::span<const std::string_view> sorted)
+{
+    std::vector<std::size_t> lcp(sorted.size(), 0);
+    for(std::size_t i = 1; i < sorted.size(); ++i)
+    {
+        lcp[i] = detail::Common_Prefix(sorted[i - 1], sorted[i], 0);
+    }
+    return lcp;
+}
+
+/**
+ * @brief Sort string handles with one multikey quicksort per thread followed by LCP-aware merges.
+ *
+ * Each pairwise merge runs on its own thread, so the last level is a single serial merge;
+ * it is cheap because the LCP arrays let it skip almost every shared character.
+ *
+ * @param strings: views to reorder
+ * @param threads: number of worker threads
+ */
+inline void String_Sort_Parallel(std::span<std::string_view> strings, unsigned threads = Default_Thread_Count())
+{
+    const std::size_t size = strings.size();
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, size / 4096 + 1));
+    if(threads == 1)
+    {
+        String_Sort(strings);
+        return;
+    }
+
+    std::vector<std::size_t> lcp(size);
+    Parallel_For_Chunks(size, threads, [&](unsigned, std::size_t begin, std::size_t end)
+    {
+        std::span<std::string_view> run = strings.subspan(begin, end - begin);
+        String_Sort(run);
+        lcp[begin] = 0;
+        for(std::size_t i = begin + 1; i < end; ++i)
+        {
+            lcp[i] = detail::Common_Prefix(strings[i - 1], strings[i], 0);
+        }
+    });
+
+    std::vector<std::size_t> runs(threads + 1);
+    for(unsigned chunk = 0; chunk <= threads; ++chunk)
+    {
+        runs[chunk] = size * chunk / threads;
+    }
+
+    std::vector<std::string_view> scratch(size);
+    std::vector<std::size_t> scratchLcp(size);
+    std::string_view* source = strings.data();
+    std::string_view* target = scratch.data();
+    std::size_t* sourceLcp = lcp.data();
+    std::size_t* targetLcp = scratchLcp.data();
+    while(runs.size() > 2)
+    {
+        const std::size_t pairs = runs.size() / 2;
+        Parallel_For_Chunks(pairs, threads, [&](unsigned, std::size_t firstPair, std::size_t lastPair)
+        {
+            for(std::size_t pair = firstPair; pair < lastPair; ++pair)
+            {
+                const std::size_t begin = runs[2 * pair];
+                const std::size_t mid = runs[2 * pair + 1];
+                const std::size_t end = 2 * pair + 2 < runs.size() ? runs[2 * pair + 2] : mid;
+                detail::LCP_Merge({source + begin, mid - begin}, {sourceLcp + begin, mid - begin},
+                                  {source + mid, end - mid}, {sourceLcp + mid, end - mid},
+                                  target + begin, targetLcp + begin);
+            }
+        });
+        std::vector<std::size_t> mergedRuns;
+        for(std::size_t run = 0; run + 1 < runs.size(); run += 2)
+        {
+            mergedRuns.push_back(runs[run]);
+        }
+        mergedRuns.push_back(size);
+        runs = std::move(mergedRuns);
+        std::swap(source, target);
+        std::swap(sourceLcp, targetLcp);
+    }
+    if(source != strings.data())
+    {
+        std::copy(source, source + size, strings.data());
+    }
+}
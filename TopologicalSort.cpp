@@ -1,15 +1,24 @@
 #include <iostream> 
-#include <list> 
-#include <stack> 
+#include <utility> 
+#include <vector> 
 using namespace std; 
 
 class Graph { 
 	int V; 
 
-	list<int>* adj; 
+	// Compressed sparse row adjacency: the neighbours of v are 
+	// targets[offsets[v]] ... targets[offsets[v + 1] - 1]. 
+	// addEdge only records the edge, the arrays are built once before a traversal. 
+	vector<pair<int, int> > edges; 
+	vector<int> offsets; 
+	vector<int> targets; 
 
+	// Scratch buffers kept between calls: 0 = new, 1 = on the DFS path, 2 = done, 
+	// and the DFS path itself as (vertex, next edge to look at) 
+	vector<char> state; 
+	vector<pair<int, int> > path; 
 
-	void topologicalSortUtil(int v, bool visited[], stack<int>& Stack); 
+	void buildAdjacency(); 
 
 public: 
 	Graph(int V);
@@ -18,54 +27,104 @@ public:
 	void addEdge(int v, int w); 
 
 
+	// Fills order with a topological order and returns true, or returns false 
+	// and fills cycle with the vertices of a cycle (each has an edge to the next, 
+	// the last one to the first). Iterative, so long chains do not overflow the stack. 
+	bool topologicalOrder(vector<int>& order, vector<int>& cycle); 
+
 	void topologicalSort(); 
 }; 
 
 Graph::Graph(int V) 
 { 
 	this->V = V; 
-	adj = new list<int>[V]; 
 } 
 
 void Graph::addEdge(int v, int w) 
 { 
-	adj[v].push_back(w); 
+	edges.push_back(make_pair(v, w)); 
+	targets.clear(); 
 } 
 
-void Graph::topologicalSortUtil(int v, bool visited[], 
-								stack<int>& Stack) 
+// Count the out-degrees, prefix sum them into offsets, then place every 
+// edge in the next free slot of its source (keeps the order of addEdge). 
+void Graph::buildAdjacency() 
 { 
+	if (!targets.empty() || edges.empty()) 
+		return; 
+
+	offsets.assign(V + 1, 0); 
+	for (size_t i = 0; i < edges.size(); i++) 
+		offsets[edges[i].first + 1]++; 
+	for (int v = 0; v < V; v++) 
+		offsets[v + 1] += offsets[v]; 
+
+	vector<int> next(offsets.begin(), offsets.end() - 1); 
+	targets.resize(edges.size()); 
+	for (size_t i = 0; i < edges.size(); i++) 
+		targets[next[edges[i].first]++] = edges[i].second; 
+} 
 
-	visited[v] = true; 
-
- 
-	list<int>::iterator i; 
-	for (i = adj[v].begin(); i != adj[v].end(); ++i) 
-		if (!visited[*i]) 
-			topologicalSortUtil(*i, visited, Stack); 
-
-
-	Stack.push(v); 
+bool Graph::topologicalOrder(vector<int>& order, vector<int>& cycle) 
+{ 
+	buildAdjacency(); 
+	if (offsets.empty()) 
+		offsets.assign(V + 1, 0); 
+
+	state.assign(V, 0); 
+	path.clear(); 
+	cycle.clear(); 
+	order.assign(V, 0); 
+	int position = V; 
+
+	for (int i = 0; i < V; i++) { 
+		if (state[i] != 0) 
+			continue; 
+		state[i] = 1; 
+		path.push_back(make_pair(i, offsets[i])); 
+		while (!path.empty()) { 
+			int v = path.back().first; 
+			int& next = path.back().second; 
+			if (next == offsets[v + 1]) { 
+				// all successors placed: v goes in front of them 
+				state[v] = 2; 
+				order[--position] = v; 
+				path.pop_back(); 
+				continue; 
+			} 
+			int w = targets[next++]; 
+			if (state[w] == 0) { 
+				state[w] = 1; 
+				path.push_back(make_pair(w, offsets[w])); 
+			} 
+			else if (state[w] == 1) { 
+				// back edge v -> w: the path from w up to v is a cycle 
+				size_t start = path.size() - 1; 
+				while (path[start].first != w) 
+					start--; 
+				for (size_t j = start; j < path.size(); j++) 
+					cycle.push_back(path[j].first); 
+				order.clear(); 
+				return false; 
+			} 
+		} 
+	} 
+	return true; 
 } 
  
 void Graph::topologicalSort() 
 { 
-	stack<int> Stack; 
-
-	
-	bool* visited = new bool[V]; 
-	for (int i = 0; i < V; i++) 
-		visited[i] = false; 
-
-	
-	for (int i = 0; i < V; i++) 
-		if (visited[i] == false) 
-			topologicalSortUtil(i, visited, Stack); 
-
-	while (Stack.empty() == false) { 
-		cout << Stack.top() << " "; 
-		Stack.pop(); 
+	vector<int> order; 
+	vector<int> cycle; 
+
+	if (!topologicalOrder(order, cycle)) { 
+		cout << "no order, the graph has a cycle:"; 
+		for (size_t i = 0; i < cycle.size(); i++) 
+			cout << " " << cycle[i]; 
+		return; 
 	} 
+	for (size_t i = 0; i < order.size(); i++) 
+		cout << order[i] << " "; 
 } 
 int main() 
 { 
@@ -1,32 +1,31 @@
 #include <bits/stdc++.h> 
 using namespace std; 
   
-// A recursive binary search function. It returns 
-// location of x in given array arr[l..r] is present, 
-// otherwise -1 
+// A branchless binary search function. It returns the 
+// location of x in given array arr[l..r] if present, 
+// otherwise -1 (generic version: C++/algorithms/searching/binary_search.h) 
 int binarySearch(int arr[], int l, int r, int x) 
 { 
-    if (r >= l) { 
-        int mid = l + (r - l) / 2; 
+    if (r < l) 
+        return -1; 
   
-        // If the element is present at the middle 
-        // itself 
-        if (arr[mid] == x) 
-            return mid; 
+    int base = l; 
+    int length = r - l + 1; 
+    while (length > 1) { 
+        int half = length / 2; 
+        if (length > 2) { 
+            __builtin_prefetch(&arr[base + (length - half) / 2 - 1]); 
+            __builtin_prefetch(&arr[base + half + (length - half) / 2 - 1]); 
+        } 
   
-        // If element is smaller than mid, then 
-        // it can only be present in left subarray 
-        if (arr[mid] > x) 
-            return binarySearch(arr, l, mid - 1, x); 
-  
-        // Else the element can only be present 
-        // in right subarray 
-        return binarySearch(arr, mid + 1, r, x); 
+        // Compiles to cmov: no misprediction on random keys 
+        base = (arr[base + half - 1] < x) ? base + half : base; 
+        length -= half; 
     } 
+    base += (arr[base] < x); 
   
-    // We reach here when element is not 
-    // present in array 
-    return -1; 
+    // base is now the first index with arr[base] >= x 
+    return (base <= r && arr[base] == x) ? base : -1; 
 } 
   
 int main(void) 